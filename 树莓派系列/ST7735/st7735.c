@@ -2,14 +2,18 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#ifndef ST7735_NO_BCM2835
 #include <bcm2835.h>
+#endif
 #include "st7735.h"
 
+#ifndef ST7735_NO_BCM2835
 // 引脚定义 (BCM编号)
 #define DC_PIN      RPI_V2_GPIO_P1_22  // GPIO25
 #define RST_PIN     RPI_V2_GPIO_P1_13  // GPIO27
 #define BL_PIN      RPI_V2_GPIO_P1_18  // GPIO24
 #define CS_PIN      RPI_V2_GPIO_P1_24  // GPIO8 (CE0)
+#endif
 
 // ST7735命令定义
 #define ST7735_NOP     0x00
@@ -37,6 +41,9 @@ static uint16_t _height = ST7735_HEIGHT;
 static uint8_t _colstart = 0;
 static uint8_t _rowstart = 0;
 
+// 传输接口：write为NULL时使用bcm2835
+static ST7735_Transport _transport;
+
 // 简单字体数据 (5x7字体)
 static const uint8_t font5x7[95][5] = {
     {0x00,0x00,0x00,0x00,0x00}, // 空格
@@ -136,23 +143,56 @@ static const uint8_t font5x7[95][5] = {
     {0x08,0x04,0x08,0x10,0x08}, // ~
 };
 
+// 设置传输接口，NULL恢复bcm2835
+void ST7735_SetTransport(const ST7735_Transport *t) {
+    if (t) {
+        _transport = *t;
+    } else {
+        memset(&_transport, 0, sizeof(_transport));
+    }
+}
+
+// 发送一段字节，dc为0表示命令
+static void tx(int dc, const uint8_t *data, uint32_t len) {
+    if (_transport.write) {
+        _transport.write(_transport.ctx, dc, data, len);
+        return;
+    }
+#ifndef ST7735_NO_BCM2835
+    bcm2835_gpio_write(DC_PIN, dc ? HIGH : LOW);  // DC低电平表示命令，高电平表示数据
+    for (uint32_t i = 0; i < len; i++) {
+        bcm2835_spi_transfer(data[i]);
+    }
+#endif
+}
+
+// 延时（毫秒）
+static void delay_ms(unsigned ms) {
+    if (_transport.delay) {
+        _transport.delay(_transport.ctx, ms);
+        return;
+    }
+#ifndef ST7735_NO_BCM2835
+    bcm2835_delay(ms);
+#else
+    usleep(ms * 1000);
+#endif
+}
+
 // 写命令
 void ST7735_WriteCommand(uint8_t cmd) {
-    bcm2835_gpio_write(DC_PIN, LOW);  // DC低电平表示命令
-    bcm2835_spi_transfer(cmd);
+    tx(0, &cmd, 1);
 }
 
 // 写数据
 void ST7735_WriteData(uint8_t data) {
-    bcm2835_gpio_write(DC_PIN, HIGH); // DC高电平表示数据
-    bcm2835_spi_transfer(data);
+    tx(1, &data, 1);
 }
 
 // 写16位数据
 void ST7735_WriteData16(uint16_t data) {
-    bcm2835_gpio_write(DC_PIN, HIGH);
-    bcm2835_spi_transfer(data >> 8);
-    bcm2835_spi_transfer(data & 0xFF);
+    uint8_t buf[2] = { data >> 8, data & 0xFF };
+    tx(1, buf, 2);
 }
 
 // 设置地址窗口
@@ -175,8 +215,9 @@ void ST7735_SetAddressWindow(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1) {
     ST7735_WriteCommand(ST7735_RAMWR);
 }
 
-// 初始化ST7735
-void ST7735_Init(void) {
+#ifndef ST7735_NO_BCM2835
+// 初始化GPIO、SPI并硬件复位
+static void bcm_begin(void) {
     // 初始化GPIO
     bcm2835_gpio_fsel(DC_PIN, BCM2835_GPIO_FSEL_OUTP);
     bcm2835_gpio_fsel(RST_PIN, BCM2835_GPIO_FSEL_OUTP);
@@ -197,17 +238,26 @@ void ST7735_Init(void) {
     bcm2835_delay(100);
     bcm2835_gpio_write(RST_PIN, HIGH);
     bcm2835_delay(100);
+}
+#endif
+
+// 初始化ST7735
+void ST7735_Init(void) {
+#ifndef ST7735_NO_BCM2835
+    // 使用传输接口时没有GPIO和SPI，靠软件复位
+    if (!_transport.write) bcm_begin();
+#endif
     
     // 背光开启
     ST7735_Backlight(1);
     
     // 软件复位
     ST7735_WriteCommand(ST7735_SWRESET);
-    bcm2835_delay(150);
+    delay_ms(150);
     
     // 退出睡眠模式
     ST7735_WriteCommand(ST7735_SLPOUT);
-    bcm2835_delay(150);
+    delay_ms(150);
     
     // 帧率控制
     ST7735_WriteCommand(0xB1);
@@ -303,11 +353,11 @@ void ST7735_Init(void) {
     
     // 正常显示开启
     ST7735_WriteCommand(ST7735_NORON);
-    bcm2835_delay(10);
+    delay_ms(10);
     
     // 显示开启
     ST7735_WriteCommand(ST7735_DISPON);
-    bcm2835_delay(100);
+    delay_ms(100);
     
     _colstart = 2;
     _rowstart = 3;
@@ -446,12 +496,20 @@ void ST7735_DrawString(uint8_t x, uint8_t y, const char* str, uint16_t color, ui
 
 // 控制背光
 void ST7735_Backlight(uint8_t state) {
-    bcm2835_gpio_write(BL_PIN, state ? HIGH : LOW);
+#ifndef ST7735_NO_BCM2835
+    if (!_transport.write) bcm2835_gpio_write(BL_PIN, state ? HIGH : LOW);
+#else
+    (void)state;
+#endif
 }
 
 // 清理资源
 void ST7735_Cleanup(void) {
     ST7735_Backlight(0);
-    bcm2835_spi_end();
-    bcm2835_close();
+#ifndef ST7735_NO_BCM2835
+    if (!_transport.write) {
+        bcm2835_spi_end();
+        bcm2835_close();
+    }
+#endif
 }
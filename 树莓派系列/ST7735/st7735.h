@@ -17,7 +17,17 @@
 #define YELLOW    0xFFE0
 #define WHITE     0xFFFF
 
+// 传输接口：代替bcm2835的SPI和GPIO，用于虚拟面板等不需要硬件的测试。
+// write发送一段DC相同的字节（dc为0是命令）；delay为NULL时用bcm2835_delay，
+// 定义了ST7735_NO_BCM2835时用usleep
+typedef struct {
+    void (*write)(void *ctx, int dc, const uint8_t *data, uint32_t len);
+    void (*delay)(void *ctx, unsigned ms);
+    void *ctx;
+} ST7735_Transport;
+
 // 函数声明
+void ST7735_SetTransport(const ST7735_Transport *t);   // 在ST7735_Init之前调用，NULL恢复bcm2835
 void ST7735_Init(void);
 void ST7735_WriteCommand(uint8_t cmd);
 void ST7735_WriteData(uint8_t data);
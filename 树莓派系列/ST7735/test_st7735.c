@@ -1,15 +1,71 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
-#include <bcm2835.h>
 #include "st7735.h"
 
-int main() {
+#ifdef ST7735_VPANEL
+#include "st7735_vpanel.h"
+
+// 虚拟面板模式（make vpanel）：不需要树莓派，给出-o DIR时每次停顿在DIR中保存一张PPM快照
+static st7735_vpanel_t *vp;
+static const char *out_dir;
+
+static void vp_write(void *ctx, int dc, const uint8_t *data, uint32_t len) {
+    st7735_vpanel_write((st7735_vpanel_t *)ctx, dc, data, len);
+}
+
+static void vp_delay(void *ctx, unsigned ms) {
+    st7735_vpanel_delay((st7735_vpanel_t *)ctx, ms);
+}
+
+static void hold(unsigned seconds, const char *name) {
+    char path[512];
+    (void)seconds;
+    st7735_vpanel_frame(vp);
+    if (!out_dir) return;
+    snprintf(path, sizeof(path), "%s/%s.ppm", out_dir, name);
+    if (st7735_vpanel_save_ppm(vp, path) == 0) printf("  快照: %s\n", path);
+}
+#else
+#include <bcm2835.h>
+
+static void hold(unsigned seconds, const char *name) {
+    (void)name;
+    sleep(seconds);
+}
+#endif
+
+int main(int argc, char *argv[]) {
+#ifdef ST7735_VPANEL
+    int opt;
+    while ((opt = getopt(argc, argv, "o:")) != -1) {
+        if (opt != 'o') {
+            fprintf(stderr, "Usage: %s [-o DIR]\n", argv[0]);
+            return 2;
+        }
+        out_dir = optarg;
+    }
+    
+    // 1.44寸128x128面板：显存132x162，可见区域在列2、行3开始
+    st7735_vpanel_config_t config = {
+        .gram_width = 132, .gram_height = 162,
+        .width = ST7735_WIDTH, .height = ST7735_HEIGHT,
+        .col_offset = 2, .row_offset = 3,
+        .panel_madctl = 0xC0,
+    };
+    vp = st7735_vpanel_create(&config);
+    if (!vp) return 1;
+    ST7735_Transport transport = { vp_write, vp_delay, vp };
+    ST7735_SetTransport(&transport);
+#else
+    (void)argc;
+    (void)argv;
     // 初始化BCM2835库
     if(!bcm2835_init()) {
         printf("BCM2835初始化失败!\n");
         return 1;
     }
+#endif
     
     printf("初始化ST7735显示屏...\n");
     ST7735_Init();
@@ -17,11 +73,11 @@ int main() {
     // 测试1: 填充不同颜色
     printf("测试1: 颜色填充...\n");
     ST7735_FillScreen(RED);
-    sleep(1);
+    hold(1, "test1_red");
     ST7735_FillScreen(GREEN);
-    sleep(1);
+    hold(1, "test1_green");
     ST7735_FillScreen(BLUE);
-    sleep(1);
+    hold(1, "test1_blue");
     ST7735_FillScreen(BLACK);
     
     // 测试2: 绘制图形
@@ -40,7 +96,7 @@ int main() {
     // 绘制圆形
     ST7735_DrawCircle(95, 85, 20, MAGENTA);
     
-    sleep(2);
+    hold(2, "test2_shapes");
     
     // 测试3: 显示文字
     printf("测试3: 显示文字...\n");
@@ -51,7 +107,7 @@ int main() {
     ST7735_DrawString(10, 50, "Display Test", CYAN, BLACK);
     ST7735_DrawString(10, 70, "Hello World!", MAGENTA, BLACK);
     
-    sleep(3);
+    hold(3, "test3_text");
     
     // 测试4: 渐变效果
     printf("测试4: 渐变效果...\n");
@@ -62,10 +118,20 @@ int main() {
         }
     }
     
-    sleep(2);
+    hold(2, "test4_gradient");
     
     printf("测试完成!\n");
     ST7735_Cleanup();
     
+#ifdef ST7735_VPANEL
+    // 输出线上流量统计，有协议错误时返回非0
+    st7735_vpanel_stats_t stats;
+    st7735_vpanel_get_stats(vp, &stats);
+    st7735_print_vpanel_stats(&stats, stdout);
+    if (stats.total.errors) printf("协议错误: %s\n", st7735_vpanel_last_error(vp));
+    st7735_vpanel_destroy(vp);
+    return stats.total.errors ? 1 : 0;
+#else
     return 0;
+#endif
 }
@@ -1,5 +1,10 @@
 #include "st7735.h"
+#include "st7735_blit.h"
+#include "st7735_image.h"
+#include "st7735_video.h"
+#include "st7735_sched.h"
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <time.h>
 #include <math.h>
@@ -64,48 +69,57 @@ void test_pattern(st7735_t *lcd) {
     sleep(3);
 }
 
-// 动画演示
-void animation_demo(st7735_t *lcd) {
-    printf("动画演示...\n");
-    
+// 动画的一帧：位置只由帧号决定，调度器跳帧时动画仍按时间推进
+static bool animation_frame(st7735_t *lcd, uint64_t frame, void *user) {
+    (void)user;
     int center_x = lcd->width / 2;
     int center_y = lcd->height / 2;
-    float angle = 0;
+    float angle = frame * 0.1;
     
-    for (int frame = 0; frame < 50; frame++) {
-        st7735_clear(lcd, ST7735_BLACK);
-        
-        // 旋转的方块
-        for (int i = 0; i < 4; i++) {
-            float a = angle + i * M_PI_2;
-            int x = center_x + (int)(40 * cos(a));
-            int y = center_y + (int)(40 * sin(a));
-            
-            // 使用HSV颜色生成彩虹效果
-            uint16_t color = st7735_color_rgb(
-                (int)(127.5 * (1 + cos(a))),
-                (int)(127.5 * (1 + sin(a))),
-                (int)(127.5 * (1 + cos(a + M_PI_2)))
-            );
-            
-            st7735_fill_rect(lcd, x - 8, y - 8, 16, 16, color);
-        }
-        
-        // 进度条
-        int progress = (frame * lcd->width) / 50;
-        st7735_fill_rect(lcd, 0, lcd->height - 10, progress, 8, 
-                       st7735_color_rgb(progress * 255 / lcd->width, 100, 255));
-        
-        // 显示帧数
-        char buffer[20];
-        snprintf(buffer, sizeof(buffer), "Frame: %d", frame);
-        st7735_draw_string(lcd, buffer, 5, 5, ST7735_WHITE, ST7735_BLACK, 1);
+    st7735_clear(lcd, ST7735_BLACK);
+    
+    // 旋转的方块
+    for (int i = 0; i < 4; i++) {
+        float a = angle + i * M_PI_2;
+        int x = center_x + (int)(40 * cos(a));
+        int y = center_y + (int)(40 * sin(a));
         
-        st7735_update(lcd);
+        // 使用HSV颜色生成彩虹效果
+        uint16_t color = st7735_color_rgb(
+            (int)(127.5 * (1 + cos(a))),
+            (int)(127.5 * (1 + sin(a))),
+            (int)(127.5 * (1 + cos(a + M_PI_2)))
+        );
         
-        angle += 0.1;
-        usleep(50000);
+        st7735_fill_rect(lcd, x - 8, y - 8, 16, 16, color);
     }
+    
+    // 进度条
+    int progress = (frame * lcd->width) / 50;
+    st7735_fill_rect(lcd, 0, lcd->height - 10, progress, 8, 
+                   st7735_color_rgb(progress * 255 / lcd->width, 100, 255));
+    
+    // 显示帧数
+    char buffer[20];
+    snprintf(buffer, sizeof(buffer), "Frame: %d", (int)frame);
+    st7735_draw_string(lcd, buffer, 5, 5, ST7735_WHITE, ST7735_BLACK, 1);
+    return true;
+}
+
+// 动画演示：20fps播放50帧，按绝对期限定时，落后时跳帧；异步提交：发送这一帧的同时开始绘制下一帧
+void animation_demo(st7735_t *lcd) {
+    printf("动画演示...\n");
+    
+    st7735_sched_opts_t opts = { .fps = 20, .skip_late = true };
+    st7735_sched_t *sched = st7735_sched_create(&opts);
+    if (!sched) return;
+    
+    st7735_sched_run(sched, lcd, 50, animation_frame, NULL, NULL);
+    
+    st7735_sched_stats_t stats;
+    st7735_sched_get_stats(sched, &stats);
+    st7735_print_sched_stats(&stats, stdout);
+    st7735_sched_destroy(sched);
 }
 
 // 渐变效果
@@ -139,9 +153,101 @@ void gradient_demo(st7735_t *lcd) {
     
     st7735_update(lcd);
     sleep(2);
+    
+    // 12位传输：数据量少25%，抖动减轻色带
+    printf("RGB444抖动传输...\n");
+    st7735_set_pixel_format(lcd, ST7735_FORMAT_RGB444_DITHER);
+    st7735_update_full(lcd);
+    sleep(2);
+    st7735_set_pixel_format(lcd, ST7735_FORMAT_RGB565);
+}
+
+// 滚动终端演示（竖屏使用硬件滚动）
+void console_demo(st7735_t *lcd) {
+    printf("滚动终端...\n");
+    
+    st7735_set_rotation(lcd, ST7735_ROTATION_0);
+    st7735_console_begin(lcd, ST7735_GREEN, ST7735_BLACK, 1);
+    
+    for (int i = 0; i < 40; i++) {
+        st7735_console_printf(lcd, "[%5.2f] log line %d\n", i * 0.05, i);
+        st7735_update(lcd);
+        usleep(50000);
+    }
+    sleep(1);
+    
+    st7735_console_end(lcd);
+    st7735_set_rotation(lcd, ST7735_ROTATION_90);
 }
 
-int main() {
+// 图片演示：按比例缩放居中，误差扩散抖动
+void image_demo(st7735_t *lcd, const char *path) {
+    uint32_t w, h;
+    printf("显示图片 %s...\n", path);
+    
+    if (st7735_image_info(path, &w, &h) < 0) return;
+    // 与st7735_draw_image的默认适配相同：保持比例缩放到屏幕内
+    uint32_t dw = lcd->width;
+    uint32_t dh = h * dw / w;
+    if (dh > lcd->height) {
+        dh = lcd->height;
+        dw = w * dh / h;
+    }
+    
+    st7735_image_opts_t opts = { 0, 0, ST7735_DITHER_DIFFUSION };
+    st7735_clear(lcd, ST7735_BLACK);
+    if (st7735_draw_image(lcd, path, (lcd->width - dw) / 2, (lcd->height - dh) / 2, &opts) == 0) {
+        // 底部半透明标题栏，图片仍然透出来
+        const char *name = strrchr(path, '/');
+        st7735_fill_rect_alpha(lcd, 0, lcd->height - 12, lcd->width, 12, ST7735_BLACK, 160);
+        st7735_draw_string(lcd, name ? name + 1 : path, 2, lcd->height - 10,
+                           ST7735_WHITE, ST7735_WHITE, 1);
+        st7735_update(lcd);
+        sleep(3);
+    }
+}
+
+// 视频演示：原始帧（.raw）或差分帧（.s7v）文件，按文件帧率播放一遍
+void video_demo(st7735_t *lcd, const char *path) {
+    st7735_video_stats_t stats;
+    printf("播放视频 %s...\n", path);
+    
+    if (st7735_play_video(lcd, path, NULL, &stats) == 0) {
+        st7735_print_video_stats(&stats, stdout);
+        sleep(1);
+    }
+}
+
+// 字体演示：用.s7f字体显示中文，演示结束后恢复内置字体
+void font_demo(st7735_t *lcd, const char *path) {
+    printf("字体 %s...\n", path);
+    
+    st7735_font_t *font = st7735_font_open(path);
+    if (!font) return;
+    
+    st7735_set_font(lcd, font);
+    int line = st7735_font_height(font) + 2;
+    st7735_clear(lcd, ST7735_BLACK);
+    st7735_draw_string(lcd, "温度 42°C", 4, 4, ST7735_WHITE, ST7735_BLACK, 1);
+    st7735_draw_string(lcd, "湿度 61%", 4, 4 + line, ST7735_CYAN, ST7735_BLACK, 1);
+    st7735_draw_string(lcd, "树莓派 ST7735", 4, 4 + 2 * line, ST7735_YELLOW, ST7735_BLACK, 1);
+    st7735_update(lcd);
+    sleep(3);
+    
+    st7735_set_font(lcd, NULL);
+    st7735_font_close(font);
+}
+
+static bool has_ext(const char *path, const char *ext) {
+    const char *dot = strrchr(path, '.');
+    return dot && strcmp(dot, ext) == 0;
+}
+
+static bool is_video(const char *path) {
+    return has_ext(path, ".raw") || has_ext(path, ".s7v");
+}
+
+int main(int argc, char *argv[]) {
     printf("ST7735 LCD 驱动测试\n");
     printf("引脚配置:\n");
     printf("  SCLK -> GPIO11 (引脚23)\n");
@@ -151,8 +257,9 @@ int main() {
     printf("  RST  -> GPIO27 (引脚13)\n");
     printf("  BL   -> GPIO24 (引脚18)\n");
     
-    // 初始化LCD
+    // 初始化LCD（程序重启时面板已点亮则走热启动）
     st7735_t lcd;
+    st7735_set_warm_start(true);
     int ret = st7735_init(&lcd, ST7735_ROTATION_90);
     
     if (ret < 0) {
@@ -162,11 +269,31 @@ int main() {
     
     printf("\n初始化成功\n");
     printf("分辨率: %dx%d\n", lcd.width, lcd.height);
+    st7735_print_init_timing(&lcd, stdout);
+    
+    // 每5秒输出一次刷新统计
+    st7735_set_stats_dump(&lcd, stdout, 5000);
+    
+    // 双缓冲异步刷新
+    if (st7735_enable_async(&lcd) < 0) {
+        fprintf(stderr, "异步刷新不可用，使用同步刷新\n");
+    }
     
     // 运行测试
     test_pattern(&lcd);
     animation_demo(&lcd);
     gradient_demo(&lcd);
+    console_demo(&lcd);
+    // 可选：命令行给出的图片（PPM，编译时有libpng/libjpeg则也支持PNG/JPEG）、视频和字体
+    for (int i = 1; i < argc; i++) {
+        if (has_ext(argv[i], ".s7f")) {
+            font_demo(&lcd, argv[i]);
+        } else if (is_video(argv[i])) {
+            video_demo(&lcd, argv[i]);
+        } else {
+            image_demo(&lcd, argv[i]);
+        }
+    }
     
     // 最终显示
     printf("\n最终显示...\n");
@@ -179,6 +306,7 @@ int main() {
     st7735_draw_string(&lcd, "to exit", 50, 85, ST7735_YELLOW, ST7735_BLACK, 1);
     
     st7735_update(&lcd);
+    st7735_set_stats_dump(&lcd, NULL, 0);
     
     printf("测试完成，按Ctrl+C退出...\n");
     
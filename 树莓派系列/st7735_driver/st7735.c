@@ -1,4 +1,7 @@
 #include "st7735.h"
+#include "st7735_gpio.h"
+#include "st7735_cmdlist.h"
+#include "st7735_pixel.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -7,8 +10,11 @@
 #include <sys/ioctl.h>
 #include <linux/spi/spidev.h>
 #include <math.h>
+#include <pthread.h>
+#include <time.h>
+#include <stdarg.h>
 
-// GPIO引脚定义 (BCM编号)
+// 默认GPIO引脚 (BCM编号)
 #define ST7735_RST_PIN   27
 #define ST7735_DC_PIN    25
 #define ST7735_CS_PIN    8
@@ -33,6 +39,8 @@
 #define ST7735_RAMRD     0x2E
 #define ST7735_COLMOD    0x3A
 #define ST7735_MADCTL    0x36
+#define ST7735_VSCRDEF   0x33
+#define ST7735_VSCSAD    0x37
 
 // MADCTL参数
 #define MADCTL_MY        0x80
@@ -43,497 +51,1938 @@
 #define MADCTL_BGR       0x08
 #define MADCTL_MH        0x04
 
-// SPI设备
-#define SPI_DEVICE "/dev/spidev0.0"
-static int spi_fd = -1;
+// COLMOD参数
+#define COLMOD_RGB444    0x03
+#define COLMOD_RGB565    0x05
 
-// GPIO控制函数
-static void gpio_export(int pin) {
-    char buffer[64];
-    int fd = open("/sys/class/gpio/export", O_WRONLY);
-    if (fd >= 0) {
-        snprintf(buffer, sizeof(buffer), "%d", pin);
-        write(fd, buffer, strlen(buffer));
-        close(fd);
-        usleep(100000);
+// 默认SPI设备和时钟
+#define SPI_DEVICE     "/dev/spidev0.0"
+#define SPI_SPEED_HZ   16000000
+
+// spidev单次ioctl允许的最大字节数（内核模块参数bufsiz）
+#define SPIDEV_BUFSIZ_PATH    "/sys/module/spidev/parameters/bufsiz"
+#define SPIDEV_BUFSIZ_DEFAULT 4096
+
+static uint32_t read_spidev_bufsiz(void) {
+    unsigned long value = 0;
+    FILE *fp = fopen(SPIDEV_BUFSIZ_PATH, "r");
+    if (fp) {
+        if (fscanf(fp, "%lu", &value) != 1) value = 0;
+        fclose(fp);
     }
+    return value >= 64 ? (uint32_t)value : SPIDEV_BUFSIZ_DEFAULT;
 }
 
-static void gpio_unexport(int pin) {
-    char buffer[64];
-    int fd = open("/sys/class/gpio/unexport", O_WRONLY);
-    if (fd >= 0) {
-        snprintf(buffer, sizeof(buffer), "%d", pin);
-        write(fd, buffer, strlen(buffer));
-        close(fd);
+// st7735_init()使用的默认值（st7735_init_config()不受影响）
+static st7735_gpio_backend_t gpio_backend = ST7735_GPIO_AUTO;
+static bool warm_start = false;
+
+// ===== SPI总线 =====
+
+// 同一SPI控制器上的面板共用一个总线锁。硬件片选的面板每条SPI_IOC_MESSAGE
+// 自带片选，内核按消息串行化，可以交错发送，取读锁；GPIO片选的面板在多次
+// ioctl之间保持CS有效，期间不能有别的面板发送，取写锁
+typedef struct {
+    int bus;                    // /dev/spidevB.C中的B，-1表示无法解析（不共享）
+    int refs;
+    pthread_rwlock_t lock;
+} st7735_bus_t;
+
+#define ST7735_MAX_BUSES 8
+static st7735_bus_t buses[ST7735_MAX_BUSES];
+static pthread_mutex_t buses_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static st7735_bus_t *bus_get(const char *device) {
+    int bus = -1, cs;
+    const char *name = strrchr(device, '/');
+    if (sscanf(name ? name + 1 : device, "spidev%d.%d", &bus, &cs) != 2) bus = -1;
+    
+    st7735_bus_t *found = NULL;
+    pthread_mutex_lock(&buses_lock);
+    for (int i = 0; i < ST7735_MAX_BUSES && !found; i++) {
+        if (buses[i].refs > 0 && bus >= 0 && buses[i].bus == bus) found = &buses[i];
     }
+    for (int i = 0; i < ST7735_MAX_BUSES && !found; i++) {
+        if (buses[i].refs == 0) {
+            found = &buses[i];
+            found->bus = bus;
+            pthread_rwlock_init(&found->lock, NULL);
+        }
+    }
+    if (found) found->refs++;
+    pthread_mutex_unlock(&buses_lock);
+    return found;
 }
 
-static void gpio_set_direction(int pin, const char *direction) {
-    char path[64];
-    snprintf(path, sizeof(path), "/sys/class/gpio/gpio%d/direction", pin);
-    int fd = open(path, O_WRONLY);
-    if (fd >= 0) {
-        write(fd, direction, strlen(direction));
-        close(fd);
-    }
+static void bus_put(st7735_bus_t *bus) {
+    if (!bus) return;
+    pthread_mutex_lock(&buses_lock);
+    if (--bus->refs == 0) pthread_rwlock_destroy(&bus->lock);
+    pthread_mutex_unlock(&buses_lock);
+}
+
+// ===== 面板连接 =====
+
+// 每块面板独占的硬件资源
+struct st7735_io {
+    int spi_fd;
+    uint32_t spi_bufsiz;
+    st7735_transport_t transport;       // transfer非NULL时代替spidev
+    st7735_bus_t *bus;
+    st7735_gpio_t gpio;                 // 控制线（初始化时申请一次）
+    pthread_mutex_t lock;               // 异步刷新线程与应用线程共用SPI、GPIO和命令列表
+    st7735_cmdlist_t cmdlist;           // 所有命令都先打包再一次性提交
+    st7735_cmdlist_stats_t list_stats[ST7735_LIST_COUNT];
+    st7735_init_timing_t init_timing;
+    uint8_t col_offset, row_offset;     // 竖屏方向的显存偏移
+    uint16_t gram_height;               // 显存行数，VSCRDEF的三段之和必须等于它
+    uint16_t x_offset, y_offset;        // 当前方向下窗口地址的偏移
+    char state_file[64];                // 空串表示不记录（自定义传输）
+    // 运行统计：发送侧在lock内更新，render/wait/coalesced由绘制线程更新
+    st7735_stats_t stats;
+    uint64_t stats_since;
+    uint64_t render_start;              // 本帧第一次绘制的时间，0表示尚未开始
+    unsigned long gpio_writes_base;
+    uint64_t gpio_ns_base;
+    FILE *stats_fp;                     // 定期输出统计，NULL关闭
+    uint64_t stats_interval_ns;
+};
+
+// ===== 运行统计 =====
+
+static uint64_t stats_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+#if ST7735_STATS
+static inline uint64_t stats_lap(uint64_t *acc, uint64_t start) {
+    uint64_t now = stats_now();
+    *acc += now - start;
+    return now;
+}
+
+#define STATS_NOW()             stats_now()
+#define STATS_ADD(io, f, v)     ((io)->stats.f += (v))
+// 把自start以来的时间计入字段f，返回当前时间作为下一段的起点
+#define STATS_LAP(io, f, start) stats_lap(&(io)->stats.f, (start))
+#else
+// 函数而不是逗号表达式：单独作为语句使用时没有unused-value警告
+static inline uint64_t stats_lap_off(uint64_t start) {
+    (void)start;
+    return 0;
+}
+
+#define STATS_NOW()             0
+#define STATS_ADD(io, f, v)     ((void)(v))
+#define STATS_LAP(io, f, start) stats_lap_off(start)
+#endif
+
+static inline void gpio_set_value(struct st7735_io *io, int line, int value) {
+    st7735_gpio_set(&io->gpio, line, value);
 }
 
-static void gpio_set_value(int pin, int value) {
-    char path[64];
-    snprintf(path, sizeof(path), "/sys/class/gpio/gpio%d/value", pin);
-    int fd = open(path, O_WRONLY);
-    if (fd >= 0) {
-        write(fd, value ? "1" : "0", 1);
-        close(fd);
+// 取得面板和总线，CS有效；与io_release成对使用
+static void io_acquire(struct st7735_io *io) {
+    pthread_mutex_lock(&io->lock);
+    if (io->gpio.pins[ST7735_LINE_CS] >= 0) {
+        pthread_rwlock_wrlock(&io->bus->lock);
+    } else {
+        pthread_rwlock_rdlock(&io->bus->lock);
     }
+    gpio_set_value(io, ST7735_LINE_CS, 0);
 }
 
-// SPI传输函数
-static void spi_transfer(const uint8_t *tx, uint8_t *rx, int length) {
-    struct spi_ioc_transfer tr = {
-        .tx_buf = (unsigned long)tx,
-        .rx_buf = (unsigned long)rx,
-        .len = length,
-        .delay_usecs = 0,
-        .speed_hz = 16000000,
-        .bits_per_word = 8,
-    };
+static void io_release(struct st7735_io *io) {
+    gpio_set_value(io, ST7735_LINE_CS, 1);
+    pthread_rwlock_unlock(&io->bus->lock);
+    pthread_mutex_unlock(&io->lock);
+}
+
+// 提交一组DC相同的传输
+static int spi_sink(void *ctx, int dc, struct spi_ioc_transfer *xfer, unsigned n) {
+    struct st7735_io *io = (struct st7735_io *)ctx;
+    gpio_set_value(io, ST7735_LINE_DC, dc);
+    STATS_ADD(io, ioctls, 1);
+    for (unsigned i = 0; i < n; i++) STATS_ADD(io, bytes, xfer[i].len);
+    if (io->transport.transfer) return io->transport.transfer(io->transport.ctx, dc, xfer, n);
+    return ioctl(io->spi_fd, SPI_IOC_MESSAGE(n), xfer);
+}
+
+// 执行命令列表，调用者负责CS
+static int st7735_exec(struct st7735_io *io, st7735_list_kind_t kind) {
+    int ret = st7735_cmdlist_exec(&io->cmdlist, spi_sink, io);
+    io->list_stats[kind] = io->cmdlist.stats;
+    return ret;
+}
+
+// 执行命令列表：整个列表期间CS保持有效
+static int st7735_run(struct st7735_io *io, st7735_list_kind_t kind) {
+    io_acquire(io);
+    int ret = st7735_exec(io, kind);
+    io_release(io);
+    return ret;
+}
+
+// 追加设置显示窗口并开始写显存
+static void cmdlist_window(struct st7735_io *io, uint16_t x0, uint16_t y0,
+                           uint16_t x1, uint16_t y1) {
+    st7735_cmdlist_t *cl = &io->cmdlist;
+    x0 += io->x_offset;
+    x1 += io->x_offset;
+    y0 += io->y_offset;
+    y1 += io->y_offset;
+    const uint8_t caset[4] = { x0 >> 8, x0 & 0xFF, x1 >> 8, x1 & 0xFF };
+    const uint8_t raset[4] = { y0 >> 8, y0 & 0xFF, y1 >> 8, y1 & 0xFF };
+    
+    st7735_cmdlist_cmd(cl, ST7735_CASET, caset, sizeof(caset));
+    st7735_cmdlist_cmd(cl, ST7735_RASET, raset, sizeof(raset));
+    st7735_cmdlist_cmd(cl, ST7735_RAMWR, NULL, 0);
+}
+
+// 根据旋转方向设置宽高，返回MADCTL参数
+static uint8_t rotation_madctl(st7735_t *dev, st7735_rotation_t rotation) {
+    uint8_t madctl = 0;
+    
+    dev->rotation = rotation;
+    switch (rotation) {
+        case ST7735_ROTATION_0:
+            madctl = MADCTL_MX | MADCTL_MY | MADCTL_BGR;
+            dev->width = 128;
+            dev->height = 160;
+            break;
+        case ST7735_ROTATION_90:
+            madctl = MADCTL_MY | MADCTL_MV | MADCTL_BGR;
+            dev->width = 160;
+            dev->height = 128;
+            break;
+        case ST7735_ROTATION_180:
+            madctl = MADCTL_BGR;
+            dev->width = 128;
+            dev->height = 160;
+            break;
+        case ST7735_ROTATION_270:
+            madctl = MADCTL_MX | MADCTL_MV | MADCTL_BGR;
+            dev->width = 160;
+            dev->height = 128;
+            break;
+    }
+    // 降分辨率渲染时framebuffer按缩小后的尺寸
+    if (dev->scale > 1) {
+        dev->width /= dev->scale;
+        dev->height /= dev->scale;
+    }
     
-    ioctl(spi_fd, SPI_IOC_MESSAGE(1), &tr);
+    // 显存偏移按竖屏给出，横屏时行列互换
+    struct st7735_io *io = dev->io;
+    if (io) {
+        bool portrait = dev->width < dev->height;
+        io->x_offset = portrait ? io->col_offset : io->row_offset;
+        io->y_offset = portrait ? io->row_offset : io->col_offset;
+    }
+    return madctl;
 }
 
-// ST7735命令发送函数
-static void st7735_write_command(uint8_t cmd) {
-    gpio_set_value(ST7735_DC_PIN, 0);
-    gpio_set_value(ST7735_CS_PIN, 0);
-    spi_transfer(&cmd, NULL, 1);
-    gpio_set_value(ST7735_CS_PIN, 1);
+// ===== 初始化表 =====
+
+#define STEP_COLD      0x01     // 仅冷启动执行（面板处于复位/睡眠状态）
+#define STEP_NO_HWRST  0x02     // 仅在没有硬件复位线时执行
+#define STEP_MADCTL    0x04     // 参数由旋转方向决定
+#define STEP_SCROLL    0x08     // 参数由显存行偏移决定
+
+typedef struct {
+    uint8_t cmd;
+    uint8_t phase;              // st7735_init_phase_t
+    uint8_t flags;
+    uint8_t len;
+    uint8_t delay_ms;           // 发送后的最短等待，取自数据手册
+    uint8_t params[16];
+} init_step_t;
+
+static const init_step_t init_table[] = {
+    // 软件复位：之后120ms内不能发SLPOUT
+    { ST7735_SWRESET, ST7735_PHASE_RESET, STEP_COLD | STEP_NO_HWRST, 0, 120, { 0 } },
+    // 退出睡眠：升压电路稳定需要120ms
+    { ST7735_SLPOUT, ST7735_PHASE_SLEEP_OUT, STEP_COLD, 0, 120, { 0 } },
+    
+    // 帧率控制
+    { 0xB1, ST7735_PHASE_CONFIG, 0, 3, 0, { 0x01, 0x2C, 0x2D } },
+    { 0xB2, ST7735_PHASE_CONFIG, 0, 3, 0, { 0x01, 0x2C, 0x2D } },
+    { 0xB3, ST7735_PHASE_CONFIG, 0, 6, 0, { 0x01, 0x2C, 0x2D, 0x01, 0x2C, 0x2D } },
+    // 显示反转
+    { 0xB4, ST7735_PHASE_CONFIG, 0, 1, 0, { 0x07 } },
+    // 电源控制
+    { 0xC0, ST7735_PHASE_CONFIG, 0, 3, 0, { 0xA2, 0x02, 0x84 } },
+    { 0xC1, ST7735_PHASE_CONFIG, 0, 1, 0, { 0xC5 } },
+    { 0xC2, ST7735_PHASE_CONFIG, 0, 2, 0, { 0x0A, 0x00 } },
+    { 0xC3, ST7735_PHASE_CONFIG, 0, 2, 0, { 0x8A, 0x2A } },
+    { 0xC4, ST7735_PHASE_CONFIG, 0, 2, 0, { 0x8A, 0xEE } },
+    { 0xC5, ST7735_PHASE_CONFIG, 0, 1, 0, { 0x0E } },
+    // Gamma校正
+    { 0xE0, ST7735_PHASE_CONFIG, 0, 16, 0, {
+        0x0F, 0x1A, 0x0F, 0x18, 0x2F, 0x28, 0x20, 0x22,
+        0x1F, 0x1B, 0x23, 0x37, 0x00, 0x07, 0x02, 0x10 } },
+    { 0xE1, ST7735_PHASE_CONFIG, 0, 16, 0, {
+        0x0F, 0x1B, 0x0F, 0x17, 0x33, 0x2C, 0x29, 0x2E,
+        0x30, 0x30, 0x39, 0x3F, 0x00, 0x07, 0x03, 0x10 } },
+    // 颜色模式：16位RGB565
+    { ST7735_COLMOD, ST7735_PHASE_CONFIG, 0, 1, 0, { COLMOD_RGB565 } },
+    // 显示方向
+    { ST7735_MADCTL, ST7735_PHASE_CONFIG, STEP_MADCTL, 1, 0, { 0 } },
+    // 整屏作为滚动区并复位滚动起始行（热启动时可能残留上次的滚动位置）
+    { ST7735_VSCRDEF, ST7735_PHASE_CONFIG, STEP_SCROLL, 6, 0, { 0x00, 0x00, 0x00, 0xA0, 0x00, 0x00 } },
+    { ST7735_VSCSAD, ST7735_PHASE_CONFIG, STEP_SCROLL, 2, 0, { 0x00, 0x00 } },
+    
+    // 正常显示模式并开启显示（数据手册未要求等待）
+    { ST7735_NORON, ST7735_PHASE_DISPLAY_ON, 0, 0, 0, { 0 } },
+    { ST7735_DISPON, ST7735_PHASE_DISPLAY_ON, 0, 0, 0, { 0 } },
+};
+
+// ===== 热启动 =====
+
+// 记录面板已唤醒的状态文件（每个spidev一个），/run在重启后清空
+#define STATE_FILE_FMT "/run/st7735-%s.state"
+#define BOOT_ID_PATH   "/proc/sys/kernel/random/boot_id"
+
+static uint32_t phase_end(struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    uint32_t us = (now.tv_sec - start->tv_sec) * 1000000 +
+                  (now.tv_nsec - start->tv_nsec) / 1000;
+    *start = now;
+    return us;
 }
 
-static void st7735_write_data(uint8_t data) {
-    gpio_set_value(ST7735_DC_PIN, 1);
-    gpio_set_value(ST7735_CS_PIN, 0);
-    spi_transfer(&data, NULL, 1);
-    gpio_set_value(ST7735_CS_PIN, 1);
+static int read_boot_id(char *buf, size_t size) {
+    FILE *fp = fopen(BOOT_ID_PATH, "r");
+    if (!fp) return -1;
+    char *ok = fgets(buf, size, fp);
+    fclose(fp);
+    return ok ? 0 : -1;
 }
 
-static void st7735_write_data_bulk(const uint8_t *data, int length) {
-    gpio_set_value(ST7735_DC_PIN, 1);
-    gpio_set_value(ST7735_CS_PIN, 0);
-    spi_transfer(data, NULL, length);
-    gpio_set_value(ST7735_CS_PIN, 1);
+static void write_state_file(struct st7735_io *io) {
+    char boot_id[64];
+    if (!io->state_file[0] || read_boot_id(boot_id, sizeof(boot_id)) < 0) return;
+    
+    FILE *fp = fopen(io->state_file, "w");
+    if (!fp) return;
+    fputs(boot_id, fp);
+    fclose(fp);
 }
 
-// 设置显示窗口
-static void st7735_set_window(st7735_t *dev, uint16_t x0, uint16_t y0, 
-                             uint16_t x1, uint16_t y1) {
-    gpio_set_value(ST7735_CS_PIN, 0);
+// 读取RDDST（09h）：1个dummy位后跟32位状态，MISO未接时读到全0或全1
+static int read_display_status(struct st7735_io *io, uint32_t *status) {
+    uint8_t cmd = ST7735_RDDST;
+    uint8_t tx[5] = { 0 };
+    uint8_t rx[5] = { 0 };
+    struct spi_ioc_transfer xfer[2] = {
+        { .tx_buf = (unsigned long)&cmd, .len = 1, .bits_per_word = 8 },
+        { .tx_buf = (unsigned long)tx, .rx_buf = (unsigned long)rx,
+          .len = sizeof(rx), .bits_per_word = 8 },
+    };
     
-    st7735_write_command(ST7735_CASET);
-    st7735_write_data(x0 >> 8);
-    st7735_write_data(x0 & 0xFF);
-    st7735_write_data(x1 >> 8);
-    st7735_write_data(x1 & 0xFF);
+    io_acquire(io);
+    int ret = spi_sink(io, 0, &xfer[0], 1);
+    if (ret >= 0) ret = spi_sink(io, 1, &xfer[1], 1);
+    io_release(io);
+    if (ret < 0) return -1;
+    
+    bool all_low = true, all_high = true;
+    uint64_t raw = 0;
+    for (int i = 0; i < 5; i++) {
+        if (rx[i] != 0x00) all_low = false;
+        if (rx[i] != 0xFF) all_high = false;
+        raw = (raw << 8) | rx[i];
+    }
+    if (all_low || all_high) return -1;
     
-    st7735_write_command(ST7735_RASET);
-    st7735_write_data(y0 >> 8);
-    st7735_write_data(y0 & 0xFF);
-    st7735_write_data(y1 >> 8);
-    st7735_write_data(y1 & 0xFF);
+    *status = (uint32_t)(raw >> 7);
+    return 0;
+}
+
+// 判断面板是否已退出睡眠且显示开启
+static bool panel_is_awake(struct st7735_io *io) {
+    uint32_t status;
+    if (read_display_status(io, &status) == 0) {
+        // D17: SLPOUT, D10: DISON
+        return (status & (1u << 17)) && (status & (1u << 10));
+    }
     
-    st7735_write_command(ST7735_RAMWR);
+    // 读不到状态时依据本次开机内留下的状态文件
+    char expected[64], boot_id[64];
+    if (!io->state_file[0]) return false;
+    FILE *fp = fopen(io->state_file, "r");
+    if (!fp) return false;
+    char *ok = fgets(expected, sizeof(expected), fp);
+    fclose(fp);
     
-    gpio_set_value(ST7735_CS_PIN, 1);
+    return ok && read_boot_id(boot_id, sizeof(boot_id)) == 0 &&
+           strcmp(expected, boot_id) == 0;
+}
+
+// 填入单屏的默认连接（CE0，引脚27/25/8/24）
+void st7735_config_default(st7735_config_t *config) {
+    if (!config) return;
+    
+    memset(config, 0, sizeof(*config));
+    config->spi_device = SPI_DEVICE;
+    config->spi_speed_hz = SPI_SPEED_HZ;
+    config->gpio_chip = NULL;
+    config->gpio_backend = gpio_backend;
+    config->rst_pin = ST7735_RST_PIN;
+    config->dc_pin = ST7735_DC_PIN;
+    config->cs_pin = ST7735_CS_PIN;
+    config->bl_pin = ST7735_BL_PIN;
+    config->rotation = ST7735_ROTATION_90;
+    config->warm_start = warm_start;
+}
+
+// 释放面板的缓冲和硬件资源（初始化失败时也用于回滚）
+static void release_resources(st7735_t *dev) {
+    free(dev->framebuffer);
+    dev->framebuffer = NULL;
+    free(dev->indexbuf);
+    dev->indexbuf = NULL;
+    free(dev->txbuf);
+    dev->txbuf = NULL;
+    st7735_glyph_cache_destroy(dev->glyphs);
+    dev->glyphs = NULL;
+    free(dev->console);
+    dev->console = NULL;
+    
+    struct st7735_io *io = dev->io;
+    if (!io) return;
+    
+    if (io->spi_fd >= 0) close(io->spi_fd);
+    // 释放GPIO控制线
+    st7735_gpio_close(&io->gpio);
+    bus_put(io->bus);
+    pthread_mutex_destroy(&io->lock);
+    free(io);
+    dev->io = NULL;
 }
 
 // 初始化函数
 int st7735_init(st7735_t *dev, st7735_rotation_t rotation) {
-    if (!dev) return -1;
-    
-    // 设置设备参数
-    dev->rotation = rotation;
+    st7735_config_t config;
+    st7735_config_default(&config);
+    config.rotation = rotation;
+    return st7735_init_config(dev, &config);
+}
+
+int st7735_init_config(st7735_t *dev, const st7735_config_t *config) {
+    if (!dev || !config) return -1;
+    
+    // 132x162显存的面板才需要偏移；偏移为0的132x162面板要显式给出gram_height
+    uint16_t gram_height = config->gram_height;
+    if (gram_height == 0) gram_height = config->col_offset || config->row_offset ? 162 : 160;
+    if (gram_height < 160 + config->row_offset) {
+        fprintf(stderr, "Error: Row offset %u does not fit a %u-line GRAM\n",
+                config->row_offset, gram_height);
+        return -1;
+    }
     
-    // 根据旋转方向设置宽高
-    if (rotation == ST7735_ROTATION_0 || rotation == ST7735_ROTATION_180) {
-        dev->width = 128;
-        dev->height = 160;
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    
+    memset(dev, 0, sizeof(*dev));
+    struct st7735_io *io = (struct st7735_io *)calloc(1, sizeof(*io));
+    if (!io) return -1;
+    dev->io = io;
+    io->spi_fd = -1;
+    io->gpio.handle_fd = -1;
+    for (int line = 0; line < ST7735_LINE_COUNT; line++) io->gpio.value_fd[line] = -1;
+    io->col_offset = config->col_offset;
+    io->row_offset = config->row_offset;
+    io->gram_height = gram_height;
+    pthread_mutex_init(&io->lock, NULL);
+    st7735_init_timing_t *timing = &io->init_timing;
+    
+    const char *device = config->spi_device ? config->spi_device : SPI_DEVICE;
+    const char *name = strrchr(device, '/');
+    if (config->transport) {
+        // 自定义传输不占用SPI总线，也不留状态文件
+        io->transport = *config->transport;
+        io->bus = bus_get("");
     } else {
-        dev->width = 160;
-        dev->height = 128;
+        snprintf(io->state_file, sizeof(io->state_file), STATE_FILE_FMT, name ? name + 1 : device);
+        io->bus = bus_get(device);
     }
+    if (!io->bus) {
+        fprintf(stderr, "Error: Too many SPI buses\n");
+        pthread_mutex_destroy(&io->lock);
+        free(io);
+        dev->io = NULL;
+        return -1;
+    }
+    
+    // 设置设备参数
+    st7735_rotation_t rotation = config->rotation;
+    dev->glyph_budget = ST7735_GLYPH_CACHE_BYTES;
+    dev->format = ST7735_FORMAT_RGB565;
+    dev->scale = 1;
+    st7735_default_palette(dev->palette);
+    
+    // 根据旋转方向设置宽高和显存偏移
+    rotation_madctl(dev, rotation);
+    st7735_reset_clip(dev);
     
     // 分配framebuffer内存
     dev->framebuffer = (uint16_t *)malloc(dev->width * dev->height * sizeof(uint16_t));
     if (!dev->framebuffer) {
         fprintf(stderr, "Error: Failed to allocate framebuffer\n");
+        release_resources(dev);
         return -1;
     }
     
-    // 初始化GPIO
-    gpio_export(ST7735_RST_PIN);
-    gpio_export(ST7735_DC_PIN);
-    gpio_export(ST7735_CS_PIN);
-    gpio_export(ST7735_BL_PIN);
+    // 发送缓冲：一次ioctl能带的最大数据量，不超过一帧
+    io->spi_bufsiz = read_spidev_bufsiz();
+    if (io->transport.transfer) {
+        io->spi_bufsiz = io->transport.max_transfer ? io->transport.max_transfer : SPIDEV_BUFSIZ_DEFAULT;
+    }
+    dev->txbuf_size = dev->width * dev->height * sizeof(uint16_t);
+    if (dev->txbuf_size > io->spi_bufsiz) dev->txbuf_size = io->spi_bufsiz & ~1u;
+    // RGB444先以16位收集再原地打包，需要多出1/3的空间
+    dev->txbuf = (uint8_t *)malloc(dev->txbuf_size / 3 * 4 + 4);
+    if (!dev->txbuf) {
+        fprintf(stderr, "Error: Failed to allocate tx buffer\n");
+        release_resources(dev);
+        return -1;
+    }
+    timing->us[ST7735_PHASE_ALLOC] = phase_end(&t);
+    
+    // 初始化GPIO：一次性申请所有控制线，默认CS/DC/RST高、背光关
+    const int pins[ST7735_LINE_COUNT] = {
+        [ST7735_LINE_RST] = config->rst_pin,
+        [ST7735_LINE_DC]  = config->dc_pin,
+        [ST7735_LINE_CS]  = config->cs_pin,
+        [ST7735_LINE_BL]  = config->bl_pin,
+    };
+    if (st7735_gpio_open(&io->gpio, config->gpio_backend, config->gpio_chip, pins,
+                         ST7735_LINE_BIT(ST7735_LINE_CS) |
+                         ST7735_LINE_BIT(ST7735_LINE_DC) |
+                         ST7735_LINE_BIT(ST7735_LINE_RST)) < 0) {
+        release_resources(dev);
+        return -1;
+    }
+    timing->us[ST7735_PHASE_GPIO] = phase_end(&t);
+    
+    // 初始化SPI（自定义传输时跳过）
+    if (!io->transport.transfer) {
+        io->spi_fd = open(device, O_RDWR | O_CLOEXEC);
+        if (io->spi_fd < 0) {
+            fprintf(stderr, "Error: Failed to open SPI device %s\n", device);
+            release_resources(dev);
+            return -1;
+        }
+        
+        // 设置SPI模式
+        uint8_t mode = SPI_MODE_0;
+        uint8_t bits = 8;
+        uint32_t speed = config->spi_speed_hz ? config->spi_speed_hz : SPI_SPEED_HZ;
+        
+        ioctl(io->spi_fd, SPI_IOC_WR_MODE, &mode);
+        ioctl(io->spi_fd, SPI_IOC_RD_MODE, &mode);
+        ioctl(io->spi_fd, SPI_IOC_WR_BITS_PER_WORD, &bits);
+        ioctl(io->spi_fd, SPI_IOC_RD_BITS_PER_WORD, &bits);
+        ioctl(io->spi_fd, SPI_IOC_WR_MAX_SPEED_HZ, &speed);
+        ioctl(io->spi_fd, SPI_IOC_RD_MAX_SPEED_HZ, &speed);
+    }
     
-    gpio_set_direction(ST7735_RST_PIN, "out");
-    gpio_set_direction(ST7735_DC_PIN, "out");
-    gpio_set_direction(ST7735_CS_PIN, "out");
-    gpio_set_direction(ST7735_BL_PIN, "out");
+    timing->us[ST7735_PHASE_SPI] = phase_end(&t);
     
-    // 默认状态
-    gpio_set_value(ST7735_CS_PIN, 1);
-    gpio_set_value(ST7735_DC_PIN, 1);
-    gpio_set_value(ST7735_RST_PIN, 1);
-    gpio_set_value(ST7735_BL_PIN, 0);
+    // 面板已经初始化过（服务重启）时跳过复位和退出睡眠
+    timing->warm = config->warm_start && panel_is_awake(io);
     
-    // 初始化SPI
-    spi_fd = open(SPI_DEVICE, O_RDWR);
-    if (spi_fd < 0) {
-        fprintf(stderr, "Error: Failed to open SPI device\n");
-        free(dev->framebuffer);
-        return -1;
+    // 硬件复位：低电平至少10us，释放后120ms内不能发命令
+    if (!timing->warm) {
+        gpio_set_value(io, ST7735_LINE_RST, 0);
+        usleep(10);
+        gpio_set_value(io, ST7735_LINE_RST, 1);
+        usleep(120000);
     }
     
-    // 设置SPI模式
-    uint8_t mode = SPI_MODE_0;
-    uint8_t bits = 8;
-    uint32_t speed = 16000000;
+    // 按阶段执行初始化表，每个阶段一个命令列表
+    bool hw_reset = io->gpio.pins[ST7735_LINE_RST] >= 0;
+    st7735_cmdlist_t *cl = &io->cmdlist;
+    for (int phase = ST7735_PHASE_RESET; phase <= ST7735_PHASE_DISPLAY_ON; phase++) {
+        st7735_cmdlist_reset(cl);
+        
+        for (size_t i = 0; i < sizeof(init_table) / sizeof(init_table[0]); i++) {
+            const init_step_t *step = &init_table[i];
+            if (step->phase != phase) continue;
+            if ((step->flags & STEP_COLD) && timing->warm) continue;
+            if ((step->flags & STEP_NO_HWRST) && hw_reset) continue;
+            
+            if (step->flags & STEP_MADCTL) {
+                uint8_t madctl = rotation_madctl(dev, rotation);
+                st7735_cmdlist_cmd(cl, step->cmd, &madctl, 1);
+            } else if (step->flags & STEP_SCROLL) {
+                // 滚动区从面板第一行开始（TFA为行偏移），起始行复位；
+                // 三段之和必须等于显存行数，显存中多出的行归入BFA
+                uint8_t params[6];
+                memcpy(params, step->params, step->len);
+                params[1] = io->row_offset;
+                params[5] = io->gram_height - 160 - io->row_offset;
+                st7735_cmdlist_cmd(cl, step->cmd, params, step->len);
+            } else {
+                st7735_cmdlist_cmd(cl, step->cmd, step->params, step->len);
+            }
+            if (step->delay_ms) {
+                st7735_cmdlist_delay(cl, step->delay_ms * 1000);
+            }
+        }
+        
+        if (cl->seg_count > 0) {
+            st7735_run(io, ST7735_LIST_INIT);
+        }
+        timing->us[phase] = phase_end(&t);
+    }
     
-    ioctl(spi_fd, SPI_IOC_WR_MODE, &mode);
-    ioctl(spi_fd, SPI_IOC_RD_MODE, &mode);
-    ioctl(spi_fd, SPI_IOC_WR_BITS_PER_WORD, &bits);
-    ioctl(spi_fd, SPI_IOC_RD_BITS_PER_WORD, &bits);
-    ioctl(spi_fd, SPI_IOC_WR_MAX_SPEED_HZ, &speed);
-    ioctl(spi_fd, SPI_IOC_RD_MAX_SPEED_HZ, &speed);
+    // 开启背光
+    st7735_set_backlight(dev, true);
     
-    // 硬件复位
-    gpio_set_value(ST7735_RST_PIN, 0);
-    usleep(100000);
-    gpio_set_value(ST7735_RST_PIN, 1);
-    usleep(100000);
+    // 清屏
+    st7735_clear(dev, ST7735_BLACK);
     
-    // 开始初始化序列
-    gpio_set_value(ST7735_CS_PIN, 0);
+    // 记录面板已唤醒，供下次热启动判断
+    write_state_file(io);
+    // 初始化序列不计入运行统计
+    st7735_reset_stats(dev);
     
-    // 软件复位
-    st7735_write_command(ST7735_SWRESET);
-    usleep(150000);
+    timing->total_us = 0;
+    for (int phase = 0; phase < ST7735_PHASE_COUNT; phase++) {
+        timing->total_us += timing->us[phase];
+    }
     
-    // 退出睡眠模式
-    st7735_write_command(ST7735_SLPOUT);
-    usleep(150000);
+    return 0;
+}
+
+void st7735_deinit(st7735_t *dev) {
+    if (!dev) return;
     
-    // 帧率控制
-    st7735_write_command(0xB1);
-    st7735_write_data(0x01);
-    st7735_write_data(0x2C);
-    st7735_write_data(0x2D);
-    
-    st7735_write_command(0xB2);
-    st7735_write_data(0x01);
-    st7735_write_data(0x2C);
-    st7735_write_data(0x2D);
-    
-    st7735_write_command(0xB3);
-    st7735_write_data(0x01);
-    st7735_write_data(0x2C);
-    st7735_write_data(0x2D);
-    st7735_write_data(0x01);
-    st7735_write_data(0x2C);
-    st7735_write_data(0x2D);
+    // 先停止异步刷新线程
+    st7735_disable_async(dev);
     
-    // 显示反转
-    st7735_write_command(0xB4);
-    st7735_write_data(0x07);
+    struct st7735_io *io = dev->io;
+    if (io) {
+        // 关闭背光
+        st7735_set_backlight(dev, false);
+        
+        // 清屏
+        st7735_clear(dev, ST7735_BLACK);
+        st7735_update(dev);
+        
+        // 关闭显示
+        st7735_cmdlist_reset(&io->cmdlist);
+        st7735_cmdlist_cmd(&io->cmdlist, ST7735_DISPOFF, NULL, 0);
+        st7735_cmdlist_cmd(&io->cmdlist, ST7735_SLPIN, NULL, 0);
+        st7735_run(io, ST7735_LIST_INIT);
+        
+        // 面板已进入睡眠，下次必须冷启动
+        unlink(io->state_file);
+    }
     
-    // 电源控制
-    st7735_write_command(0xC0);
-    st7735_write_data(0xA2);
-    st7735_write_data(0x02);
-    st7735_write_data(0x84);
+    // 释放资源
+    release_resources(dev);
+}
+
+// 设置显示方向
+void st7735_set_rotation(st7735_t *dev, st7735_rotation_t rotation) {
+    if (!dev) return;
     
-    st7735_write_command(0xC1);
-    st7735_write_data(0xC5);
+    // 滚动终端依赖当前方向的行映射
+    st7735_console_end(dev);
     
-    st7735_write_command(0xC2);
-    st7735_write_data(0x0A);
-    st7735_write_data(0x00);
+    // 刷新线程会读取宽高，先等它发完
+    st7735_wait_flush(dev);
     
-    st7735_write_command(0xC3);
-    st7735_write_data(0x8A);
-    st7735_write_data(0x2A);
+    uint8_t madctl = rotation_madctl(dev, rotation);
+    // 宽高可能交换，原有的裁剪区域不再有意义
+    st7735_reset_clip(dev);
     
-    st7735_write_command(0xC4);
-    st7735_write_data(0x8A);
-    st7735_write_data(0xEE);
+    if (dev->io) {
+        st7735_cmdlist_reset(&dev->io->cmdlist);
+        st7735_cmdlist_cmd(&dev->io->cmdlist, ST7735_MADCTL, &madctl, 1);
+        st7735_run(dev->io, ST7735_LIST_ROTATION);
+    }
     
-    st7735_write_command(0xC5);
-    st7735_write_data(0x0E);
+    // 方向改变后屏上内容与framebuffer不再对应
+    st7735_mark_dirty(dev, 0, 0, dev->width, dev->height);
+}
+
+// 设置线上像素格式，framebuffer不变；面板显存内容不受COLMOD影响，无需重发
+void st7735_set_pixel_format(st7735_t *dev, st7735_pixel_format_t format) {
+    if (!dev || format == dev->format) return;
+    
+    // 刷新线程按格式打包，先等它发完
+    st7735_wait_flush(dev);
+    
+    bool was_565 = dev->format == ST7735_FORMAT_RGB565;
+    dev->format = format;
+    if (was_565 == (format == ST7735_FORMAT_RGB565)) return;
+    
+    if (!dev->io) return;
+    uint8_t colmod = format == ST7735_FORMAT_RGB565 ? COLMOD_RGB565 : COLMOD_RGB444;
+    st7735_cmdlist_reset(&dev->io->cmdlist);
+    st7735_cmdlist_cmd(&dev->io->cmdlist, ST7735_COLMOD, &colmod, 1);
+    st7735_run(dev->io, ST7735_LIST_FORMAT);
+}
+
+// 脏矩形管理
+static uint32_t rect_area(const st7735_rect_t *r) {
+    return (uint32_t)(r->x1 - r->x0 + 1) * (r->y1 - r->y0 + 1);
+}
+
+static st7735_rect_t rect_union(const st7735_rect_t *a, const st7735_rect_t *b) {
+    st7735_rect_t u;
+    u.x0 = a->x0 < b->x0 ? a->x0 : b->x0;
+    u.y0 = a->y0 < b->y0 ? a->y0 : b->y0;
+    u.x1 = a->x1 > b->x1 ? a->x1 : b->x1;
+    u.y1 = a->y1 > b->y1 ? a->y1 : b->y1;
+    return u;
+}
+
+// 合并后多发送的像素数（并集面积减去两者实际覆盖的面积）
+static uint32_t rect_merge_waste(const st7735_rect_t *a, const st7735_rect_t *b) {
+    st7735_rect_t u = rect_union(a, b);
+    uint32_t covered = rect_area(a) + rect_area(b);
+    int ix0 = a->x0 > b->x0 ? a->x0 : b->x0;
+    int iy0 = a->y0 > b->y0 ? a->y0 : b->y0;
+    int ix1 = a->x1 < b->x1 ? a->x1 : b->x1;
+    int iy1 = a->y1 < b->y1 ? a->y1 : b->y1;
+    if (ix0 <= ix1 && iy0 <= iy1) {
+        covered -= (uint32_t)(ix1 - ix0 + 1) * (iy1 - iy0 + 1);
+    }
+    return rect_area(&u) - covered;
+}
+
+// 记录一个被修改的区域（屏幕坐标的闭区间，可越界）
+static void dirty_add_screen(st7735_t *dev, int x0, int y0, int x1, int y1) {
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 >= dev->width) x1 = dev->width - 1;
+    if (y1 >= dev->height) y1 = dev->height - 1;
+    if (x0 > x1 || y0 > y1) return;
+    
+#if ST7735_STATS
+    // 本帧的第一次绘制
+    if (dev->dirty_count == 0 && dev->io && !dev->io->render_start) {
+        dev->io->render_start = stats_now();
+    }
+#endif
+    
+    st7735_rect_t r = { x0, y0, x1, y1 };
+    
+    // 反复吸收代价足够小的已有区域
+    int merged = 1;
+    while (merged) {
+        merged = 0;
+        for (int i = 0; i < dev->dirty_count; i++) {
+            if (rect_merge_waste(&dev->dirty[i], &r) <= ST7735_DIRTY_SLACK) {
+                r = rect_union(&dev->dirty[i], &r);
+                dev->dirty[i] = dev->dirty[--dev->dirty_count];
+                merged = 1;
+                break;
+            }
+        }
+    }
     
-    // Gamma校正
-    st7735_write_command(0xE0);
-    uint8_t gamma_pos[] = {
-        0x0F, 0x1A, 0x0F, 0x18, 0x2F, 0x28, 0x20, 0x22,
-        0x1F, 0x1B, 0x23, 0x37, 0x00, 0x07, 0x02, 0x10
-    };
-    st7735_write_data_bulk(gamma_pos, sizeof(gamma_pos));
+    if (dev->dirty_count < ST7735_MAX_DIRTY) {
+        dev->dirty[dev->dirty_count++] = r;
+        return;
+    }
     
-    st7735_write_command(0xE1);
-    uint8_t gamma_neg[] = {
-        0x0F, 0x1B, 0x0F, 0x17, 0x33, 0x2C, 0x29, 0x2E,
-        0x30, 0x30, 0x39, 0x3F, 0x00, 0x07, 0x03, 0x10
-    };
-    st7735_write_data_bulk(gamma_neg, sizeof(gamma_neg));
+    // 列表已满：在已有区域和新区域中找合并代价最小的一对
+    st7735_rect_t all[ST7735_MAX_DIRTY + 1];
+    memcpy(all, dev->dirty, sizeof(dev->dirty));
+    all[ST7735_MAX_DIRTY] = r;
+    
+    int best_i = 0, best_j = 1;
+    uint32_t best = UINT32_MAX;
+    for (int i = 0; i < ST7735_MAX_DIRTY + 1; i++) {
+        for (int j = i + 1; j < ST7735_MAX_DIRTY + 1; j++) {
+            uint32_t waste = rect_merge_waste(&all[i], &all[j]);
+            if (waste < best) {
+                best = waste;
+                best_i = i;
+                best_j = j;
+            }
+        }
+    }
     
-    // 颜色模式：16位RGB565
-    st7735_write_command(ST7735_COLMOD);
-    st7735_write_data(0x05);
+    all[best_i] = rect_union(&all[best_i], &all[best_j]);
+    all[best_j] = all[ST7735_MAX_DIRTY];
+    memcpy(dev->dirty, all, sizeof(dev->dirty));
+}
+
+// 记录一个被修改的区域（视口坐标的闭区间），截断到裁剪区域
+static void dirty_add(st7735_t *dev, int x0, int y0, int x1, int y1) {
+    const st7735_clip_t *c = &dev->clip;
+    x0 += c->ox;
+    x1 += c->ox;
+    y0 += c->oy;
+    y1 += c->oy;
+    if (x0 < c->x0) x0 = c->x0;
+    if (y0 < c->y0) y0 = c->y0;
+    if (x1 >= c->x1) x1 = c->x1 - 1;
+    if (y1 >= c->y1) y1 = c->y1 - 1;
+    
+    dirty_add_screen(dev, x0, y0, x1, y1);
+}
+
+void st7735_mark_dirty(st7735_t *dev, uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    if (!dev || w == 0 || h == 0) return;
+    dirty_add_screen(dev, x, y, x + w - 1, y + h - 1);
+}
+
+// ===== 裁剪与视口 =====
+
+void st7735_reset_clip(st7735_t *dev) {
+    if (!dev) return;
+    dev->clip = (st7735_clip_t){ 0, 0, dev->width, dev->height, 0, 0 };
+    dev->clip_depth = 0;
+}
+
+// 与当前裁剪区域求交后压栈；move_origin为真时原点移到区域左上角
+static int push_clip(st7735_t *dev, int x, int y, int w, int h, bool move_origin) {
+    if (!dev || dev->clip_depth >= ST7735_CLIP_DEPTH) return -1;
+    
+    st7735_clip_t c = dev->clip;
+    x += c.ox;
+    y += c.oy;
+    int x0 = x > c.x0 ? x : c.x0;
+    int y0 = y > c.y0 ? y : c.y0;
+    int x1 = x + w < c.x1 ? x + w : c.x1;
+    int y1 = y + h < c.y1 ? y + h : c.y1;
+    
+    dev->clip_stack[dev->clip_depth++] = c;
+    // 不相交时为空区域，之后的绘制全部被丢弃
+    c.x0 = x0;
+    c.y0 = y0;
+    c.x1 = x1 > x0 ? x1 : x0;
+    c.y1 = y1 > y0 ? y1 : y0;
+    if (move_origin) {
+        c.ox = x;
+        c.oy = y;
+    }
+    dev->clip = c;
+    return 0;
+}
+
+int st7735_push_clip(st7735_t *dev, int x, int y, int w, int h) {
+    return push_clip(dev, x, y, w, h, false);
+}
+
+int st7735_push_viewport(st7735_t *dev, int x, int y, int w, int h) {
+    return push_clip(dev, x, y, w, h, true);
+}
+
+void st7735_pop_clip(st7735_t *dev) {
+    if (!dev || dev->clip_depth == 0) return;
+    dev->clip = dev->clip_stack[--dev->clip_depth];
+}
+
+// RGB565或索引色framebuffer是否存在
+static inline bool has_canvas(const st7735_t *dev) {
+    return dev->framebuffer || dev->indexbuf;
+}
+
+// 视口坐标的包围盒（闭区间）是否完全在裁剪区域内
+static inline bool clip_inside(const st7735_t *dev, int x0, int y0, int x1, int y1) {
+    const st7735_clip_t *c = &dev->clip;
+    return x0 + c->ox >= c->x0 && y0 + c->oy >= c->y0 &&
+           x1 + c->ox < c->x1 && y1 + c->oy < c->y1;
+}
+
+// 包围盒与裁剪区域是否相交
+static inline bool clip_overlaps(const st7735_t *dev, int x0, int y0, int x1, int y1) {
+    const st7735_clip_t *c = &dev->clip;
+    return x1 + c->ox >= c->x0 && y1 + c->oy >= c->y0 &&
+           x0 + c->ox < c->x1 && y0 + c->oy < c->y1;
+}
+
+// 写像素（视口坐标，不记录脏区域，由调用者按图元包围盒统一记录）。
+// check为假时调用者已确认整个图元在裁剪区域内
+static inline __attribute__((always_inline))
+void plot(st7735_t *dev, int x, int y, uint16_t color, bool check) {
+    x += dev->clip.ox;
+    y += dev->clip.oy;
+    if (check && (x < dev->clip.x0 || y < dev->clip.y0 ||
+                  x >= dev->clip.x1 || y >= dev->clip.y1)) return;
+    if (dev->indexbuf) {
+        dev->indexbuf[y * dev->width + x] = (uint8_t)color;
+    } else {
+        dev->framebuffer[y * dev->width + x] = color;
+    }
+}
+
+// ===== span光栅化：每个图元只裁剪一次，内层循环不再做边界检查 =====
+// 坐标都是视口坐标，先平移到屏幕坐标再与裁剪区域求交
+
+// 水平线段 [x0, x1]
+static void raster_hspan(st7735_t *dev, int x0, int x1, int y, uint16_t color) {
+    const st7735_clip_t *c = &dev->clip;
+    x0 += c->ox;
+    x1 += c->ox;
+    y += c->oy;
+    if (y < c->y0 || y >= c->y1) return;
+    if (x0 < c->x0) x0 = c->x0;
+    if (x1 >= c->x1) x1 = c->x1 - 1;
+    if (x0 > x1) return;
+    
+    if (dev->indexbuf) {
+        memset(&dev->indexbuf[y * dev->width + x0], (uint8_t)color, x1 - x0 + 1);
+        return;
+    }
+    st7735_fill16(&dev->framebuffer[y * dev->width + x0], color, x1 - x0 + 1);
+}
+
+// 垂直线段 [y0, y1]
+static void raster_vspan(st7735_t *dev, int x, int y0, int y1, uint16_t color) {
+    const st7735_clip_t *c = &dev->clip;
+    x += c->ox;
+    y0 += c->oy;
+    y1 += c->oy;
+    if (x < c->x0 || x >= c->x1) return;
+    if (y0 < c->y0) y0 = c->y0;
+    if (y1 >= c->y1) y1 = c->y1 - 1;
+    
+    if (dev->indexbuf) {
+        uint8_t *q = &dev->indexbuf[y0 * dev->width + x];
+        for (int y = y0; y <= y1; y++, q += dev->width) {
+            *q = (uint8_t)color;
+        }
+        return;
+    }
+    uint16_t *p = &dev->framebuffer[y0 * dev->width + x];
+    for (int y = y0; y <= y1; y++, p += dev->width) {
+        *p = color;
+    }
+}
+
+// 与裁剪区域求交：视口坐标的矩形 -> 屏幕坐标的半开区间，为空返回false
+static inline bool clip_rect(const st7735_t *dev, int x, int y, int w, int h,
+                             int *x0, int *y0, int *x1, int *y1) {
+    const st7735_clip_t *c = &dev->clip;
+    x += c->ox;
+    y += c->oy;
+    *x0 = x < c->x0 ? c->x0 : x;
+    *y0 = y < c->y0 ? c->y0 : y;
+    *x1 = x + w > c->x1 ? c->x1 : x + w;
+    *y1 = y + h > c->y1 ? c->y1 : y + h;
+    return *x0 < *x1 && *y0 < *y1;
+}
+
+// 填充矩形，整行宽度时framebuffer连续，一次填完
+static void raster_rect(st7735_t *dev, int x, int y, int w, int h, uint16_t color) {
+    int x0, y0, x1, y1;
+    if (!clip_rect(dev, x, y, w, h, &x0, &y0, &x1, &y1)) return;
+    
+    if (dev->indexbuf) {
+        uint8_t *q = &dev->indexbuf[y0 * dev->width + x0];
+        if (x0 == 0 && x1 == dev->width) {
+            memset(q, (uint8_t)color, (size_t)(y1 - y0) * dev->width);
+            return;
+        }
+        for (int j = y0; j < y1; j++, q += dev->width) {
+            memset(q, (uint8_t)color, x1 - x0);
+        }
+        return;
+    }
+    uint16_t *p = &dev->framebuffer[y0 * dev->width + x0];
+    if (x0 == 0 && x1 == dev->width) {
+        st7735_fill16(p, color, (size_t)(y1 - y0) * dev->width);
+        return;
+    }
+    for (int j = y0; j < y1; j++, p += dev->width) {
+        st7735_fill16(p, color, x1 - x0);
+    }
+}
+
+// 复制RGB565像素块（stride为源的行宽），裁剪后逐行memcpy；仅RGB565模式
+static void raster_copy(st7735_t *dev, int x, int y, int w, int h,
+                        const uint16_t *src, int stride) {
+    int x0, y0, x1, y1;
+    if (!clip_rect(dev, x, y, w, h, &x0, &y0, &x1, &y1)) return;
+    
+    src += (y0 - y - dev->clip.oy) * stride + (x0 - x - dev->clip.ox);
+    uint16_t *p = &dev->framebuffer[y0 * dev->width + x0];
+    for (int j = y0; j < y1; j++, p += dev->width, src += stride) {
+        memcpy(p, src, (x1 - x0) * sizeof(uint16_t));
+    }
+}
+
+// 圆角/圆形的逐行半宽：dx为满足dx²+dy²<=r²的最大值，随dy增大单调减小
+static inline int circle_half_width(int r, int dy, int dx) {
+    while (dx > 0 && dx * dx + dy * dy > r * r) dx--;
+    return dx;
+}
+
+// 填充圆角矩形：圆角行按半宽缩进，中间行整行填充
+static void raster_round_rect(st7735_t *dev, int x, int y, int w, int h,
+                              int r, uint16_t color) {
+    if (r > w / 2) r = w / 2;
+    if (r > h / 2) r = h / 2;
+    
+    // 中间部分
+    raster_rect(dev, x, y + r, w, h - 2 * r, color);
+    
+    // 上下圆角区域，从靠近中间的一行向外
+    int dx = r;
+    for (int dy = 0; dy < r; dy++) {
+        // 圆心位于(x + r, y + r)和(x + w - 1 - r, ...)
+        dx = circle_half_width(r, dy + 1, dx);
+        int inset = r - dx;
+        raster_hspan(dev, x + inset, x + w - 1 - inset, y + r - 1 - dy, color);
+        raster_hspan(dev, x + inset, x + w - 1 - inset, y + h - r + dy, color);
+    }
+}
+
+// Bresenham直线；check为假时整条线已确认在裁剪区域内，逐点不再检查
+static inline __attribute__((always_inline))
+void raster_line(st7735_t *dev, int x0, int y0, int x1, int y1, uint16_t color, bool check) {
+    int dx = abs(x1 - x0);
+    int dy = abs(y1 - y0);
+    int sx = (x0 < x1) ? 1 : -1;
+    int sy = (y0 < y1) ? 1 : -1;
+    int err = dx - dy;
     
-    // 设置显示方向
-    st7735_set_rotation(dev, rotation);
+    while (1) {
+        plot(dev, x0, y0, color, check);
+        
+        if (x0 == x1 && y0 == y1) break;
+        
+        int e2 = 2 * err;
+        if (e2 > -dy) {
+            err -= dy;
+            x0 += sx;
+        }
+        if (e2 < dx) {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+// 四段四分之一圆弧（中点画圆），圆心分别为(cx0|cx1, cy0|cy1)；
+// cx0 == cx1且cy0 == cy1时为整圆
+static inline __attribute__((always_inline))
+void raster_arcs(st7735_t *dev, int cx0, int cy0, int cx1, int cy1, int r,
+                 uint16_t color, bool check) {
+    int px = r, py = 0, err = 0;
+    while (px >= py) {
+        plot(dev, cx1 + px, cy1 + py, color, check);
+        plot(dev, cx1 + py, cy1 + px, color, check);
+        plot(dev, cx0 - py, cy1 + px, color, check);
+        plot(dev, cx0 - px, cy1 + py, color, check);
+        plot(dev, cx0 - px, cy0 - py, color, check);
+        plot(dev, cx0 - py, cy0 - px, color, check);
+        plot(dev, cx1 + py, cy0 - px, color, check);
+        plot(dev, cx1 + px, cy0 - py, color, check);
+        
+        if (err <= 0) {
+            py += 1;
+            err += 2 * py + 1;
+        }
+        if (err > 0) {
+            px -= 1;
+            err -= 2 * px + 1;
+        }
+    }
+}
+
+// 按包围盒与裁剪区域的关系选择不检查/逐点检查的版本，完全在外时不画
+static void raster_outline(st7735_t *dev, int cx0, int cy0, int cx1, int cy1, int r,
+                           uint16_t color) {
+    if (clip_inside(dev, cx0 - r, cy0 - r, cx1 + r, cy1 + r)) {
+        raster_arcs(dev, cx0, cy0, cx1, cy1, r, color, false);
+    } else if (clip_overlaps(dev, cx0 - r, cy0 - r, cx1 + r, cy1 + r)) {
+        raster_arcs(dev, cx0, cy0, cx1, cy1, r, color, true);
+    }
+}
+
+// 清屏
+void st7735_clear(st7735_t *dev, uint16_t color) {
+    if (!dev || !has_canvas(dev)) return;
+    
+    // 有裁剪区域时只清除该区域
+    const st7735_clip_t *c = &dev->clip;
+    if (c->x0 != 0 || c->y0 != 0 || c->x1 != dev->width || c->y1 != dev->height) {
+        raster_rect(dev, c->x0 - c->ox, c->y0 - c->oy, c->x1 - c->x0, c->y1 - c->y0, color);
+        dirty_add_screen(dev, c->x0, c->y0, c->x1 - 1, c->y1 - 1);
+        return;
+    }
     
-    // 正常显示模式
-    st7735_write_command(ST7735_NORON);
-    usleep(10000);
+    if (dev->indexbuf) {
+        memset(dev->indexbuf, (uint8_t)color, dev->width * dev->height);
+    } else {
+        st7735_fill16(dev->framebuffer, color, dev->width * dev->height);
+    }
     
-    // 开启显示
-    st7735_write_command(ST7735_DISPON);
-    usleep(100000);
+    // 整屏覆盖，之前的脏区域都被包含
+    dev->dirty[0] = (st7735_rect_t){ 0, 0, dev->width - 1, dev->height - 1 };
+    dev->dirty_count = 1;
+}
+
+// 设置像素
+void st7735_set_pixel(st7735_t *dev, uint16_t x, uint16_t y, uint16_t color) {
+    if (!dev || !has_canvas(dev)) return;
+    if (!clip_inside(dev, x, y, x, y)) return;
     
-    gpio_set_value(ST7735_CS_PIN, 1);
+    plot(dev, x, y, color, false);
+    dirty_add(dev, x, y, x, y);
+}
+
+// 水平线
+void st7735_draw_hline(st7735_t *dev, uint16_t x, uint16_t y, uint16_t w, uint16_t color) {
+    if (!dev || !has_canvas(dev) || w == 0) return;
     
-    // 开启背光
-    st7735_set_backlight(true);
+    raster_hspan(dev, x, x + w - 1, y, color);
+    dirty_add(dev, x, y, x + w - 1, y);
+}
+
+// 垂直线
+void st7735_draw_vline(st7735_t *dev, uint16_t x, uint16_t y, uint16_t h, uint16_t color) {
+    if (!dev || !has_canvas(dev) || h == 0) return;
     
-    // 清屏
-    st7735_clear(dev, ST7735_BLACK);
+    raster_vspan(dev, x, y, y + h - 1, color);
+    dirty_add(dev, x, y, x, y + h - 1);
+}
+
+// 绘制矩形框
+void st7735_draw_rect(st7735_t *dev, uint16_t x, uint16_t y, 
+                     uint16_t w, uint16_t h, uint16_t color) {
+    if (!dev || !has_canvas(dev) || w == 0 || h == 0) return;
+    
+    raster_hspan(dev, x, x + w - 1, y, color);
+    raster_hspan(dev, x, x + w - 1, y + h - 1, color);
+    raster_vspan(dev, x, y, y + h - 1, color);
+    raster_vspan(dev, x + w - 1, y, y + h - 1, color);
+    
+    // 细长的框拆成四条边记录，避免把中间未改动的区域也发出去
+    if (w > 2 && h > 2) {
+        dirty_add(dev, x, y, x + w - 1, y);
+        dirty_add(dev, x, y + h - 1, x + w - 1, y + h - 1);
+        dirty_add(dev, x, y + 1, x, y + h - 2);
+        dirty_add(dev, x + w - 1, y + 1, x + w - 1, y + h - 2);
+    } else {
+        dirty_add(dev, x, y, x + w - 1, y + h - 1);
+    }
+}
+
+// 填充矩形
+void st7735_fill_rect(st7735_t *dev, uint16_t x, uint16_t y,
+                     uint16_t w, uint16_t h, uint16_t color) {
+    if (!dev || !has_canvas(dev) || w == 0 || h == 0) return;
     
-    return 0;
+    raster_rect(dev, x, y, w, h, color);
+    dirty_add(dev, x, y, x + w - 1, y + h - 1);
 }
 
-void st7735_deinit(st7735_t *dev) {
-    if (!dev) return;
+// 绘制直线（Bresenham算法，水平/垂直线走span快速路径）
+void st7735_draw_line(st7735_t *dev, uint16_t x0, uint16_t y0,
+                     uint16_t x1, uint16_t y1, uint16_t color) {
+    if (!dev || !has_canvas(dev)) return;
     
-    // 关闭背光
-    st7735_set_backlight(false);
+    int left = x0 < x1 ? x0 : x1;
+    int right = x0 > x1 ? x0 : x1;
+    int top = y0 < y1 ? y0 : y1;
+    int bottom = y0 > y1 ? y0 : y1;
+    dirty_add(dev, left, top, right, bottom);
     
-    // 清屏
-    st7735_clear(dev, ST7735_BLACK);
-    st7735_update(dev);
+    if (y0 == y1) {
+        raster_hspan(dev, left, right, y0, color);
+        return;
+    }
+    if (x0 == x1) {
+        raster_vspan(dev, x0, top, bottom, color);
+        return;
+    }
     
-    // 关闭显示
-    gpio_set_value(ST7735_CS_PIN, 0);
-    st7735_write_command(ST7735_DISPOFF);
-    st7735_write_command(ST7735_SLPIN);
-    gpio_set_value(ST7735_CS_PIN, 1);
+    // 整条线在裁剪区域内时逐点不再检查
+    if (clip_inside(dev, left, top, right, bottom)) {
+        raster_line(dev, x0, y0, x1, y1, color, false);
+    } else if (clip_overlaps(dev, left, top, right, bottom)) {
+        raster_line(dev, x0, y0, x1, y1, color, true);
+    }
+}
+
+// 绘制圆形框
+void st7735_draw_circle(st7735_t *dev, uint16_t x0, uint16_t y0,
+                       uint16_t r, uint16_t color) {
+    if (!dev || !has_canvas(dev)) return;
     
-    // 释放资源
-    if (dev->framebuffer) {
-        free(dev->framebuffer);
-        dev->framebuffer = NULL;
+    raster_outline(dev, x0, y0, x0, y0, r, color);
+    dirty_add(dev, x0 - r, y0 - r, x0 + r, y0 + r);
+}
+
+// 填充圆形：每行一个span，覆盖满足x²+y²<=r²的像素
+void st7735_fill_circle(st7735_t *dev, uint16_t x0, uint16_t y0,
+                       uint16_t r, uint16_t color) {
+    if (!dev || !has_canvas(dev)) return;
+    
+    int dx = r;
+    for (int dy = 0; dy <= r; dy++) {
+        dx = circle_half_width(r, dy, dx);
+        raster_hspan(dev, x0 - dx, x0 + dx, y0 + dy, color);
+        if (dy > 0) {
+            raster_hspan(dev, x0 - dx, x0 + dx, y0 - dy, color);
+        }
+    }
+    
+    dirty_add(dev, x0 - r, y0 - r, x0 + r, y0 + r);
+}
+
+// 填充圆角矩形
+void st7735_fill_round_rect(st7735_t *dev, uint16_t x, uint16_t y,
+                            uint16_t w, uint16_t h, uint16_t r, uint16_t color) {
+    if (!dev || !has_canvas(dev) || w == 0 || h == 0) return;
+    
+    raster_round_rect(dev, x, y, w, h, r, color);
+    dirty_add(dev, x, y, x + w - 1, y + h - 1);
+}
+
+// 绘制圆角矩形框：直边用span，四角按四分之一圆逐点绘制
+void st7735_draw_round_rect(st7735_t *dev, uint16_t x, uint16_t y,
+                            uint16_t w, uint16_t h, uint16_t r, uint16_t color) {
+    if (!dev || !has_canvas(dev) || w == 0 || h == 0) return;
+    
+    if (r > w / 2) r = w / 2;
+    if (r > h / 2) r = h / 2;
+    
+    raster_hspan(dev, x + r, x + w - 1 - r, y, color);
+    raster_hspan(dev, x + r, x + w - 1 - r, y + h - 1, color);
+    raster_vspan(dev, x, y + r, y + h - 1 - r, color);
+    raster_vspan(dev, x + w - 1, y + r, y + h - 1 - r, color);
+    
+    raster_outline(dev, x + r, y + r, x + w - 1 - r, y + h - 1 - r, r, color);
+    
+    dirty_add(dev, x, y, x + w - 1, y + h - 1);
+}
+
+// 降分辨率时的stage_pixels：r为面板坐标，每行从缩小的缓冲取样并水平放大；
+// 同一源行放大出的其余各行直接复制上一行（抖动时各行阈值不同，逐行生成）
+static uint32_t stage_scaled(st7735_t *dev, const uint16_t *fb, const st7735_rect_t *r,
+                             uint32_t pos, uint32_t max, uint32_t *bytes) {
+    unsigned s = dev->scale;
+    uint32_t w = r->x1 - r->x0 + 1;
+    uint32_t total = w * (r->y1 - r->y0 + 1);
+    uint16_t *dst = (uint16_t *)dev->txbuf;
+    bool pack = dev->format != ST7735_FORMAT_RGB565;
+    bool dither = dev->format == ST7735_FORMAT_RGB444_DITHER;
+    uint32_t n = 0;
+    
+    while (n < max && pos < total) {
+        uint32_t row = pos / w;
+        uint32_t col = pos % w;
+        uint32_t run = w - col;
+        if (run > max - n) run = max - n;
+        unsigned x = r->x0 + col, y = r->y0 + row;
+        
+        if (col == 0 && n >= w && y % s != 0 && !dither) {
+            // 上一行完整地在本块中
+            memcpy(dst + n, dst + n - w, run * sizeof(uint16_t));
+        } else {
+            size_t src = (size_t)(y / s) * dev->width + x / s;
+            if (dev->indexbuf) {
+                if (pack) st7735_upscale_lut16(dst + n, &dev->indexbuf[src], run, s, x % s, dev->palette);
+                else st7735_upscale_lut16_swap(dst + n, &dev->indexbuf[src], run, s, x % s, dev->palette);
+            } else {
+                if (pack) st7735_upscale16(dst + n, &fb[src], run, s, x % s);
+                else st7735_upscale16_swap(dst + n, &fb[src], run, s, x % s);
+            }
+            if (dither) st7735_dither444(dst + n, dst + n, run, x, y);
+        }
+        n += run;
+        pos += run;
+    }
+    
+    *bytes = pack ? st7735_pack444(dev->txbuf, dst, n) : n * sizeof(uint16_t);
+    return n;
+}
+
+// 从区域的第pos个像素起，按线格式转换后写入发送缓冲，返回处理的像素数，
+// *bytes为写入的字节数
+static uint32_t stage_pixels(st7735_t *dev, const uint16_t *fb, const st7735_rect_t *r,
+                             uint32_t pos, uint32_t max, uint32_t *bytes) {
+    uint32_t w = r->x1 - r->x0 + 1;
+    uint32_t total = w * (r->y1 - r->y0 + 1);
+    uint16_t *dst = (uint16_t *)dev->txbuf;
+    bool pack = dev->format != ST7735_FORMAT_RGB565;
+    bool dither = dev->format == ST7735_FORMAT_RGB444_DITHER;
+    uint32_t n = 0;
+    
+    if (dev->scale > 1) return stage_scaled(dev, fb, r, pos, max, bytes);
+    
+    // 整行宽度的区域在framebuffer中连续，不抖动时直接打包
+    if (pack && !dither && w == dev->width && !dev->indexbuf) {
+        n = total - pos < max ? total - pos : max;
+        *bytes = st7735_pack444(dev->txbuf, &fb[r->y0 * dev->width + r->x0 + pos], n);
+        return n;
+    }
+    
+    while (n < max && pos < total) {
+        uint32_t row = pos / w;
+        uint32_t col = pos % w;
+        // 整行宽度的区域在framebuffer中连续，可以跨行一次处理
+        uint32_t run = (w == dev->width) ? total - pos : w - col;
+        if (run > max - n) run = max - n;
+        
+        if (dev->indexbuf) {
+            // 索引色：查调色板展开，RGB565线格式时同时交换字节序；RGB444展开后照常抖动/打包
+            const uint8_t *idx = &dev->indexbuf[(r->y0 + row) * dev->width + r->x0 + col];
+            if (dither && run > w - col) run = w - col;
+            if (!pack) {
+                st7735_lut16_swap(dst + n, idx, run, dev->palette);
+            } else {
+                st7735_lut16(dst + n, idx, run, dev->palette);
+                if (dither) st7735_dither444(dst + n, dst + n, run, r->x0 + col, r->y0 + row);
+            }
+            n += run;
+            pos += run;
+            continue;
+        }
+        
+        const uint16_t *src = &fb[(r->y0 + row) * dev->width + r->x0 + col];
+        if (!pack) {
+            st7735_swap16(dst + n, src, run);
+        } else if (dither) {
+            // 抖动按行进行，跨行的连续区域逐行处理
+            if (run > w - col) run = w - col;
+            st7735_dither444(dst + n, src, run, r->x0 + col, r->y0 + row);
+        } else {
+            memcpy(dst + n, src, run * sizeof(uint16_t));
+        }
+        n += run;
+        pos += run;
     }
     
-    if (spi_fd >= 0) {
-        close(spi_fd);
-        spi_fd = -1;
+    *bytes = pack ? st7735_pack444(dev->txbuf, dst, n) : n * sizeof(uint16_t);
+    return n;
+}
+
+// 发送一个区域：窗口设置和第一块像素在同一个命令列表中，
+// 其余按spidev的bufsiz切成最大块，RAMWR期间CS保持有效。
+// addr_y为区域第一行在显存中的行号
+static void st7735_flush_window(st7735_t *dev, const uint16_t *fb, const st7735_rect_t *r,
+                                uint16_t addr_y) {
+    uint32_t total = (uint32_t)(r->x1 - r->x0 + 1) * (r->y1 - r->y0 + 1);
+    // 每块像素数：RGB444两像素3字节，保持偶数使打包不跨块
+    uint32_t chunk = dev->format == ST7735_FORMAT_RGB565 ?
+                     dev->txbuf_size / sizeof(uint16_t) : dev->txbuf_size / 3 * 2;
+    uint32_t bytes;
+    struct st7735_io *io = dev->io;
+    if (!io) return;
+    
+    io_acquire(io);
+    STATS_ADD(io, rects, 1);
+    STATS_ADD(io, pixels, total);
+    uint64_t t = STATS_NOW();
+    uint32_t pos = stage_pixels(dev, fb, r, 0, chunk, &bytes);
+    t = STATS_LAP(io, pack_ns, t);
+    
+    st7735_cmdlist_reset(&io->cmdlist);
+    cmdlist_window(io, r->x0, addr_y, r->x1, addr_y + (r->y1 - r->y0));
+    st7735_cmdlist_data(&io->cmdlist, dev->txbuf, bytes);
+    st7735_exec(io, ST7735_LIST_WINDOW);
+    t = STATS_LAP(io, transfer_ns, t);
+    
+    while (pos < total) {
+        uint32_t n = stage_pixels(dev, fb, r, pos, chunk, &bytes);
+        t = STATS_LAP(io, pack_ns, t);
+        struct spi_ioc_transfer xfer = {
+            .tx_buf = (unsigned long)dev->txbuf,
+            .len = bytes,
+            .bits_per_word = 8,
+        };
+        spi_sink(io, 1, &xfer, 1);
+        t = STATS_LAP(io, transfer_ns, t);
+        
+        io->list_stats[ST7735_LIST_WINDOW].transfers++;
+        io->list_stats[ST7735_LIST_WINDOW].ioctls++;
+        io->list_stats[ST7735_LIST_WINDOW].bytes += xfer.len;
+        pos += n;
     }
     
-    // 取消GPIO导出
-    gpio_unexport(ST7735_RST_PIN);
-    gpio_unexport(ST7735_DC_PIN);
-    gpio_unexport(ST7735_CS_PIN);
-    gpio_unexport(ST7735_BL_PIN);
+    io_release(io);
 }
 
-// 设置显示方向
-void st7735_set_rotation(st7735_t *dev, st7735_rotation_t rotation) {
-    if (!dev) return;
-    
-    dev->rotation = rotation;
+// 硬件滚动后framebuffer的行在显存中循环偏移，跨过显存末行的区域拆成两个窗口
+static void st7735_flush_rect(st7735_t *dev, const uint16_t *fb, const st7735_rect_t *r) {
+    // 降分辨率时换算成面板坐标，发送时放大（此时不使用硬件滚动）
+    if (dev->scale > 1) {
+        uint16_t s = dev->scale;
+        st7735_rect_t panel = { r->x0 * s, r->y0 * s, (r->x1 + 1) * s - 1, (r->y1 + 1) * s - 1 };
+        st7735_flush_window(dev, fb, &panel, panel.y0);
+        return;
+    }
     
-    uint8_t madctl = 0;
+    uint16_t addr_y = (r->y0 + dev->scroll) % dev->height;
+    uint16_t rows_to_end = dev->height - addr_y;
     
-    switch (rotation) {
-        case ST7735_ROTATION_0:
-            madctl = MADCTL_MX | MADCTL_MY | MADCTL_BGR;
-            dev->width = 128;
-            dev->height = 160;
-            break;
-        case ST7735_ROTATION_90:
-            madctl = MADCTL_MY | MADCTL_MV | MADCTL_BGR;
-            dev->width = 160;
-            dev->height = 128;
-            break;
-        case ST7735_ROTATION_180:
-            madctl = MADCTL_BGR;
-            dev->width = 128;
-            dev->height = 160;
-            break;
-        case ST7735_ROTATION_270:
-            madctl = MADCTL_MX | MADCTL_MV | MADCTL_BGR;
-            dev->width = 160;
-            dev->height = 128;
-            break;
+    if (r->y1 - r->y0 < rows_to_end) {
+        st7735_flush_window(dev, fb, r, addr_y);
+        return;
     }
     
-    gpio_set_value(ST7735_CS_PIN, 0);
-    st7735_write_command(ST7735_MADCTL);
-    st7735_write_data(madctl);
-    gpio_set_value(ST7735_CS_PIN, 1);
+    st7735_rect_t top = *r;
+    st7735_rect_t wrapped = *r;
+    top.y1 = r->y0 + rows_to_end - 1;
+    wrapped.y0 = top.y1 + 1;
+    st7735_flush_window(dev, fb, &top, addr_y);
+    st7735_flush_window(dev, fb, &wrapped, 0);
 }
 
-// 清屏
-void st7735_clear(st7735_t *dev, uint16_t color) {
-    if (!dev || !dev->framebuffer) return;
-    
-    for (int i = 0; i < dev->width * dev->height; i++) {
-        dev->framebuffer[i] = color;
+#if ST7735_STATS
+// 提交刷新：结束本帧的绘制计时（绘制线程），返回当前时间
+static uint64_t stats_render_end(st7735_t *dev) {
+    uint64_t now = stats_now();
+    struct st7735_io *io = dev->io;
+    if (io && io->render_start) {
+        io->stats.render_ns += now - io->render_start;
+        io->render_start = 0;
     }
+    return now;
 }
 
-// 设置像素
-void st7735_set_pixel(st7735_t *dev, uint16_t x, uint16_t y, uint16_t color) {
-    if (!dev || !dev->framebuffer) return;
-    if (x >= dev->width || y >= dev->height) return;
-    
-    dev->framebuffer[y * dev->width + x] = color;
+// 一帧发送完成（发送线程）
+static void stats_frame_end(st7735_t *dev, uint64_t start) {
+    struct st7735_io *io = dev->io;
+    if (!io) return;
+    pthread_mutex_lock(&io->lock);
+    io->stats.frames++;
+    io->stats.screen_pixels += dev->width * dev->height * dev->scale * dev->scale;
+    io->stats.flush_ns += stats_now() - start;
+    pthread_mutex_unlock(&io->lock);
 }
 
-// 绘制矩形框
-void st7735_draw_rect(st7735_t *dev, uint16_t x, uint16_t y, 
-                     uint16_t w, uint16_t h, uint16_t color) {
-    if (!dev) return;
+static void stats_maybe_dump(st7735_t *dev);
+#else
+static inline uint64_t stats_render_end(st7735_t *dev) { (void)dev; return 0; }
+static inline void stats_frame_end(st7735_t *dev, uint64_t start) { (void)dev; (void)start; }
+static inline void stats_maybe_dump(st7735_t *dev) { (void)dev; }
+#endif
+
+// 更新显示：每个脏区域一次CASET/RASET/RAMWR
+void st7735_update(st7735_t *dev) {
+    if (!dev || !has_canvas(dev)) return;
     
-    // 上边
-    for (uint16_t i = x; i < x + w && i < dev->width; i++) {
-        st7735_set_pixel(dev, i, y, color);
+    // 双缓冲模式下交给刷新线程并等待完成
+    if (dev->async) {
+        st7735_update_async(dev);
+        st7735_wait_flush(dev);
+        return;
     }
     
-    // 下边
-    if (y + h - 1 < dev->height) {
-        for (uint16_t i = x; i < x + w && i < dev->width; i++) {
-            st7735_set_pixel(dev, i, y + h - 1, color);
+    if (dev->dirty_count > 0) {
+        uint64_t start = stats_render_end(dev);
+        for (int i = 0; i < dev->dirty_count; i++) {
+            st7735_flush_rect(dev, dev->framebuffer, &dev->dirty[i]);
         }
+        stats_frame_end(dev, start);
+        dev->dirty_count = 0;
     }
+    stats_maybe_dump(dev);
+}
+
+// 整屏刷新（例如屏幕内容被外部破坏后）
+void st7735_update_full(st7735_t *dev) {
+    if (!dev || !has_canvas(dev)) return;
     
-    // 左边
-    for (uint16_t i = y; i < y + h && i < dev->height; i++) {
-        st7735_set_pixel(dev, x, i, color);
-    }
-    
-    // 右边
-    if (x + w - 1 < dev->width) {
-        for (uint16_t i = y; i < y + h && i < dev->height; i++) {
-            st7735_set_pixel(dev, x + w - 1, i, color);
+    st7735_mark_dirty(dev, 0, 0, dev->width, dev->height);
+    st7735_update(dev);
+}
+
+// ===== 索引色模式 =====
+
+// 切换framebuffer格式：RGB565 -> 索引色按RGB332量化，索引色 -> RGB565查表展开
+int st7735_set_color_mode(st7735_t *dev, st7735_color_mode_t mode) {
+    if (!dev || !has_canvas(dev)) return -1;
+    
+    bool indexed = mode == ST7735_COLOR_INDEXED8;
+    if (indexed == (dev->indexbuf != NULL)) return 0;
+    // 双缓冲和滚动终端直接操作RGB565缓冲
+    if (dev->async || dev->console) return -1;
+    
+    size_t pixels = (size_t)dev->width * dev->height;
+    if (indexed) {
+        uint8_t *buf = (uint8_t *)malloc(pixels);
+        if (!buf) return -1;
+        for (size_t i = 0; i < pixels; i++) {
+            uint16_t p = dev->framebuffer[i];
+            buf[i] = ((p >> 8) & 0xE0) | ((p >> 6) & 0x1C) | ((p >> 3) & 0x03);
         }
+        free(dev->framebuffer);
+        dev->framebuffer = NULL;
+        dev->indexbuf = buf;
+        // 量化后的颜色与屏上不同
+        st7735_mark_dirty(dev, 0, 0, dev->width, dev->height);
+    } else {
+        uint16_t *buf = (uint16_t *)malloc(pixels * sizeof(uint16_t));
+        if (!buf) return -1;
+        // 展开结果与屏上相同，不需要重发
+        st7735_lut16(buf, dev->indexbuf, pixels, dev->palette);
+        free(dev->indexbuf);
+        dev->indexbuf = NULL;
+        dev->framebuffer = buf;
     }
+    return 0;
 }
 
-// 填充矩形
-void st7735_fill_rect(st7735_t *dev, uint16_t x, uint16_t y,
-                     uint16_t w, uint16_t h, uint16_t color) {
-    if (!dev) return;
-    
-    for (uint16_t j = y; j < y + h && j < dev->height; j++) {
-        for (uint16_t i = x; i < x + w && i < dev->width; i++) {
-            st7735_set_pixel(dev, i, j, color);
+// 面板没有调色板，换色后使用这些索引的像素要重新展开发送；
+// 不知道哪些像素用到了被修改的项，只能整屏标记
+void st7735_set_palette(st7735_t *dev, uint8_t first, uint16_t count, const uint16_t *colors) {
+    if (!dev || !colors) return;
+    if (count > 256 - first) count = 256 - first;
+    if (count == 0 || memcmp(&dev->palette[first], colors, count * sizeof(uint16_t)) == 0) return;
+    
+    memcpy(&dev->palette[first], colors, count * sizeof(uint16_t));
+    if (dev->indexbuf) st7735_mark_dirty(dev, 0, 0, dev->width, dev->height);
+}
+
+// RGB332：索引的高3位为R，中3位为G，低2位为B，各通道按位重复扩展到8位
+void st7735_default_palette(uint16_t palette[256]) {
+    for (int i = 0; i < 256; i++) {
+        unsigned r = i >> 5, g = (i >> 2) & 7, b = i & 3;
+        palette[i] = st7735_color_rgb((r << 5) | (r << 2) | (r >> 1),
+                                      (g << 5) | (g << 2) | (g >> 1), b * 0x55);
+    }
+}
+
+uint8_t st7735_color_index(uint8_t r, uint8_t g, uint8_t b) {
+    return (r & 0xE0) | ((g >> 3) & 0x1C) | (b >> 6);
+}
+
+// ===== 降分辨率渲染 =====
+
+// 切换渲染缩放：新缓冲按面板坐标最近邻取样，宽高和裁剪区域随之改变
+int st7735_set_render_scale(st7735_t *dev, uint8_t scale) {
+    if (!dev || !has_canvas(dev)) return -1;
+    if (scale != 1 && scale != 2 && scale != 4) return -1;
+    if (scale == dev->scale) return 0;
+    // 双缓冲的两个缓冲和滚动终端的行列按当前尺寸分配
+    if (dev->async || dev->console) return -1;
+    
+    unsigned old_scale = dev->scale;
+    uint16_t old_w = dev->width;
+    uint16_t w = dev->width * old_scale / scale;
+    uint16_t h = dev->height * old_scale / scale;
+    size_t bpp = dev->indexbuf ? 1 : sizeof(uint16_t);
+    uint8_t *buf = (uint8_t *)malloc((size_t)w * h * bpp);
+    if (!buf) return -1;
+    
+    const uint8_t *old = dev->indexbuf ? dev->indexbuf : (const uint8_t *)dev->framebuffer;
+    for (unsigned y = 0; y < h; y++) {
+        const uint8_t *src = old + (size_t)(y * scale / old_scale) * old_w * bpp;
+        uint8_t *dst = buf + (size_t)y * w * bpp;
+        for (unsigned x = 0; x < w; x++) {
+            memcpy(dst + x * bpp, src + (x * scale / old_scale) * bpp, bpp);
         }
     }
+    if (dev->indexbuf) {
+        free(dev->indexbuf);
+        dev->indexbuf = buf;
+    } else {
+        free(dev->framebuffer);
+        dev->framebuffer = (uint16_t *)buf;
+    }
+    
+    dev->scale = scale;
+    dev->width = w;
+    dev->height = h;
+    st7735_reset_clip(dev);
+    // 待发送的区域是旧坐标，整屏重发
+    dev->dirty_count = 0;
+    st7735_mark_dirty(dev, 0, 0, w, h);
+    return 0;
 }
 
-// 绘制直线（Bresenham算法）
-void st7735_draw_line(st7735_t *dev, uint16_t x0, uint16_t y0,
-                     uint16_t x1, uint16_t y1, uint16_t color) {
-    if (!dev) return;
+// 发送一个已是线格式的区域：不暂存、不转换，按bufsiz直接从data切块
+static void write_raw_window(st7735_t *dev, const st7735_rect_t *r, uint16_t addr_y,
+                             const uint8_t *data) {
+    uint32_t total = (uint32_t)(r->x1 - r->x0 + 1) * (r->y1 - r->y0 + 1);
+    uint32_t len = total * sizeof(uint16_t);
+    uint32_t first = len < dev->txbuf_size ? len : dev->txbuf_size;
+    struct st7735_io *io = dev->io;
+    
+    io_acquire(io);
+    STATS_ADD(io, rects, 1);
+    STATS_ADD(io, pixels, total);
+    uint64_t t = STATS_NOW();
+    
+    st7735_cmdlist_reset(&io->cmdlist);
+    cmdlist_window(io, r->x0, addr_y, r->x1, addr_y + (r->y1 - r->y0));
+    st7735_cmdlist_data(&io->cmdlist, data, first);
+    st7735_exec(io, ST7735_LIST_WINDOW);
+    
+    for (uint32_t pos = first; pos < len; pos += dev->txbuf_size) {
+        struct spi_ioc_transfer xfer = {
+            .tx_buf = (unsigned long)(data + pos),
+            .len = len - pos < dev->txbuf_size ? len - pos : dev->txbuf_size,
+            .bits_per_word = 8,
+        };
+        spi_sink(io, 1, &xfer, 1);
+        
+        io->list_stats[ST7735_LIST_WINDOW].transfers++;
+        io->list_stats[ST7735_LIST_WINDOW].ioctls++;
+        io->list_stats[ST7735_LIST_WINDOW].bytes += xfer.len;
+    }
+    STATS_LAP(io, transfer_ns, t);
     
-    int dx = abs(x1 - x0);
-    int dy = abs(y1 - y0);
-    int sx = (x0 < x1) ? 1 : -1;
-    int sy = (y0 < y1) ? 1 : -1;
-    int err = dx - dy;
+    io_release(io);
+}
+
+// 直接发送大端RGB565像素（w*h连续存放），绕过framebuffer和脏区域。
+// 屏幕上该区域从此与framebuffer不一致，之后需要由调用者重绘或整屏刷新
+int st7735_write_raw(st7735_t *dev, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                     const void *data) {
+    if (!dev || !dev->io || !data || w == 0 || h == 0) return -1;
+    if (x + w > dev->width || y + h > dev->height) return -1;
+    // RGB444需要重新打包、降分辨率需要放大，只能走framebuffer
+    if (dev->format != ST7735_FORMAT_RGB565 || dev->scale > 1) return -1;
+    
+    // 双缓冲时等后台线程发完，避免旧帧覆盖新内容
+    st7735_wait_flush(dev);
+    
+    st7735_rect_t r = { x, y, x + w - 1, y + h - 1 };
+    uint16_t addr_y = (y + dev->scroll) % dev->height;
+    uint16_t rows_to_end = dev->height - addr_y;
+    
+    if (h <= rows_to_end) {
+        write_raw_window(dev, &r, addr_y, (const uint8_t *)data);
+        return 0;
+    }
     
-    while (1) {
-        st7735_set_pixel(dev, x0, y0, color);
+    st7735_rect_t top = r;
+    st7735_rect_t wrapped = r;
+    top.y1 = y + rows_to_end - 1;
+    wrapped.y0 = top.y1 + 1;
+    write_raw_window(dev, &top, addr_y, (const uint8_t *)data);
+    write_raw_window(dev, &wrapped, 0,
+                     (const uint8_t *)data + (uint32_t)rows_to_end * w * sizeof(uint16_t));
+    return 0;
+}
+
+// ===== 双缓冲异步刷新 =====
+
+struct st7735_async {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint16_t *buffers[2];
+    uint16_t *front;                        // 刷新线程正在发送的缓冲
+    st7735_rect_t dirty[ST7735_MAX_DIRTY];  // 已提交待发送的区域
+    uint8_t dirty_count;
+    bool pending;                           // 有已提交但未开始发送的帧
+    bool busy;                              // 刷新线程正在发送
+    bool stop;
+};
+
+// 刷新线程：独占发送前缓冲，应用线程同时绘制后缓冲
+static void *flush_thread(void *arg) {
+    st7735_t *dev = (st7735_t *)arg;
+    struct st7735_async *a = dev->async;
+    
+    pthread_mutex_lock(&a->lock);
+    for (;;) {
+        while (!a->pending && !a->stop) {
+            pthread_cond_wait(&a->cond, &a->lock);
+        }
+        if (!a->pending && a->stop) break;
         
-        if (x0 == x1 && y0 == y1) break;
+        st7735_rect_t dirty[ST7735_MAX_DIRTY];
+        uint8_t count = a->dirty_count;
+        memcpy(dirty, a->dirty, count * sizeof(st7735_rect_t));
+        a->pending = false;
+        a->busy = true;
+        pthread_mutex_unlock(&a->lock);
         
-        int e2 = 2 * err;
-        if (e2 > -dy) {
-            err -= dy;
-            x0 += sx;
-        }
-        if (e2 < dx) {
-            err += dx;
-            y0 += sy;
+        uint64_t start = STATS_NOW();
+        for (int i = 0; i < count; i++) {
+            st7735_flush_rect(dev, a->front, &dirty[i]);
         }
+        stats_frame_end(dev, start);
+        
+        pthread_mutex_lock(&a->lock);
+        a->busy = false;
+        pthread_cond_broadcast(&a->cond);
     }
+    pthread_mutex_unlock(&a->lock);
+    return NULL;
 }
 
-// 绘制圆形框
-void st7735_draw_circle(st7735_t *dev, uint16_t x0, uint16_t y0,
-                       uint16_t r, uint16_t color) {
-    if (!dev) return;
-    
-    int x = r;
-    int y = 0;
-    int err = 0;
-    
-    while (x >= y) {
-        st7735_set_pixel(dev, x0 + x, y0 + y, color);
-        st7735_set_pixel(dev, x0 + y, y0 + x, color);
-        st7735_set_pixel(dev, x0 - y, y0 + x, color);
-        st7735_set_pixel(dev, x0 - x, y0 + y, color);
-        st7735_set_pixel(dev, x0 - x, y0 - y, color);
-        st7735_set_pixel(dev, x0 - y, y0 - x, color);
-        st7735_set_pixel(dev, x0 + y, y0 - x, color);
-        st7735_set_pixel(dev, x0 + x, y0 - y, color);
-        
-        if (err <= 0) {
-            y += 1;
-            err += 2 * y + 1;
-        }
-        if (err > 0) {
-            x -= 1;
-            err -= 2 * x + 1;
+int st7735_enable_async(st7735_t *dev) {
+    if (!dev || !dev->framebuffer) return -1;
+    if (dev->async) return 0;
+    
+    struct st7735_async *a = (struct st7735_async *)calloc(1, sizeof(*a));
+    if (!a) return -1;
+    
+    size_t size = dev->width * dev->height * sizeof(uint16_t);
+    a->buffers[0] = dev->framebuffer;
+    a->buffers[1] = (uint16_t *)malloc(size);
+    if (!a->buffers[1]) {
+        free(a);
+        return -1;
+    }
+    // 两个缓冲从相同内容开始，之后每次交换只需同步脏区域
+    memcpy(a->buffers[1], a->buffers[0], size);
+    a->front = a->buffers[1];
+    
+    pthread_mutex_init(&a->lock, NULL);
+    pthread_cond_init(&a->cond, NULL);
+    dev->async = a;
+    
+    if (pthread_create(&a->thread, NULL, flush_thread, dev) != 0) {
+        fprintf(stderr, "Error: Failed to start flush thread\n");
+        dev->async = NULL;
+        pthread_cond_destroy(&a->cond);
+        pthread_mutex_destroy(&a->lock);
+        free(a->buffers[1]);
+        free(a);
+        return -1;
+    }
+    return 0;
+}
+
+void st7735_disable_async(st7735_t *dev) {
+    if (!dev || !dev->async) return;
+    
+    struct st7735_async *a = dev->async;
+    
+    pthread_mutex_lock(&a->lock);
+    a->stop = true;
+    pthread_cond_broadcast(&a->cond);
+    pthread_mutex_unlock(&a->lock);
+    pthread_join(a->thread, NULL);
+    
+    // 保留应用正在绘制的缓冲
+    free(dev->framebuffer == a->buffers[0] ? a->buffers[1] : a->buffers[0]);
+    pthread_cond_destroy(&a->cond);
+    pthread_mutex_destroy(&a->lock);
+    free(a);
+    dev->async = NULL;
+}
+
+// 交换前后缓冲并唤醒刷新线程，调用时必须持有a->lock且线程空闲
+static void async_submit(st7735_t *dev) {
+    struct st7735_async *a = dev->async;
+    uint16_t *submitted = dev->framebuffer;
+    uint16_t *back = a->front;
+    
+    stats_render_end(dev);    
+    // 新的后缓冲缺少刚提交这一帧的修改，只补这些区域
+    for (int i = 0; i < dev->dirty_count; i++) {
+        const st7735_rect_t *r = &dev->dirty[i];
+        size_t bytes = (r->x1 - r->x0 + 1) * sizeof(uint16_t);
+        for (uint16_t y = r->y0; y <= r->y1; y++) {
+            size_t offset = y * dev->width + r->x0;
+            memcpy(back + offset, submitted + offset, bytes);
         }
     }
+    
+    memcpy(a->dirty, dev->dirty, dev->dirty_count * sizeof(st7735_rect_t));
+    a->dirty_count = dev->dirty_count;
+    a->front = submitted;
+    a->pending = true;
+    
+    dev->framebuffer = back;
+    dev->dirty_count = 0;
+    pthread_cond_broadcast(&a->cond);
 }
 
-// 填充圆形
-void st7735_fill_circle(st7735_t *dev, uint16_t x0, uint16_t y0,
-                       uint16_t r, uint16_t color) {
-    if (!dev) return;
+// 提交当前帧，上一帧还在发送时等待它完成
+int st7735_update_async(st7735_t *dev) {
+    if (!dev) return -1;
     
-    for (int y = -r; y <= r; y++) {
-        for (int x = -r; x <= r; x++) {
-            if (x * x + y * y <= r * r) {
-                st7735_set_pixel(dev, x0 + x, y0 + y, color);
-            }
+    // 未开启双缓冲时退化为同步刷新
+    if (!dev->async) {
+        st7735_update(dev);
+        return 0;
+    }
+    
+    struct st7735_async *a = dev->async;
+    
+    pthread_mutex_lock(&a->lock);
+    if (a->pending || a->busy) {
+        uint64_t start = STATS_NOW();
+        while (a->pending || a->busy) {
+            pthread_cond_wait(&a->cond, &a->lock);
         }
+        if (dev->io) STATS_ADD(dev->io, wait_ns, STATS_NOW() - start);
+    }
+    if (dev->dirty_count > 0) {
+        async_submit(dev);
     }
+    pthread_mutex_unlock(&a->lock);
+    stats_maybe_dump(dev);
+    return 0;
 }
 
-// 更新显示
-void st7735_update(st7735_t *dev) {
-    if (!dev || !dev->framebuffer) return;
+// 不等待的提交：上一帧未发完时返回1，本帧修改并入下一次提交
+int st7735_try_update_async(st7735_t *dev) {
+    if (!dev) return -1;
+    
+    if (!dev->async) {
+        st7735_update(dev);
+        return 0;
+    }
     
-    // 设置全屏窗口
-    st7735_set_window(dev, 0, 0, dev->width - 1, dev->height - 1);
+    struct st7735_async *a = dev->async;
+    int ret = 0;
     
-    gpio_set_value(ST7735_DC_PIN, 1);
-    gpio_set_value(ST7735_CS_PIN, 0);
+    pthread_mutex_lock(&a->lock);
+    if (a->pending || a->busy) {
+        ret = 1;
+        if (dev->io && dev->dirty_count > 0) STATS_ADD(dev->io, coalesced, 1);
+    } else if (dev->dirty_count > 0) {
+        async_submit(dev);
+    }
+    pthread_mutex_unlock(&a->lock);
+    stats_maybe_dump(dev);
+    return ret;
+}
+
+// 等待所有已提交的帧发送完成
+void st7735_wait_flush(st7735_t *dev) {
+    if (!dev || !dev->async) return;
     
-    // 批量发送framebuffer数据
-    spi_transfer((const uint8_t *)dev->framebuffer, NULL, 
-                 dev->width * dev->height * 2);
+    struct st7735_async *a = dev->async;
     
-    gpio_set_value(ST7735_CS_PIN, 1);
+    pthread_mutex_lock(&a->lock);
+    while (a->pending || a->busy) {
+        pthread_cond_wait(&a->cond, &a->lock);
+    }
+    pthread_mutex_unlock(&a->lock);
 }
 
 // 控制背光
-void st7735_set_backlight(bool state) {
-    gpio_set_value(ST7735_BL_PIN, state ? 1 : 0);
+void st7735_set_backlight(st7735_t *dev, bool state) {
+    if (!dev || !dev->io) return;
+    pthread_mutex_lock(&dev->io->lock);
+    gpio_set_value(dev->io, ST7735_LINE_BL, state ? 1 : 0);
+    pthread_mutex_unlock(&dev->io->lock);
+}
+
+// 查询最近一次执行的命令列表统计
+void st7735_get_list_stats(st7735_t *dev, st7735_list_kind_t kind, st7735_cmdlist_stats_t *stats) {
+    if (!stats || kind >= ST7735_LIST_COUNT) return;
+    if (!dev || !dev->io) {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+    *stats = dev->io->list_stats[kind];
+}
+
+// 热启动：面板已初始化时跳过复位和退出睡眠（st7735_init的默认值）
+void st7735_set_warm_start(bool enable) {
+    warm_start = enable;
+}
+
+// 查询/打印最近一次初始化各阶段耗时
+void st7735_get_init_timing(st7735_t *dev, st7735_init_timing_t *timing) {
+    if (!timing) return;
+    if (!dev || !dev->io) {
+        memset(timing, 0, sizeof(*timing));
+        return;
+    }
+    *timing = dev->io->init_timing;
+}
+
+void st7735_print_init_timing(st7735_t *dev, FILE *fp) {
+    static const char *names[ST7735_PHASE_COUNT] = {
+        [ST7735_PHASE_ALLOC]      = "alloc",
+        [ST7735_PHASE_GPIO]       = "gpio",
+        [ST7735_PHASE_SPI]        = "spi",
+        [ST7735_PHASE_RESET]      = "reset",
+        [ST7735_PHASE_SLEEP_OUT]  = "sleep-out",
+        [ST7735_PHASE_CONFIG]     = "config",
+        [ST7735_PHASE_DISPLAY_ON] = "display-on",
+    };
+    st7735_init_timing_t timing;
+    
+    st7735_get_init_timing(dev, &timing);
+    if (!fp) fp = stdout;
+    fprintf(fp, "ST7735 init (%s start):\n", timing.warm ? "warm" : "cold");
+    for (int phase = 0; phase < ST7735_PHASE_COUNT; phase++) {
+        fprintf(fp, "  %-12s %8.2f ms\n", names[phase], timing.us[phase] / 1000.0);
+    }
+    fprintf(fp, "  %-12s %8.2f ms\n", "total", timing.total_us / 1000.0);
+}
+
+// ===== 运行统计查询 =====
+
+void st7735_get_stats(st7735_t *dev, st7735_stats_t *stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    if (!ST7735_STATS || !dev || !dev->io) return;
+    
+    struct st7735_io *io = dev->io;
+    pthread_mutex_lock(&io->lock);
+    *stats = io->stats;
+    stats->gpio_writes = io->gpio.writes - io->gpio_writes_base;
+    stats->gpio_ns = io->gpio.write_ns - io->gpio_ns_base;
+    pthread_mutex_unlock(&io->lock);
+    stats->elapsed_ns = stats_now() - io->stats_since;
+}
+
+void st7735_reset_stats(st7735_t *dev) {
+    if (!dev || !dev->io) return;
+    
+    struct st7735_io *io = dev->io;
+    pthread_mutex_lock(&io->lock);
+    memset(&io->stats, 0, sizeof(io->stats));
+    io->gpio_writes_base = io->gpio.writes;
+    io->gpio_ns_base = io->gpio.write_ns;
+    io->stats_since = stats_now();
+    pthread_mutex_unlock(&io->lock);
+}
+
+// 按帧平均输出，用于判断瓶颈在绘制、GPIO还是SPI
+void st7735_print_stats(st7735_t *dev, FILE *fp) {
+    st7735_stats_t st;
+    
+    st7735_get_stats(dev, &st);
+    if (!fp) fp = stdout;
+    double seconds = st.elapsed_ns / 1e9;
+    double frames = st.frames ? (double)st.frames : 1.0;
+    
+    fprintf(fp, "ST7735 stats: %llu frames in %.2f s (%.1f fps), dirty %.1f%%, coalesced %llu\n",
+            (unsigned long long)st.frames, seconds, seconds > 0 ? st.frames / seconds : 0.0,
+            st.screen_pixels ? 100.0 * st.pixels / st.screen_pixels : 0.0,
+            (unsigned long long)st.coalesced);
+    fprintf(fp, "  per frame: %.0f bytes, %.1f ioctls, %.1f gpio writes, %.1f rects\n",
+            st.bytes / frames, st.ioctls / frames, st.gpio_writes / frames, st.rects / frames);
+    fprintf(fp, "  per frame (ms): render %.3f  pack %.3f  spi %.3f  gpio %.3f  flush %.3f  wait %.3f\n",
+            st.render_ns / frames / 1e6, st.pack_ns / frames / 1e6,
+            (st.transfer_ns - (st.gpio_ns < st.transfer_ns ? st.gpio_ns : st.transfer_ns)) / frames / 1e6,
+            st.gpio_ns / frames / 1e6, st.flush_ns / frames / 1e6, st.wait_ns / frames / 1e6);
+}
+
+void st7735_set_stats_dump(st7735_t *dev, FILE *fp, uint32_t interval_ms) {
+    if (!dev || !dev->io) return;
+    dev->io->stats_fp = interval_ms ? fp : NULL;
+    dev->io->stats_interval_ns = (uint64_t)interval_ms * 1000000;
+    st7735_reset_stats(dev);
+}
+
+#if ST7735_STATS
+// 在update中检查：到达间隔时输出并清零
+static void stats_maybe_dump(st7735_t *dev) {
+    struct st7735_io *io = dev->io;
+    if (!io || !io->stats_fp) return;
+    if (stats_now() - io->stats_since < io->stats_interval_ns) return;
+    st7735_print_stats(dev, io->stats_fp);
+    st7735_reset_stats(dev);
+}
+#endif
+
+// 选择GPIO后端（st7735_init的默认值）
+void st7735_set_gpio_backend(st7735_gpio_backend_t backend) {
+    gpio_backend = backend;
 }
 
 // RGB888转RGB565
@@ -641,51 +2090,361 @@ static const uint8_t font_8x8[95][8] = {
 };
 
 // 绘制字符
+// 按点阵行的连续段绘制：每段一次矩形填充，透明时跳过背景段
+static void draw_glyph_runs(st7735_t *dev, const uint8_t *char_data, int x, int y,
+                            uint16_t color, uint16_t bg_color, uint8_t size, bool opaque) {
+    for (int j = 0; j < 8; j++) {
+        uint8_t line = char_data[j];
+        int i = 0;
+        while (i < 8) {
+            int on = (line >> (7 - i)) & 1;
+            int start = i;
+            while (i < 8 && (int)((line >> (7 - i)) & 1) == on) i++;
+            if (on || opaque) {
+                raster_rect(dev, x + start * size, y + j * size,
+                            (i - start) * size, size, on ? color : bg_color);
+            }
+        }
+    }
+}
+
+// 绘制一个字形，不记录脏区域
+static void draw_glyph(st7735_t *dev, char ch, int x, int y,
+                       uint16_t color, uint16_t bg_color, uint8_t size) {
+    const uint8_t *char_data = font_8x8[ch - 32];
+    int side = 8 * size;
+    
+    // 整个字形在裁剪区域外时不查缓存也不光栅化
+    if (!clip_overlaps(dev, x, y, x + side - 1, y + side - 1)) return;
+    
+    if (bg_color == color) {
+        // 透明背景：与颜色组合无关，不占用缓存
+        draw_glyph_runs(dev, char_data, x, y, color, bg_color, size, false);
+        return;
+    }
+    if (dev->indexbuf) {
+        // 缓存的是RGB565字形；索引色的矩形填充只是memset，不需要缓存
+        draw_glyph_runs(dev, char_data, x, y, color, bg_color, size, true);
+        return;
+    }
+    
+    if (!dev->glyphs && dev->glyph_budget) {
+        dev->glyphs = st7735_glyph_cache_create(dev->glyph_budget);
+    }
+    const uint16_t *pixels = st7735_glyph_cache_get(dev->glyphs, (uint8_t)ch, char_data,
+                                                    size, color, bg_color);
+    if (pixels) {
+        raster_copy(dev, x, y, side, side, pixels, side);
+    } else {
+        draw_glyph_runs(dev, char_data, x, y, color, bg_color, size, true);
+    }
+}
+
 void st7735_draw_char(st7735_t *dev, char ch, uint16_t x, uint16_t y,
                      uint16_t color, uint16_t bg_color, uint8_t size) {
     if (!dev || ch < 32 || ch > 126) return;
     
-    const uint8_t *char_data = font_8x8[ch - 32];
+    if (!has_canvas(dev) || size == 0) return;
     
-    for (uint8_t j = 0; j < 8; j++) {
-        uint8_t line = char_data[j];
-        for (uint8_t i = 0; i < 8; i++) {
-            if (line & 0x80) {
-                if (size == 1) {
-                    st7735_set_pixel(dev, x + i, y + j, color);
-                } else {
-                    st7735_fill_rect(dev, x + i * size, y + j * size,
-                                    size, size, color);
-                }
-            } else if (bg_color != color) {
-                if (size == 1) {
-                    st7735_set_pixel(dev, x + i, y + j, bg_color);
-                } else {
-                    st7735_fill_rect(dev, x + i * size, y + j * size,
-                                    size, size, bg_color);
-                }
+    draw_glyph(dev, ch, x, y, color, bg_color, size);
+    dirty_add(dev, x, y, x + 8 * size - 1, y + 8 * size - 1);
+}
+
+// 字体中的字形，没有时用'?'代替；都没有时返回NULL
+static const st7735_font_glyph_t *font_glyph(const st7735_font_t *font, uint32_t code,
+                                             const uint8_t **bits) {
+    const st7735_font_glyph_t *g = st7735_font_find(font, code, bits);
+    return g ? g : st7735_font_find(font, '?', bits);
+}
+
+// 字形相对笔位置的水平范围（像素，未放大），返回笔前进量
+static int font_glyph_extent(const st7735_font_t *font, const st7735_font_glyph_t *g,
+                             int *x0, int *x1) {
+    if (!g) {
+        // 连问号都没有：留半个行高的空白
+        *x0 = 0;
+        *x1 = -1;
+        return st7735_font_height(font) / 2;
+    }
+    *x0 = g->left < 0 ? g->left : 0;
+    *x1 = (g->left + g->width > g->advance ? g->left + g->width : g->advance) - 1;
+    return g->advance;
+}
+
+// 绘制字体文件中的字形：按位图行的连续段填充，不透明时先填满advance x height的背景。
+// 整个字形在裁剪区域外时不读位图，映射中的页不会被换入
+static void draw_font_glyph(st7735_t *dev, const st7735_font_glyph_t *g, const uint8_t *bits,
+                            int x, int y, uint16_t color, uint16_t bg_color, uint8_t size) {
+    int height = st7735_font_height(dev->font);
+    int x0, x1;
+    font_glyph_extent(dev->font, g, &x0, &x1);
+    if (!g || !clip_overlaps(dev, x + x0 * size, y, x + (x1 + 1) * size - 1,
+                             y + height * size - 1)) return;
+    
+    if (bg_color != color) raster_rect(dev, x, y, g->advance * size, height * size, bg_color);
+    
+    int stride = (g->width + 7) / 8;
+    int gx = x + g->left * size;
+    for (int j = 0; j < height; j++, bits += stride) {
+        int i = 0;
+        while (i < g->width) {
+            // 整字节空白直接跳过
+            if ((i & 7) == 0 && bits[i >> 3] == 0) {
+                i += 8;
+                continue;
             }
-            line <<= 1;
+            if (!(bits[i >> 3] & (0x80 >> (i & 7)))) {
+                i++;
+                continue;
+            }
+            int start = i;
+            while (i < g->width && (bits[i >> 3] & (0x80 >> (i & 7)))) i++;
+            raster_rect(dev, gx + start * size, y + j * size, (i - start) * size, size, color);
         }
     }
 }
 
-// 绘制字符串
+// 绘制字符串，整串只记录一个脏区域
 void st7735_draw_string(st7735_t *dev, const char *str, uint16_t x, uint16_t y,
                        uint16_t color, uint16_t bg_color, uint8_t size) {
     if (!dev || !str) return;
     
-    uint16_t cursor_x = x;
-    uint16_t cursor_y = y;
+    if (!has_canvas(dev) || size == 0) return;
+    
+    const st7735_font_t *font = dev->font;
+    int side = 8 * size;
+    int line_h = font ? st7735_font_height(font) * size : side;
+    int cursor_x = x;
+    int cursor_y = y;
+    int min_x = x;
+    int max_x = -1;
+    int max_y = -1;
     
     while (*str) {
-        if (*str == '\n') {
+        uint32_t code = st7735_utf8_next(&str);
+        if (code == '\n') {
             cursor_x = x;
-            cursor_y += 8 * size;
+            cursor_y += line_h;
+        } else if (font) {
+            const uint8_t *bits = NULL;
+            const st7735_font_glyph_t *g = font_glyph(font, code, &bits);
+            int x0, x1;
+            int advance = font_glyph_extent(font, g, &x0, &x1);
+            if (x0 <= x1) {
+                draw_font_glyph(dev, g, bits, cursor_x, cursor_y, color, bg_color, size);
+                if (cursor_x + x0 * size < min_x) min_x = cursor_x + x0 * size;
+                if (cursor_x + (x1 + 1) * size - 1 > max_x) max_x = cursor_x + (x1 + 1) * size - 1;
+                max_y = cursor_y + line_h - 1;
+            }
+            cursor_x += advance * size;
+        } else {
+            if (code >= 32 && code <= 126) {
+                draw_glyph(dev, (char)code, cursor_x, cursor_y, color, bg_color, size);
+                if (cursor_x + side - 1 > max_x) max_x = cursor_x + side - 1;
+                max_y = cursor_y + side - 1;
+            }
+            cursor_x += side;
+        }
+    }
+    
+    if (max_x >= 0) dirty_add(dev, min_x, y, max_x, max_y);
+}
+
+// 与st7735_draw_string相同的排版，只计算范围
+void st7735_measure_string(st7735_t *dev, const char *str, uint8_t size,
+                           int *x0, int *x1, int *height) {
+    const st7735_font_t *font = dev ? dev->font : NULL;
+    int line_h = (font ? st7735_font_height(font) : 8) * size;
+    int cursor_x = 0;
+    int lines = 1;
+    int min_x = 0;
+    int max_x = -1;
+    
+    while (str && *str) {
+        uint32_t code = st7735_utf8_next(&str);
+        if (code == '\n') {
+            cursor_x = 0;
+            lines++;
+        } else if (font) {
+            const uint8_t *bits;
+            int g0, g1;
+            int advance = font_glyph_extent(font, font_glyph(font, code, &bits), &g0, &g1);
+            if (g0 <= g1) {
+                if (cursor_x + g0 * size < min_x) min_x = cursor_x + g0 * size;
+                if (cursor_x + (g1 + 1) * size - 1 > max_x) max_x = cursor_x + (g1 + 1) * size - 1;
+            }
+            cursor_x += advance * size;
         } else {
-            st7735_draw_char(dev, *str, cursor_x, cursor_y, color, bg_color, size);
+            // 内置字体中不可显示的字符也占一格
             cursor_x += 8 * size;
+            if (cursor_x - 1 > max_x) max_x = cursor_x - 1;
+        }
+    }
+    
+    if (x0) *x0 = min_x;
+    if (x1) *x1 = max_x;
+    if (height) *height = lines * line_h;
+}
+
+void st7735_set_font(st7735_t *dev, const st7735_font_t *font) {
+    if (dev) dev->font = font;
+}
+
+void st7735_set_glyph_cache(st7735_t *dev, uint32_t budget) {
+    if (!dev) return;
+    st7735_glyph_cache_destroy(dev->glyphs);
+    dev->glyphs = NULL;
+    dev->glyph_budget = budget;
+}
+
+void st7735_get_glyph_stats(st7735_t *dev, st7735_glyph_stats_t *stats) {
+    st7735_glyph_cache_stats(dev ? dev->glyphs : NULL, stats);
+}
+
+// ===== 滚动终端 =====
+
+struct st7735_console {
+    uint16_t color;
+    uint16_t bg_color;
+    uint8_t size;
+    int cols, rows;         // 字符行列数
+    int col, row;           // 光标位置
+    bool hw_scroll;         // 竖屏时使用VSCSAD硬件滚动
+    bool scroll_pending;    // 最后一行已换行，等待下一个字符
+};
+
+// 设置滚动起始行。MADCTL的MY位决定显存行与扫描方向的关系
+static void send_scroll_start(st7735_t *dev) {
+    uint16_t ssa = dev->scroll;
+    if (dev->rotation == ST7735_ROTATION_0 && ssa) {
+        ssa = dev->height - ssa;
+    }
+    if (!dev->io) return;
+    // 滚动区从显存第row_offset行开始
+    ssa += dev->io->row_offset;
+    const uint8_t params[2] = { ssa >> 8, ssa & 0xFF };
+    
+    st7735_cmdlist_reset(&dev->io->cmdlist);
+    st7735_cmdlist_cmd(&dev->io->cmdlist, ST7735_VSCSAD, params, sizeof(params));
+    st7735_run(dev->io, ST7735_LIST_SCROLL);
+}
+
+// framebuffer内容上移lines行，底部露出的行清为背景色
+static void shift_up(st7735_t *dev, uint16_t *fb, int lines) {
+    size_t keep = (size_t)(dev->height - lines) * dev->width;
+    memmove(fb, fb + (size_t)lines * dev->width, keep * sizeof(uint16_t));
+}
+
+static void console_scroll(st7735_t *dev) {
+    struct st7735_console *c = dev->console;
+    int lines = 8 * c->size;
+    
+    if (c->hw_scroll) {
+        // 先按旧的行映射发完已有修改，之后两个缓冲与显存一致
+        st7735_update(dev);
+        
+        shift_up(dev, dev->framebuffer, lines);
+        if (dev->async) {
+            // 刷新线程此时空闲，前缓冲同步移动，保持与后缓冲一致
+            shift_up(dev, dev->async->front, lines);
+        }
+        dev->scroll = (dev->scroll + lines) % dev->height;
+        send_scroll_start(dev);
+        
+        // 只有底部露出的一行需要发送
+        raster_rect(dev, 0, dev->height - lines, dev->width, lines, c->bg_color);
+        dirty_add(dev, 0, dev->height - lines, dev->width - 1, dev->height - 1);
+    } else {
+        shift_up(dev, dev->framebuffer, lines);
+        raster_rect(dev, 0, dev->height - lines, dev->width, lines, c->bg_color);
+        dirty_add(dev, 0, 0, dev->width - 1, dev->height - 1);
+    }
+}
+
+int st7735_console_begin(st7735_t *dev, uint16_t color, uint16_t bg_color, uint8_t size) {
+    if (!dev || !dev->framebuffer || size == 0) return -1;
+    if (8 * size > dev->height || 8 * size > dev->width) return -1;
+    
+    st7735_console_end(dev);
+    // 终端占用整屏，按屏幕坐标绘制
+    st7735_reset_clip(dev);
+    
+    struct st7735_console *c = (struct st7735_console *)calloc(1, sizeof(*c));
+    if (!c) return -1;
+    
+    c->color = color;
+    c->bg_color = bg_color;
+    c->size = size;
+    c->cols = dev->width / (8 * size);
+    c->rows = dev->height / (8 * size);
+    // 硬件只能沿面板长边滚动，横屏时该方向是水平的；降分辨率时一行字对应scale倍的显存行，整屏重绘
+    c->hw_scroll = (dev->rotation == ST7735_ROTATION_0 ||
+                    dev->rotation == ST7735_ROTATION_180) && dev->scale == 1;
+    dev->console = c;
+    
+    st7735_clear(dev, bg_color);
+    return 0;
+}
+
+void st7735_console_end(st7735_t *dev) {
+    if (!dev || !dev->console) return;
+    
+    free(dev->console);
+    dev->console = NULL;
+    if (dev->scroll == 0) return;
+    
+    // 恢复不滚动的行映射，显存内容需要整屏重发
+    st7735_update(dev);
+    dev->scroll = 0;
+    send_scroll_start(dev);
+    st7735_update_full(dev);
+}
+
+void st7735_console_write(st7735_t *dev, const char *text) {
+    if (!dev || !dev->console || !text) return;
+    
+    struct st7735_console *c = dev->console;
+    int cell = 8 * c->size;
+    
+    for (; *text; text++) {
+        char ch = *text;
+        
+        if (ch == '\r') {
+            c->col = 0;
+            continue;
+        }
+        if (ch == '\n' || c->col >= c->cols) {
+            // 连续换行：先完成上一次推迟的滚动，空行不能合并
+            if (c->scroll_pending) {
+                console_scroll(dev);
+                c->scroll_pending = false;
+            }
+            c->col = 0;
+            if (c->row + 1 < c->rows) {
+                c->row++;
+            } else {
+                // 推迟到下一个字符再滚动，新行的清除和文字一起发送
+                c->scroll_pending = true;
+            }
+            if (ch == '\n') continue;
+        }
+        
+        if (c->scroll_pending) {
+            console_scroll(dev);
+            c->scroll_pending = false;
         }
-        str++;
+        st7735_draw_char(dev, ch, c->col * cell, c->row * cell, c->color, c->bg_color, c->size);
+        c->col++;
     }
-}
\ No newline at end of file
+}
+
+void st7735_console_printf(st7735_t *dev, const char *fmt, ...) {
+    char buffer[256];
+    va_list args;
+    
+    va_start(args, fmt);
+    vsnprintf(buffer, sizeof(buffer), fmt, args);
+    va_end(args);
+    
+    st7735_console_write(dev, buffer);
+}
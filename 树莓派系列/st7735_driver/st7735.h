@@ -3,6 +3,11 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdio.h>
+#include "st7735_gpio.h"
+#include "st7735_cmdlist.h"
+#include "st7735_glyph.h"
+#include "st7735_font.h"
 
 // 显示屏尺寸（横屏）
 #define ST7735_WIDTH    160
@@ -18,6 +23,14 @@
 #define ST7735_YELLOW   0xFFE0
 #define ST7735_WHITE    0xFFFF
 
+// 脏矩形列表容量，超过后合并代价最小的两个
+#define ST7735_MAX_DIRTY    8
+// 合并两个脏矩形时允许多发送的像素数（换取少一次窗口设置）
+#define ST7735_DIRTY_SLACK  256
+
+// 裁剪栈深度（嵌套的视口/裁剪区域层数）
+#define ST7735_CLIP_DEPTH   8
+
 // 旋转方向
 typedef enum {
     ST7735_ROTATION_0 = 0,
@@ -26,16 +39,144 @@ typedef enum {
     ST7735_ROTATION_270
 } st7735_rotation_t;
 
+// 线上像素格式（framebuffer始终为RGB565，发送时转换）
+typedef enum {
+    ST7735_FORMAT_RGB565 = 0,       // COLMOD 05h，每像素2字节
+    ST7735_FORMAT_RGB444,           // COLMOD 03h，每两像素3字节，少25%
+    ST7735_FORMAT_RGB444_DITHER     // 同上，加4x4有序抖动减轻渐变色带
+} st7735_pixel_format_t;
+
+// framebuffer像素格式
+typedef enum {
+    ST7735_COLOR_RGB565 = 0,        // 每像素2字节，绘图函数的颜色为RGB565
+    ST7735_COLOR_INDEXED8           // 每像素1字节调色板索引，颜色参数取低8位，发送时查表
+} st7735_color_mode_t;
+
+// 命令列表种类（用于查询批量发送统计）
+typedef enum {
+    ST7735_LIST_INIT = 0,       // 初始化/关闭序列
+    ST7735_LIST_WINDOW,         // 窗口设置 + RAMWR + 像素数据
+    ST7735_LIST_ROTATION,       // MADCTL
+    ST7735_LIST_SCROLL,         // VSCSAD
+    ST7735_LIST_FORMAT,         // COLMOD
+    ST7735_LIST_COUNT
+} st7735_list_kind_t;
+
+// 初始化阶段（用于启动耗时统计）
+typedef enum {
+    ST7735_PHASE_ALLOC = 0,     // 分配缓冲
+    ST7735_PHASE_GPIO,          // 申请控制线
+    ST7735_PHASE_SPI,           // 打开并配置spidev
+    ST7735_PHASE_RESET,         // 硬件/软件复位
+    ST7735_PHASE_SLEEP_OUT,     // 退出睡眠
+    ST7735_PHASE_CONFIG,        // 寄存器配置
+    ST7735_PHASE_DISPLAY_ON,    // 开启显示
+    ST7735_PHASE_COUNT
+} st7735_init_phase_t;
+
+typedef struct {
+    uint32_t us[ST7735_PHASE_COUNT];
+    uint32_t total_us;
+    bool warm;                  // 是否走了热启动路径
+} st7735_init_timing_t;
+
+// 运行统计：自上次清零以来的累计值，时间单位ns。
+// 编译时-DST7735_STATS=0去掉全部计数，查询结果恒为0
+typedef struct {
+    uint64_t elapsed_ns;        // 距上次清零的时间
+    uint64_t frames;            // 实际发送的帧数
+    uint64_t rects;             // 发送的窗口数
+    uint64_t pixels;            // 发送的像素数
+    uint64_t screen_pixels;     // 各帧整屏像素数之和（pixels/screen_pixels为脏区域比例）
+    uint64_t bytes;             // 线上字节数（含命令）
+    uint64_t ioctls;            // SPI_IOC_MESSAGE次数
+    uint64_t gpio_writes;       // GPIO写操作（系统调用）次数
+    uint64_t render_ns;         // 每帧从第一次绘制到提交刷新（含应用自身的计算）
+    uint64_t pack_ns;           // 像素转换为线格式
+    uint64_t transfer_ns;       // 命令和像素的发送（含GPIO切换）
+    uint64_t gpio_ns;           // 其中GPIO写操作
+    uint64_t flush_ns;          // 刷新总时间（含等待总线）
+    uint64_t wait_ns;           // 异步提交时等待上一帧发完
+    uint64_t coalesced;         // 异步提交时上一帧未发完，修改并入下一帧的次数
+} st7735_stats_t;
+
+// 矩形区域（闭区间坐标）
+typedef struct {
+    uint16_t x0, y0;
+    uint16_t x1, y1;
+} st7735_rect_t;
+
+// 裁剪区域：屏幕坐标的半开区间[x0, x1) x [y0, y1)，加上视口原点(ox, oy)。
+// 绘图函数的坐标都相对视口原点，只写入裁剪区域内的像素
+typedef struct {
+    int16_t x0, y0;
+    int16_t x1, y1;
+    int16_t ox, oy;
+} st7735_clip_t;
+
+// 传输接口：替换spidev，用于无硬件的测试、性能测量和模拟器。
+// transfer与命令列表的sink相同：发送一组DC相同的传输，失败返回<0
+typedef struct {
+    st7735_cmdlist_sink_t transfer;
+    void *ctx;
+    uint32_t max_transfer;              // 单次传输的字节上限，0为spidev默认值
+} st7735_transport_t;
+
+// 面板连接配置：每块屏各自的SPI设备、控制线和显存偏移
+typedef struct {
+    const char *spi_device;             // 如"/dev/spidev0.1"
+    uint32_t spi_speed_hz;
+    const char *gpio_chip;              // NULL为/dev/gpiochip0
+    st7735_gpio_backend_t gpio_backend;
+    int rst_pin;                        // BCM编号，-1表示未连接
+    int dc_pin;
+    int cs_pin;                         // -1使用spidev硬件片选
+    int bl_pin;
+    uint8_t col_offset;                 // 竖屏方向的显存偏移（不同批次的面板不同）
+    uint8_t row_offset;
+    uint16_t gram_height;               // 显存行数（GM引脚决定，160或162）；0时有偏移按162，否则160
+    st7735_rotation_t rotation;
+    bool warm_start;
+    const st7735_transport_t *transport;    // 非NULL时不打开spi_device
+} st7735_config_t;
+
+// SPI/GPIO句柄和命令列表（内部使用）
+struct st7735_io;
+// 双缓冲异步刷新状态（内部使用）
+struct st7735_async;
+// 滚动终端状态（内部使用）
+struct st7735_console;
+
 // ST7735设备结构体
 typedef struct {
     uint16_t width;
     uint16_t height;
     st7735_rotation_t rotation;
     uint16_t *framebuffer;
+    uint8_t *txbuf;                          // 发送缓冲（转换为线格式后的像素）
+    uint32_t txbuf_size;                     // 单次发送的字节上限，不超过spidev的bufsiz
+    st7735_pixel_format_t format;            // 线上像素格式
+    st7735_rect_t dirty[ST7735_MAX_DIRTY];   // 自上次刷新以来修改过的区域
+    uint8_t dirty_count;
+    struct st7735_async *async;              // 非NULL时为双缓冲异步刷新模式
+    st7735_glyph_cache_t *glyphs;            // 字形缓存，首次绘制文本时创建
+    uint32_t glyph_budget;                   // 字形缓存字节预算，0表示不缓存
+    const st7735_font_t *font;               // 非NULL时文本用该字体文件绘制
+    uint16_t scroll;                         // 硬件滚动偏移：framebuffer第y行位于显存第(y+scroll)%height行
+    struct st7735_console *console;          // 非NULL时为滚动终端模式
+    struct st7735_io *io;                    // NULL表示无硬件（只绘制到framebuffer）
+    st7735_clip_t clip;                      // 当前裁剪区域和视口原点
+    st7735_clip_t clip_stack[ST7735_CLIP_DEPTH];
+    uint8_t clip_depth;
+    uint8_t *indexbuf;                       // 索引色模式的framebuffer（此时framebuffer为NULL）
+    uint16_t palette[256];                   // 索引色模式的调色板（RGB565）
+    uint8_t scale;                           // 渲染缩放：宽高为面板的1/scale，刷新时每像素复制成scale x scale
 } st7735_t;
 
 // 初始化函数
-int st7735_init(st7735_t *dev, st7735_rotation_t rotation);
+void st7735_config_default(st7735_config_t *config);
+int st7735_init_config(st7735_t *dev, const st7735_config_t *config);
+int st7735_init(st7735_t *dev, st7735_rotation_t rotation);   // 默认配置（CE0）
 void st7735_deinit(st7735_t *dev);
 
 // 基本绘图函数
@@ -46,19 +187,90 @@ void st7735_fill_rect(st7735_t *dev, uint16_t x, uint16_t y, uint16_t w, uint16_
 void st7735_draw_line(st7735_t *dev, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color);
 void st7735_draw_circle(st7735_t *dev, uint16_t x0, uint16_t y0, uint16_t r, uint16_t color);
 void st7735_fill_circle(st7735_t *dev, uint16_t x0, uint16_t y0, uint16_t r, uint16_t color);
+void st7735_draw_hline(st7735_t *dev, uint16_t x, uint16_t y, uint16_t w, uint16_t color);
+void st7735_draw_vline(st7735_t *dev, uint16_t x, uint16_t y, uint16_t h, uint16_t color);
+void st7735_draw_round_rect(st7735_t *dev, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                            uint16_t r, uint16_t color);
+void st7735_fill_round_rect(st7735_t *dev, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                            uint16_t r, uint16_t color);
 
 // 显示控制
-void st7735_update(st7735_t *dev);
-void st7735_set_backlight(bool state);
+void st7735_update(st7735_t *dev);          // 只发送脏区域
+void st7735_update_full(st7735_t *dev);     // 强制整屏刷新
+void st7735_mark_dirty(st7735_t *dev, uint16_t x, uint16_t y, uint16_t w, uint16_t h);   // 屏幕坐标
+// 直接发送大端RGB565像素（w*h连续），不经过framebuffer；仅RGB565线格式和全分辨率，失败返回-1
+int st7735_write_raw(st7735_t *dev, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                     const void *data);
+
+// 裁剪与视口：新区域与当前区域求交后压栈，坐标相对当前视口；栈满返回-1。
+// 图元只与裁剪区域求交一次，内层循环不再逐点检查。st7735_clear只清除裁剪区域
+int st7735_push_clip(st7735_t *dev, int x, int y, int w, int h);
+int st7735_push_viewport(st7735_t *dev, int x, int y, int w, int h);   // 同时把原点移到(x, y)
+void st7735_pop_clip(st7735_t *dev);
+void st7735_reset_clip(st7735_t *dev);                                // 清空栈，恢复整屏
+
+// 索引色模式：framebuffer换成每像素1字节的索引，面板缓冲减半，刷新时查调色板展开。
+// 位图、图片、视频、双缓冲和滚动终端只支持RGB565模式（异步或终端模式下不能切换）。
+// 切换到索引色时内容按RGB332量化（默认调色板即RGB332），切回时查表展开
+int st7735_set_color_mode(st7735_t *dev, st7735_color_mode_t mode);
+// 修改调色板中[first, first + count)项；有变化时整屏标记为脏，不需要重绘
+void st7735_set_palette(st7735_t *dev, uint8_t first, uint16_t count, const uint16_t *colors);
+void st7735_default_palette(uint16_t palette[256]);                      // RGB332
+uint8_t st7735_color_index(uint8_t r, uint8_t g, uint8_t b);            // RGB332索引
+
+// 降分辨率渲染：scale为2或4时framebuffer（或索引色缓冲）只有面板的1/scale宽高，
+// dev->width/height和绘图坐标都按缩小后的尺寸（横屏2倍时80x64），光栅化和内存减少为1/4或1/16；
+// 刷新时在发送循环中把每个像素复制成scale x scale，不生成全尺寸缓冲。1恢复全分辨率。
+// 切换时内容按最近邻重采样并整屏重发；双缓冲或滚动终端模式下不能切换。
+// 缩小时滚动终端改为整屏重绘，st7735_write_raw和视频播放不可用
+int st7735_set_render_scale(st7735_t *dev, uint8_t scale);
+
+// 双缓冲异步刷新：后台线程发送前缓冲，应用继续在framebuffer（后缓冲）上绘制
+int st7735_enable_async(st7735_t *dev);
+void st7735_disable_async(st7735_t *dev);
+int st7735_update_async(st7735_t *dev);      // 交换缓冲，上一帧未发完时等待
+int st7735_try_update_async(st7735_t *dev);  // 不等待，忙时返回1并把修改并入下一帧
+void st7735_wait_flush(st7735_t *dev);       // 等待已提交的帧发送完成
+void st7735_set_backlight(st7735_t *dev, bool state);
 void st7735_set_rotation(st7735_t *dev, st7735_rotation_t rotation);
+void st7735_set_pixel_format(st7735_t *dev, st7735_pixel_format_t format);
 
 // 文本绘制
 void st7735_draw_char(st7735_t *dev, char ch, uint16_t x, uint16_t y, 
                       uint16_t color, uint16_t bg_color, uint8_t size);
 void st7735_draw_string(st7735_t *dev, const char *str, uint16_t x, uint16_t y,
                        uint16_t color, uint16_t bg_color, uint8_t size);
+// bg_color与color相同时背景透明；不透明字形走缓存。
+// 字符串按UTF-8解码；内置8x8字体只有ASCII，其余字符留空一格
+void st7735_set_glyph_cache(st7735_t *dev, uint32_t budget);   // 0关闭缓存
+void st7735_get_glyph_stats(st7735_t *dev, st7735_glyph_stats_t *stats);
+// 设置点阵字体（st7735_font_open打开，须在使用期间保持打开），NULL恢复内置8x8字体。
+// 字体中没有的字符画成'?'。st7735_draw_char和滚动终端始终使用内置字体
+void st7735_set_font(st7735_t *dev, const st7735_font_t *font);
+// 文本相对起点(x, y)的水平范围[*x0, *x1]（字形可能向左伸出，*x0可为负）和高度，空串时*x1 < *x0
+void st7735_measure_string(st7735_t *dev, const char *str, uint8_t size,
+                           int *x0, int *x1, int *height);
+
+// 滚动终端：换行时用VSCSAD移动显存起始行，只发送新露出的一行字符。
+// 仅竖屏（0/180度）可用硬件滚动，横屏时退化为整屏重绘
+int st7735_console_begin(st7735_t *dev, uint16_t color, uint16_t bg_color, uint8_t size);
+void st7735_console_end(st7735_t *dev);
+void st7735_console_write(st7735_t *dev, const char *text);
+void st7735_console_printf(st7735_t *dev, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
 
 // 工具函数
+void st7735_set_gpio_backend(st7735_gpio_backend_t backend);   // st7735_init的默认值
+void st7735_set_warm_start(bool enable);                        // st7735_init的默认值
+void st7735_get_init_timing(st7735_t *dev, st7735_init_timing_t *timing);
+void st7735_print_init_timing(st7735_t *dev, FILE *fp);
+void st7735_get_list_stats(st7735_t *dev, st7735_list_kind_t kind, st7735_cmdlist_stats_t *stats);
 uint16_t st7735_color_rgb(uint8_t r, uint8_t g, uint8_t b);
 
+// 运行统计；定期输出时在update中检查间隔，输出后清零
+void st7735_get_stats(st7735_t *dev, st7735_stats_t *stats);
+void st7735_reset_stats(st7735_t *dev);
+void st7735_print_stats(st7735_t *dev, FILE *fp);
+void st7735_set_stats_dump(st7735_t *dev, FILE *fp, uint32_t interval_ms);   // fp为NULL关闭
+
 #endif // ST7735_H
\ No newline at end of file
@@ -0,0 +1,285 @@
+// bdf2font：把BDF点阵字体转换成st7735_font_open使用的.s7f文件。
+// 每个字形按字体的ascent/descent放进同高的单元格，只保存BBX宽度的列；
+// 可以只保留GB2312中的字符（用iconv判断）或指定码点范围，减小文件
+#include "st7735_font.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <getopt.h>
+#include <iconv.h>
+
+#define LINE_MAX_LEN    1024
+#define MAX_RANGES      16
+
+typedef struct {
+    uint32_t code;
+    uint8_t width;
+    int8_t left;
+    uint8_t advance;
+    uint32_t offset;            // 在bitmaps中的偏移
+} glyph_t;
+
+typedef struct {
+    glyph_t *glyphs;
+    uint32_t count;
+    size_t capacity;
+    uint8_t *bitmaps;
+    size_t bitmap_size;
+    size_t bitmap_capacity;
+} font_t;
+
+typedef struct {
+    uint32_t first, last;
+} range_t;
+
+static range_t ranges[MAX_RANGES];
+static int range_count;
+static iconv_t gb2312 = (iconv_t)-1;
+
+// 码点是否在GB2312中：ASCII总是保留，其余看iconv能否转换
+static bool in_gb2312(uint32_t code) {
+    if (code < 0x80) return true;
+    
+    char in[4] = { code & 0xFF, (code >> 8) & 0xFF, (code >> 16) & 0xFF, code >> 24 };
+    char out[8];
+    char *ip = in, *op = out;
+    size_t il = sizeof(in), ol = sizeof(out);
+    iconv(gb2312, NULL, NULL, NULL, NULL);
+    return iconv(gb2312, &ip, &il, &op, &ol) != (size_t)-1;
+}
+
+static bool wanted(uint32_t code) {
+    if (gb2312 != (iconv_t)-1 && !in_gb2312(code)) return false;
+    if (range_count == 0) return true;
+    for (int i = 0; i < range_count; i++) {
+        if (code >= ranges[i].first && code <= ranges[i].last) return true;
+    }
+    return false;
+}
+
+static void *grow(void *p, size_t *capacity, size_t need, size_t item) {
+    if (need <= *capacity) return p;
+    size_t n = *capacity ? *capacity : 256;
+    while (n < need) n *= 2;
+    void *q = realloc(p, n * item);
+    if (!q) {
+        fprintf(stderr, "Error: Out of memory\n");
+        exit(1);
+    }
+    *capacity = n;
+    return q;
+}
+
+static int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// 读入BDF，字形位图放进height行高的单元格，基线在第ascent行
+static int read_bdf(FILE *fp, font_t *font, int *height, int *ascent) {
+    char line[LINE_MAX_LEN];
+    int font_ascent = -1, font_descent = -1;
+    int bbx_h = 0, bbx_yoff = 0;
+    // 当前字形
+    long code = -1;
+    int dwidth = 0, w = 0, h = 0, xoff = 0, yoff = 0;
+    int row = -1;
+    uint8_t *cell = NULL;
+    
+    while (fgets(line, sizeof(line), fp)) {
+        if (row >= 0) {
+            if (strncmp(line, "ENDCHAR", 7) == 0) {
+                // 保留的字形追加到位图区
+                if (code >= 0 && w <= 255 && wanted((uint32_t)code)) {
+                    size_t stride = (w + 7) / 8;
+                    size_t bytes = (size_t)*height * stride;
+                    font->glyphs = grow(font->glyphs, &font->capacity, font->count + 1, sizeof(glyph_t));
+                    font->bitmaps = grow(font->bitmaps, &font->bitmap_capacity,
+                                         font->bitmap_size + bytes, 1);
+                    glyph_t *g = &font->glyphs[font->count++];
+                    g->code = (uint32_t)code;
+                    g->width = (uint8_t)w;
+                    g->left = (int8_t)(xoff < -128 ? -128 : xoff > 127 ? 127 : xoff);
+                    g->advance = (uint8_t)(dwidth < 0 ? 0 : dwidth > 255 ? 255 : dwidth);
+                    g->offset = (uint32_t)font->bitmap_size;
+                    memcpy(font->bitmaps + font->bitmap_size, cell, bytes);
+                    font->bitmap_size += bytes;
+                }
+                row = -1;
+                code = -1;
+                continue;
+            }
+            // 位图行：放到单元格中对应的行，超出单元格的部分丢弃
+            int y = *ascent - (yoff + h) + row++;
+            size_t stride = (w + 7) / 8;
+            if (y < 0 || y >= *height || w > 255) continue;
+            for (size_t i = 0; i < stride; i++) {
+                int hi = hex_digit(line[2 * i]), lo = hex_digit(line[2 * i + 1]);
+                if (hi < 0 || lo < 0) break;
+                cell[y * stride + i] = (uint8_t)(hi << 4 | lo);
+            }
+            continue;
+        }
+        
+        if (sscanf(line, "FONT_ASCENT %d", &font_ascent) == 1) continue;
+        if (sscanf(line, "FONT_DESCENT %d", &font_descent) == 1) continue;
+        if (sscanf(line, "FONTBOUNDINGBOX %*d %d %*d %d", &bbx_h, &bbx_yoff) == 2) continue;
+        if (sscanf(line, "ENCODING %ld", &code) == 1) continue;
+        if (sscanf(line, "DWIDTH %d", &dwidth) == 1) continue;
+        if (sscanf(line, "BBX %d %d %d %d", &w, &h, &xoff, &yoff) == 4) continue;
+        if (strncmp(line, "STARTCHAR", 9) == 0) {
+            code = -1;
+            dwidth = w = h = xoff = yoff = 0;
+            continue;
+        }
+        if (strncmp(line, "BITMAP", 6) == 0) {
+            // 第一个字形之前确定单元格尺寸
+            if (*height == 0) {
+                if (font_ascent < 0 || font_descent < 0) {
+                    font_ascent = bbx_h + bbx_yoff;
+                    font_descent = -bbx_yoff;
+                }
+                *ascent = font_ascent;
+                *height = font_ascent + font_descent;
+                if (*height <= 0 || *height > 255) {
+                    fprintf(stderr, "Error: Unsupported font height %d\n", *height);
+                    free(cell);
+                    return -1;
+                }
+                cell = (uint8_t *)malloc((size_t)*height * 32);
+            }
+            memset(cell, 0, (size_t)*height * 32);
+            row = 0;
+        }
+    }
+    
+    free(cell);
+    return *height > 0 ? 0 : -1;
+}
+
+static int compare_code(const void *a, const void *b) {
+    uint32_t x = ((const glyph_t *)a)->code, y = ((const glyph_t *)b)->code;
+    return x < y ? -1 : x > y;
+}
+
+static int write_font(const char *path, font_t *font, int height, int ascent) {
+    // 按码点排序，重复的只保留第一个
+    qsort(font->glyphs, font->count, sizeof(glyph_t), compare_code);
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < font->count; i++) {
+        if (n == 0 || font->glyphs[i].code != font->glyphs[n - 1].code) {
+            font->glyphs[n++] = font->glyphs[i];
+        }
+    }
+    font->count = n;
+    
+    st7735_font_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, ST7735_FONT_MAGIC, sizeof(header.magic));
+    header.height = (uint16_t)height;
+    header.ascent = (uint16_t)ascent;
+    header.count = n;
+    header.bitmap_offset = sizeof(header) + n * sizeof(st7735_font_glyph_t);
+    // block[b]：第一个码点不小于b << 8的字形
+    uint32_t k = 0;
+    for (uint32_t b = 0; b <= 256; b++) {
+        while (k < n && font->glyphs[k].code < (b << 8)) k++;
+        header.block[b] = k;
+    }
+    
+    FILE *fp = fopen(path, "wb");
+    if (!fp) {
+        fprintf(stderr, "Error: Failed to create %s\n", path);
+        return -1;
+    }
+    fwrite(&header, sizeof(header), 1, fp);
+    
+    // 位图按排序后的顺序重新排列，相邻码点的字形在文件中也相邻
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        const glyph_t *g = &font->glyphs[i];
+        st7735_font_glyph_t entry = {
+            .code = g->code, .offset = offset, .width = g->width,
+            .left = g->left, .advance = g->advance,
+        };
+        fwrite(&entry, sizeof(entry), 1, fp);
+        offset += height * ((g->width + 7) / 8);
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        const glyph_t *g = &font->glyphs[i];
+        fwrite(font->bitmaps + g->offset, (size_t)height * ((g->width + 7) / 8), 1, fp);
+    }
+    
+    if (fclose(fp) != 0) {
+        fprintf(stderr, "Error: Failed to write %s\n", path);
+        return -1;
+    }
+    printf("%s: %u glyphs, height %d, %u bytes\n", path, n, height,
+           header.bitmap_offset + offset);
+    return 0;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [-g] [-r FIRST-LAST]... input.bdf output.s7f\n"
+            "  -g  keep only ASCII and GB2312 characters\n"
+            "  -r  keep only code points in the range (hex, e.g. 4E00-9FA5), repeatable\n",
+            prog);
+}
+
+int main(int argc, char *argv[]) {
+    int opt;
+    
+    while ((opt = getopt(argc, argv, "gr:h")) != -1) {
+        switch (opt) {
+            case 'g':
+                gb2312 = iconv_open("GB2312", "UTF-32LE");
+                if (gb2312 == (iconv_t)-1) {
+                    fprintf(stderr, "Error: iconv does not support GB2312\n");
+                    return 1;
+                }
+                break;
+            case 'r':
+                if (range_count == MAX_RANGES ||
+                    sscanf(optarg, "%x-%x", &ranges[range_count].first,
+                           &ranges[range_count].last) != 2) {
+                    usage(argv[0]);
+                    return 1;
+                }
+                range_count++;
+                break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (argc - optind != 2) {
+        usage(argv[0]);
+        return 1;
+    }
+    
+    FILE *fp = fopen(argv[optind], "r");
+    if (!fp) {
+        fprintf(stderr, "Error: Failed to open %s\n", argv[optind]);
+        return 1;
+    }
+    
+    font_t font;
+    memset(&font, 0, sizeof(font));
+    int height = 0, ascent = 0;
+    int ret = read_bdf(fp, &font, &height, &ascent);
+    fclose(fp);
+    if (ret < 0) {
+        fprintf(stderr, "Error: %s is not a BDF font\n", argv[optind]);
+    } else {
+        ret = write_font(argv[optind + 1], &font, height, ascent);
+    }
+    
+    if (gb2312 != (iconv_t)-1) iconv_close(gb2312);
+    free(font.glyphs);
+    free(font.bitmaps);
+    return ret < 0 ? 1 : 0;
+}
@@ -0,0 +1,1092 @@
+#include "st7735.h"
+#include "st7735_pixel.h"
+#include "st7735_blit.h"
+#include "st7735_mock.h"
+#include "st7735_scene.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// ST7735驱动性能测试（不需要硬件）
+//   st7735_bench [迭代次数] [--json|--csv] [--spi-hz 时钟]
+// 表格输出到stdout；指定--json/--csv时表格改到stderr，stdout只输出结果记录
+
+#define FRAME_PIXELS (ST7735_WIDTH * ST7735_HEIGHT)
+
+typedef enum { OUTPUT_TEXT, OUTPUT_JSON, OUTPUT_CSV } output_t;
+
+// 一条测量结果，bytes/ioctls/fps为0表示不适用
+typedef struct {
+    const char *section;
+    char name[32];
+    double ns;              // 每次操作的CPU时间
+    double bytes;           // 每次操作的线上字节数
+    double ioctls;          // 每次操作的SPI_IOC_MESSAGE次数
+    double fps;             // 给定SPI时钟下的刷新率上限
+} record_t;
+
+#define MAX_RECORDS 64
+
+static FILE *out;
+static double spi_hz = 16000000.0;
+static record_t records[MAX_RECORDS];
+static int record_count;
+
+static void record(const char *section, const char *name, double ns,
+                   double bytes, double ioctls, double fps) {
+    if (record_count >= MAX_RECORDS) return;
+    record_t *r = &records[record_count++];
+    r->section = section;
+    snprintf(r->name, sizeof(r->name), "%s", name);
+    r->ns = ns;
+    r->bytes = bytes;
+    r->ioctls = ioctls;
+    r->fps = fps;
+}
+
+static void print_records(output_t format, int iterations) {
+    if (format == OUTPUT_CSV) {
+        printf("section,name,ns_per_op,bytes,ioctls,fps\n");
+        for (int i = 0; i < record_count; i++) {
+            const record_t *r = &records[i];
+            printf("%s,%s,%.1f,%.1f,%.2f,%.1f\n",
+                   r->section, r->name, r->ns, r->bytes, r->ioctls, r->fps);
+        }
+    } else if (format == OUTPUT_JSON) {
+        printf("{\n  \"width\": %d, \"height\": %d, \"iterations\": %d, \"spi_hz\": %.0f,\n",
+               ST7735_WIDTH, ST7735_HEIGHT, iterations, spi_hz);
+        printf("  \"results\": [\n");
+        for (int i = 0; i < record_count; i++) {
+            const record_t *r = &records[i];
+            printf("    {\"section\": \"%s\", \"name\": \"%s\", \"ns_per_op\": %.1f, "
+                   "\"bytes\": %.1f, \"ioctls\": %.2f, \"fps\": %.1f}%s\n",
+                   r->section, r->name, r->ns, r->bytes, r->ioctls, r->fps,
+                   i + 1 < record_count ? "," : "");
+        }
+        printf("  ]\n}\n");
+    }
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+typedef void (*swap_fn)(uint16_t *dst, const uint16_t *src, size_t n);
+
+static double time_swap(swap_fn fn, uint16_t *dst, const uint16_t *src, int iterations) {
+    uint64_t start = now_ns();
+    for (int i = 0; i < iterations; i++) {
+        fn(dst, src, FRAME_PIXELS);
+    }
+    return (double)(now_ns() - start) / iterations;
+}
+
+// 字节序转换内核 vs 逐像素实现
+static int bench_swap(int iterations) {
+    static uint16_t src[FRAME_PIXELS];
+    static uint16_t ref[FRAME_PIXELS];
+    static uint16_t res[FRAME_PIXELS];
+    
+    for (int i = 0; i < FRAME_PIXELS; i++) {
+        src[i] = (uint16_t)rand();
+    }
+    
+    // 结果必须一致（奇数长度覆盖尾部处理）
+    st7735_swap16_scalar(ref, src, FRAME_PIXELS - 3);
+    st7735_swap16(res, src, FRAME_PIXELS - 3);
+    if (memcmp(ref, res, (FRAME_PIXELS - 3) * sizeof(uint16_t)) != 0) {
+        fprintf(stderr, "swap16: kernel result mismatch\n");
+        return -1;
+    }
+    
+    double scalar = time_swap(st7735_swap16_scalar, res, src, iterations);
+    double kernel = time_swap(st7735_swap16, res, src, iterations);
+    double bytes = FRAME_PIXELS * sizeof(uint16_t);
+    
+    fprintf(out, "%-16s %10s %10s %8s\n", "swap16", "ns/frame", "MB/s", "speedup");
+    fprintf(out, "%-16s %10.0f %10.1f %8s\n", "  scalar", scalar, bytes * 1000.0 / scalar, "1.00x");
+    record("swap16", "scalar", scalar, 0, 0, 0);
+    record("swap16", "kernel", kernel, 0, 0, 0);
+    fprintf(out, "%-16s %10.0f %10.1f %7.2fx\n", "  kernel", kernel, bytes * 1000.0 / kernel,
+            scalar / kernel);
+    return 0;
+}
+
+// ===== 线格式：RGB565 vs RGB444 =====
+
+typedef enum { WIRE_565, WIRE_444_SCALAR, WIRE_444, WIRE_444_DITHER, WIRE_COUNT } wire_kind_t;
+
+// 整帧转换为线格式，返回字节数
+static size_t stage_frame(wire_kind_t kind, uint8_t *out, uint16_t *tmp, const uint16_t *src) {
+    switch (kind) {
+        case WIRE_565:
+            st7735_swap16((uint16_t *)out, src, FRAME_PIXELS);
+            return FRAME_PIXELS * sizeof(uint16_t);
+        case WIRE_444_SCALAR:
+            return st7735_pack444_scalar(out, src, FRAME_PIXELS);
+        case WIRE_444:
+            return st7735_pack444(out, src, FRAME_PIXELS);
+        default:
+            // 与驱动相同：逐行抖动后原地打包
+            for (int y = 0; y < ST7735_HEIGHT; y++) {
+                st7735_dither444(tmp + y * ST7735_WIDTH, src + y * ST7735_WIDTH, ST7735_WIDTH, 0, y);
+            }
+            return st7735_pack444((uint8_t *)tmp, tmp, FRAME_PIXELS);
+    }
+}
+
+static int bench_wire_format(int iterations) {
+    static const char *names[WIRE_COUNT] = { "rgb565", "rgb444 scalar", "rgb444", "rgb444 dither" };
+    static uint16_t src[FRAME_PIXELS];
+    static uint16_t tmp[FRAME_PIXELS];
+    static uint8_t ref[FRAME_PIXELS * 2];
+    static uint8_t res[FRAME_PIXELS * 2];
+    
+    for (int i = 0; i < FRAME_PIXELS; i++) {
+        src[i] = (uint16_t)rand();
+    }
+    
+    // 打包内核与逐像素实现一致（奇数长度覆盖尾部处理），原地打包结果相同
+    size_t n_ref = st7735_pack444_scalar(ref, src, FRAME_PIXELS - 3);
+    size_t n_out = st7735_pack444(res, src, FRAME_PIXELS - 3);
+    memcpy(tmp, src, sizeof(src));
+    st7735_pack444((uint8_t *)tmp, tmp, FRAME_PIXELS - 3);
+    if (n_ref != n_out || memcmp(ref, res, n_ref) != 0 || memcmp(ref, tmp, n_ref) != 0) {
+        fprintf(stderr, "pack444: kernel result mismatch\n");
+        return -1;
+    }
+    
+    fprintf(out, "\n%-16s %10s %10s %10s\n", "wire format", "ns/frame", "bytes", "max fps");
+    for (int kind = 0; kind < WIRE_COUNT; kind++) {
+        size_t bytes = 0;
+        uint64_t start = now_ns();
+        for (int i = 0; i < iterations; i++) {
+            bytes = stage_frame(kind, res, tmp, src);
+        }
+        double ns = (double)(now_ns() - start) / iterations;
+        // 总线时钟下的刷新上限（不含命令和间隙）
+        fprintf(out, "%-16s %10.0f %10zu %10.1f\n", names[kind], ns, bytes,
+                spi_hz / (bytes * 8.0));
+        record("wire", names[kind], ns, bytes, 0, spi_hz / (bytes * 8.0));
+    }
+    return 0;
+}
+
+// ===== 图像：RGB888 -> RGB565 =====
+
+typedef void (*rgb888_fn)(uint16_t *dst, const uint8_t *src, size_t n);
+
+static void rgb888_dither_frame(uint16_t *dst, const uint8_t *src, size_t n) {
+    for (size_t y = 0; y < n / ST7735_WIDTH; y++) {
+        st7735_rgb888_to_565_dither(dst + y * ST7735_WIDTH, src + y * ST7735_WIDTH * 3,
+                                    ST7735_WIDTH, 0, y);
+    }
+}
+
+static int bench_rgb888(int iterations) {
+    static const char *names[3] = { "scalar", "kernel", "ordered dither" };
+    static const rgb888_fn fns[3] = {
+        st7735_rgb888_to_565_scalar, st7735_rgb888_to_565, rgb888_dither_frame,
+    };
+    static uint8_t src[FRAME_PIXELS * 3];
+    static uint16_t ref[FRAME_PIXELS];
+    static uint16_t res[FRAME_PIXELS];
+    
+    for (int i = 0; i < FRAME_PIXELS * 3; i++) {
+        src[i] = (uint8_t)rand();
+    }
+    
+    st7735_rgb888_to_565_scalar(ref, src, FRAME_PIXELS - 3);
+    st7735_rgb888_to_565(res, src, FRAME_PIXELS - 3);
+    if (memcmp(ref, res, (FRAME_PIXELS - 3) * sizeof(uint16_t)) != 0) {
+        fprintf(stderr, "rgb888: kernel result mismatch\n");
+        return -1;
+    }
+    
+    fprintf(out, "\n%-16s %10s %8s\n", "rgb888->565", "ns/frame", "speedup");
+    double t_ref = 0;
+    for (int k = 0; k < 3; k++) {
+        uint64_t start = now_ns();
+        for (int i = 0; i < iterations; i++) {
+            fns[k](res, src, FRAME_PIXELS);
+        }
+        double t = (double)(now_ns() - start) / iterations;
+        if (k == 0) t_ref = t;
+        fprintf(out, "%-16s %10.0f %7.2fx\n", names[k], t, t_ref / t);
+        record("rgb888", names[k], t, 0, 0, 0);
+    }
+    return 0;
+}
+
+// ===== 半透明混合 =====
+
+// 应用自己会写的做法：展开成8位通道，按0..255的alpha除以255再截断回RGB565
+__attribute__((optimize("no-tree-vectorize")))
+static void naive_blend(uint16_t *dst, const uint16_t *src, const uint8_t *alpha, size_t n,
+                        uint8_t constant) {
+    for (size_t i = 0; i < n; i++) {
+        unsigned a = alpha ? alpha[i] : constant;
+        unsigned sr = (src[i] >> 11) << 3, sg = ((src[i] >> 5) & 0x3F) << 2, sb = (src[i] & 0x1F) << 3;
+        unsigned dr = (dst[i] >> 11) << 3, dg = ((dst[i] >> 5) & 0x3F) << 2, db = (dst[i] & 0x1F) << 3;
+        unsigned r = (sr * a + dr * (255 - a)) / 255;
+        unsigned g = (sg * a + dg * (255 - a)) / 255;
+        unsigned b = (sb * a + db * (255 - a)) / 255;
+        dst[i] = (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+    }
+}
+
+typedef enum {
+    BLEND_NAIVE,
+    BLEND_SCALAR,
+    BLEND_KERNEL,
+    BLEND_COLOR,
+    BLEND_MASK_NAIVE,
+    BLEND_MASK_SCALAR,
+    BLEND_MASK_KERNEL,
+    BLEND_MASK_COLOR,
+    BLEND_COUNT
+} blend_kind_t;
+
+static const char *blend_names[BLEND_COUNT] = {
+    "naive /255", "scalar", "kernel", "color", "mask naive", "mask scalar", "mask kernel", "mask color",
+};
+
+static void run_blend(blend_kind_t kind, uint16_t *dst, const uint16_t *src, const uint8_t *mask) {
+    switch (kind) {
+        case BLEND_NAIVE: naive_blend(dst, src, NULL, FRAME_PIXELS, 96); break;
+        case BLEND_SCALAR: st7735_blend16_scalar(dst, src, FRAME_PIXELS, 96); break;
+        case BLEND_KERNEL: st7735_blend16(dst, src, FRAME_PIXELS, 96); break;
+        case BLEND_COLOR: st7735_blend16_color(dst, src[0], FRAME_PIXELS, 96); break;
+        case BLEND_MASK_NAIVE: naive_blend(dst, src, mask, FRAME_PIXELS, 0); break;
+        case BLEND_MASK_SCALAR: st7735_blend16_alpha_scalar(dst, src, mask, FRAME_PIXELS); break;
+        case BLEND_MASK_KERNEL: st7735_blend16_alpha(dst, src, mask, FRAME_PIXELS); break;
+        default: st7735_blend16_color_alpha(dst, src[0], mask, FRAME_PIXELS); break;
+    }
+}
+
+// 整帧混合：常数alpha与逐像素alpha（覆盖率一半为0/255，模拟精灵和字形边缘）
+static int bench_blend(int iterations) {
+    static uint16_t src[FRAME_PIXELS];
+    static uint16_t ref[FRAME_PIXELS];
+    static uint16_t res[FRAME_PIXELS];
+    static uint8_t mask[FRAME_PIXELS];
+    
+    for (int i = 0; i < FRAME_PIXELS; i++) {
+        src[i] = (uint16_t)rand();
+        ref[i] = (uint16_t)rand();
+        int r = rand() & 3;
+        mask[i] = r == 0 ? 0 : r == 1 ? 255 : (uint8_t)rand();
+    }
+    
+    // 内核与逐通道实现的结果必须一致（奇数长度覆盖尾部处理）
+    memcpy(res, ref, sizeof(res));
+    st7735_blend16_scalar(ref, src, FRAME_PIXELS - 3, 96);
+    st7735_blend16(res, src, FRAME_PIXELS - 3, 96);
+    bool ok = memcmp(ref, res, sizeof(res)) == 0;
+    st7735_blend16_alpha_scalar(ref, src, mask, FRAME_PIXELS - 3);
+    st7735_blend16_alpha(res, src, mask, FRAME_PIXELS - 3);
+    if (!ok || memcmp(ref, res, sizeof(res)) != 0) {
+        fprintf(stderr, "blend: kernel result mismatch\n");
+        return -1;
+    }
+    
+    fprintf(out, "\n%-16s %10s %10s %8s\n", "blend", "ns/frame", "Mpix/s", "speedup");
+    double t_ref = 0;
+    for (int kind = 0; kind < BLEND_COUNT; kind++) {
+        uint64_t start = now_ns();
+        for (int i = 0; i < iterations; i++) {
+            run_blend((blend_kind_t)kind, res, src, mask);
+        }
+        double t = (double)(now_ns() - start) / iterations;
+        // 常数alpha和逐像素alpha各自相对naive
+        if (kind == BLEND_NAIVE || kind == BLEND_MASK_NAIVE) t_ref = t;
+        fprintf(out, "%-16s %10.0f %10.1f %7.2fx\n", blend_names[kind], t,
+                FRAME_PIXELS * 1000.0 / t, t_ref / t);
+        record("blend", blend_names[kind], t, 0, 0, 0);
+    }
+    return 0;
+}
+
+// ===== 图元：span光栅化 vs 逐像素实现 =====
+
+// 逐像素参考实现（与改为span之前的绘制代码相同）
+static void ref_set_pixel(st7735_t *dev, uint16_t x, uint16_t y, uint16_t color) {
+    if (!dev || !dev->framebuffer) return;
+    if (x >= dev->width || y >= dev->height) return;
+    dev->framebuffer[y * dev->width + x] = color;
+}
+
+static void ref_clear(st7735_t *dev, uint16_t color) {
+    for (int i = 0; i < dev->width * dev->height; i++) {
+        dev->framebuffer[i] = color;
+    }
+}
+
+static void ref_fill_rect(st7735_t *dev, uint16_t x, uint16_t y,
+                          uint16_t w, uint16_t h, uint16_t color) {
+    for (uint16_t j = y; j < y + h && j < dev->height; j++) {
+        for (uint16_t i = x; i < x + w && i < dev->width; i++) {
+            ref_set_pixel(dev, i, j, color);
+        }
+    }
+}
+
+static void ref_fill_circle(st7735_t *dev, uint16_t x0, uint16_t y0,
+                            uint16_t r, uint16_t color) {
+    for (int y = -r; y <= r; y++) {
+        for (int x = -r; x <= r; x++) {
+            if (x * x + y * y <= r * r) {
+                ref_set_pixel(dev, x0 + x, y0 + y, color);
+            }
+        }
+    }
+}
+
+static void ref_draw_line(st7735_t *dev, uint16_t x0, uint16_t y0,
+                          uint16_t x1, uint16_t y1, uint16_t color) {
+    int dx = abs(x1 - x0);
+    int dy = abs(y1 - y0);
+    int sx = (x0 < x1) ? 1 : -1;
+    int sy = (y0 < y1) ? 1 : -1;
+    int err = dx - dy;
+    
+    while (1) {
+        ref_set_pixel(dev, x0, y0, color);
+        if (x0 == x1 && y0 == y1) break;
+        int e2 = 2 * err;
+        if (e2 > -dy) {
+            err -= dy;
+            x0 += sx;
+        }
+        if (e2 < dx) {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+static void ref_draw_circle(st7735_t *dev, uint16_t x0, uint16_t y0,
+                            uint16_t r, uint16_t color) {
+    int x = r, y = 0, err = 0;
+    while (x >= y) {
+        ref_set_pixel(dev, x0 + x, y0 + y, color);
+        ref_set_pixel(dev, x0 + y, y0 + x, color);
+        ref_set_pixel(dev, x0 - y, y0 + x, color);
+        ref_set_pixel(dev, x0 - x, y0 + y, color);
+        ref_set_pixel(dev, x0 - x, y0 - y, color);
+        ref_set_pixel(dev, x0 - y, y0 - x, color);
+        ref_set_pixel(dev, x0 + y, y0 - x, color);
+        ref_set_pixel(dev, x0 + x, y0 - y, color);
+        if (err <= 0) {
+            y += 1;
+            err += 2 * y + 1;
+        }
+        if (err > 0) {
+            x -= 1;
+            err -= 2 * x + 1;
+        }
+    }
+}
+
+// 逐像素判断是否落在圆角内
+static void ref_fill_round_rect(st7735_t *dev, uint16_t x, uint16_t y, uint16_t w,
+                                uint16_t h, uint16_t r, uint16_t color) {
+    for (int py = y; py < y + h; py++) {
+        for (int px = x; px < x + w; px++) {
+            int cx = px < x + r ? x + r : (px > x + w - 1 - r ? x + w - 1 - r : px);
+            int cy = py < y + r ? y + r : (py > y + h - 1 - r ? y + h - 1 - r : py);
+            if ((px - cx) * (px - cx) + (py - cy) * (py - cy) <= r * r) {
+                ref_set_pixel(dev, px, py, color);
+            }
+        }
+    }
+}
+
+// 不连接硬件的绘图设备
+static int bench_device(st7735_t *dev) {
+    memset(dev, 0, sizeof(*dev));
+    dev->width = ST7735_WIDTH;
+    dev->height = ST7735_HEIGHT;
+    dev->framebuffer = (uint16_t *)calloc(FRAME_PIXELS, sizeof(uint16_t));
+    st7735_reset_clip(dev);
+    return dev->framebuffer ? 0 : -1;
+}
+
+typedef enum {
+    PRIM_CLEAR,
+    PRIM_FILL_RECT_FULL,
+    PRIM_FILL_RECT_SMALL,
+    PRIM_FILL_CIRCLE,
+    PRIM_HLINE,
+    PRIM_VLINE,
+    PRIM_ROUND_RECT,
+    PRIM_LINE,
+    PRIM_CIRCLE,
+    PRIM_COUNT
+} prim_t;
+
+static const char *prim_names[PRIM_COUNT] = {
+    "clear", "fill_rect full", "fill_rect 16x16", "fill_circle r40",
+    "hline 160", "vline 128", "round_rect r8", "line diagonal", "circle r40",
+};
+
+static void run_prim(st7735_t *dev, prim_t prim, int ref, uint16_t color) {
+    switch (prim) {
+        case PRIM_CLEAR:
+            if (ref) ref_clear(dev, color); else st7735_clear(dev, color);
+            break;
+        case PRIM_FILL_RECT_FULL:
+            if (ref) ref_fill_rect(dev, 0, 0, dev->width, dev->height, color);
+            else st7735_fill_rect(dev, 0, 0, dev->width, dev->height, color);
+            break;
+        case PRIM_FILL_RECT_SMALL:
+            if (ref) ref_fill_rect(dev, 37, 21, 16, 16, color);
+            else st7735_fill_rect(dev, 37, 21, 16, 16, color);
+            break;
+        case PRIM_FILL_CIRCLE:
+            if (ref) ref_fill_circle(dev, 80, 64, 40, color);
+            else st7735_fill_circle(dev, 80, 64, 40, color);
+            break;
+        case PRIM_HLINE:
+            if (ref) ref_draw_line(dev, 0, 50, dev->width - 1, 50, color);
+            else st7735_draw_hline(dev, 0, 50, dev->width, color);
+            break;
+        case PRIM_VLINE:
+            if (ref) ref_draw_line(dev, 70, 0, 70, dev->height - 1, color);
+            else st7735_draw_vline(dev, 70, 0, dev->height, color);
+            break;
+        case PRIM_ROUND_RECT:
+            if (ref) ref_fill_round_rect(dev, 10, 10, 100, 60, 8, color);
+            else st7735_fill_round_rect(dev, 10, 10, 100, 60, 8, color);
+            break;
+        case PRIM_LINE:
+            if (ref) ref_draw_line(dev, 0, 0, dev->width - 1, dev->height - 1, color);
+            else st7735_draw_line(dev, 0, 0, dev->width - 1, dev->height - 1, color);
+            break;
+        case PRIM_CIRCLE:
+            if (ref) ref_draw_circle(dev, 80, 64, 40, color);
+            else st7735_draw_circle(dev, 80, 64, 40, color);
+            break;
+        default:
+            break;
+    }
+}
+
+static double time_prim(st7735_t *dev, prim_t prim, int ref, int iterations) {
+    uint64_t start = now_ns();
+    for (int i = 0; i < iterations; i++) {
+        run_prim(dev, prim, ref, (uint16_t)i);
+        dev->dirty_count = 0;
+    }
+    return (double)(now_ns() - start) / iterations;
+}
+
+static int bench_primitives(int iterations) {
+    st7735_t ref, dev;
+    if (bench_device(&ref) < 0 || bench_device(&dev) < 0) return -1;
+    
+    fprintf(out, "\n%-16s %10s %10s %8s\n", "primitive", "ref ns", "span ns", "speedup");
+    for (int prim = 0; prim < PRIM_COUNT; prim++) {
+        // 两种实现的结果必须逐像素一致
+        ref_clear(&ref, 0x1234);
+        ref_clear(&dev, 0x1234);
+        run_prim(&ref, prim, 1, 0xF81F);
+        run_prim(&dev, prim, 0, 0xF81F);
+        if (memcmp(ref.framebuffer, dev.framebuffer, FRAME_PIXELS * sizeof(uint16_t)) != 0) {
+            fprintf(stderr, "%s: span result mismatch\n", prim_names[prim]);
+            return -1;
+        }
+        
+        double t_ref = time_prim(&ref, prim, 1, iterations);
+        double t_new = time_prim(&dev, prim, 0, iterations);
+        fprintf(out, "%-16s %10.0f %10.0f %7.2fx\n", prim_names[prim], t_ref, t_new, t_ref / t_new);
+        record("primitive", prim_names[prim], t_new, 0, 0, 0);
+    }
+    
+    free(ref.framebuffer);
+    free(dev.framebuffer);
+    return 0;
+}
+
+// ===== 文本：字形缓存 vs 逐段绘制 =====
+
+// 仪表盘式的一屏文字
+static void draw_text_screen(st7735_t *dev, uint8_t size, bool transparent) {
+    static const char *lines[] = {
+        "CPU  42.5%  TEMP 51C", "MEM  318/924 MB", "NET  1.2 MB/s  UP",
+        "DISK 71%  /dev/root", "12:34:56  2026-10-17",
+    };
+    uint16_t fg = ST7735_WHITE;
+    uint16_t bg = transparent ? fg : ST7735_BLUE;
+    int line_h = 8 * size + 2;
+    int n = 0;
+    
+    for (int y = 0; y + 8 * size <= ST7735_HEIGHT; y += line_h) {
+        st7735_draw_string(dev, lines[n++ % 5], 0, y, fg, bg, size);
+    }
+    dev->dirty_count = 0;
+}
+
+static double time_text(st7735_t *dev, uint8_t size, bool transparent, int iterations) {
+    uint64_t start = now_ns();
+    for (int i = 0; i < iterations; i++) {
+        draw_text_screen(dev, size, transparent);
+    }
+    return (double)(now_ns() - start) / iterations;
+}
+
+static int bench_text(int iterations) {
+    st7735_t ref, dev;
+    if (bench_device(&ref) < 0 || bench_device(&dev) < 0) return -1;
+    st7735_set_glyph_cache(&ref, 0);
+    st7735_set_glyph_cache(&dev, ST7735_GLYPH_CACHE_BYTES);
+    
+    fprintf(out, "\n%-16s %10s %10s %8s\n", "text screen", "runs ns", "cache ns", "speedup");
+    for (uint8_t size = 1; size <= 2; size++) {
+        // 缓存路径与逐段绘制必须逐像素一致
+        draw_text_screen(&ref, size, false);
+        draw_text_screen(&dev, size, false);
+        if (memcmp(ref.framebuffer, dev.framebuffer, FRAME_PIXELS * sizeof(uint16_t)) != 0) {
+            fprintf(stderr, "text size %d: cached glyph mismatch\n", size);
+            return -1;
+        }
+        
+        double t_ref = time_text(&ref, size, false, iterations);
+        double t_new = time_text(&dev, size, false, iterations);
+        char name[32];
+        snprintf(name, sizeof(name), "opaque size %d", size);
+        fprintf(out, "%-16s %10.0f %10.0f %7.2fx\n", name, t_ref, t_new, t_ref / t_new);
+        record("text", name, t_new, 0, 0, 0);
+    }
+    
+    double t_mask = time_text(&dev, 2, true, iterations);
+    fprintf(out, "%-16s %10s %10.0f\n", "transparent 2", "-", t_mask);
+    record("text", "transparent 2", t_mask, 0, 0, 0);
+    
+    st7735_glyph_stats_t stats;
+    st7735_get_glyph_stats(&dev, &stats);
+    fprintf(out, "glyph cache: %u entries, %u bytes, %u hits, %u misses, %u evictions\n",
+            stats.entries, stats.bytes, stats.hits, stats.misses, stats.evictions);
+    
+    st7735_set_glyph_cache(&dev, 0);
+    free(ref.framebuffer);
+    free(dev.framebuffer);
+    return 0;
+}
+
+// ===== 位图：逐像素 vs 逐行复制 =====
+
+#define ICON_SIZE 48
+
+// 圆形图标，圆外为透明色
+static void make_icon(uint16_t *icon, uint16_t key) {
+    int c = ICON_SIZE / 2;
+    for (int y = 0; y < ICON_SIZE; y++) {
+        for (int x = 0; x < ICON_SIZE; x++) {
+            int d2 = (x - c) * (x - c) + (y - c) * (y - c);
+            uint16_t color = (y / 8) & 1 ? ST7735_YELLOW : ST7735_BLUE;
+            if (d2 > (c - 4) * (c - 4)) color = ST7735_WHITE;
+            icon[y * ICON_SIZE + x] = d2 > c * c ? key : color;
+        }
+    }
+}
+
+static void ref_blit_key(st7735_t *dev, int x, int y, const uint16_t *src,
+                         int w, int h, uint16_t key) {
+    for (int j = 0; j < h; j++) {
+        for (int i = 0; i < w; i++) {
+            uint16_t color = src[j * w + i];
+            if (color != key) st7735_set_pixel(dev, x + i, y + j, color);
+        }
+    }
+}
+
+typedef enum { BLIT_REF, BLIT_KEY, BLIT_RLE, BLIT_COUNT } blit_kind_t;
+
+static double time_blit(st7735_t *dev, blit_kind_t kind, const uint16_t *icon,
+                        const st7735_rle_t *rle, int iterations) {
+    uint64_t start = now_ns();
+    for (int i = 0; i < iterations; i++) {
+        // 一屏铺满，边缘的图标被裁剪
+        for (int y = -ICON_SIZE / 2; y < ST7735_HEIGHT; y += ICON_SIZE) {
+            for (int x = -ICON_SIZE / 2; x < ST7735_WIDTH; x += ICON_SIZE) {
+                if (kind == BLIT_REF) ref_blit_key(dev, x, y, icon, ICON_SIZE, ICON_SIZE, ST7735_MAGENTA);
+                else if (kind == BLIT_KEY) st7735_blit_key(dev, x, y, icon, ICON_SIZE, ICON_SIZE, ST7735_MAGENTA);
+                else st7735_blit_rle(dev, x, y, rle);
+            }
+        }
+        dev->dirty_count = 0;
+    }
+    return (double)(now_ns() - start) / iterations;
+}
+
+static int bench_blit(int iterations) {
+    static const char *names[BLIT_COUNT] = { "set_pixel", "blit_key", "blit_rle" };
+    uint16_t icon[ICON_SIZE * ICON_SIZE];
+    st7735_rle_t rle;
+    st7735_t ref, dev;
+    
+    make_icon(icon, ST7735_MAGENTA);
+    if (st7735_rle_encode(&rle, icon, ICON_SIZE, ICON_SIZE, true, ST7735_MAGENTA) < 0) return -1;
+    if (bench_device(&ref) < 0 || bench_device(&dev) < 0) return -1;
+    
+    fprintf(out, "\n%-16s %10s %8s\n", "icon screen", "ns", "speedup");
+    double t_ref = 0;
+    for (int kind = 0; kind < BLIT_COUNT; kind++) {
+        // 与逐像素结果逐一比较
+        ref_clear(&ref, 0);
+        ref_clear(&dev, 0);
+        time_blit(&ref, BLIT_REF, icon, &rle, 1);
+        time_blit(&dev, kind, icon, &rle, 1);
+        if (memcmp(ref.framebuffer, dev.framebuffer, FRAME_PIXELS * sizeof(uint16_t)) != 0) {
+            fprintf(stderr, "%s: blit result mismatch\n", names[kind]);
+            return -1;
+        }
+        
+        double t = time_blit(&dev, kind, icon, &rle, iterations);
+        if (kind == BLIT_REF) t_ref = t;
+        fprintf(out, "%-16s %10.0f %7.2fx\n", names[kind], t, t_ref / t);
+        record("blit", names[kind], t, 0, 0, 0);
+    }
+    fprintf(out, "rle: %u -> %u bytes (%.1f%%)\n",
+            (unsigned)sizeof(icon), (unsigned)(rle.words * sizeof(uint16_t)),
+            100.0 * rle.words * sizeof(uint16_t) / sizeof(icon));
+    
+    st7735_rle_free(&rle);
+    free(ref.framebuffer);
+    free(dev.framebuffer);
+    return 0;
+}
+
+// ===== framebuffer格式：RGB565 vs 8位索引色 =====
+
+typedef enum {
+    COLOR_CLEAR,
+    COLOR_FILL_RECT,
+    COLOR_FILL_CIRCLE,
+    COLOR_TEXT,
+    COLOR_FLUSH,
+    COLOR_RECOLOR,
+    COLOR_COUNT
+} color_op_t;
+
+static const char *color_names[COLOR_COUNT] = {
+    "clear", "fill_rect 80x64", "fill_circle r40", "text size 2", "update_full", "recolor+update",
+};
+
+// 同一操作在两种模式下画出相同的颜色：索引色模式传索引，RGB565模式传调色板中的颜色
+static void run_color(st7735_t *dev, color_op_t op, int i) {
+    uint8_t index = (uint8_t)(i * 37);
+    uint16_t color = dev->indexbuf ? index : dev->palette[index];
+    uint16_t bg = dev->indexbuf ? 0 : dev->palette[0];
+    
+    switch (op) {
+        case COLOR_CLEAR:
+            st7735_clear(dev, color);
+            break;
+        case COLOR_FILL_RECT:
+            st7735_fill_rect(dev, 40, 32, 80, 64, color);
+            break;
+        case COLOR_FILL_CIRCLE:
+            st7735_fill_circle(dev, 80, 64, 40, color);
+            break;
+        case COLOR_TEXT:
+            st7735_draw_string(dev, "12:34:56\nCPU 42%\nMEM 318M", 0, 0, color, bg, 2);
+            break;
+        case COLOR_FLUSH:
+            st7735_update_full(dev);
+            return;
+        case COLOR_RECOLOR:
+            // 换主题色：RGB565需要重绘，索引色只改调色板项，刷新时重新展开
+            if (dev->indexbuf) {
+                uint16_t c = (uint16_t)(i * 0x9E37);
+                st7735_set_palette(dev, 0, 1, &c);
+            } else {
+                st7735_clear(dev, (uint16_t)(i * 0x9E37));
+            }
+            st7735_update(dev);
+            return;
+        default:
+            break;
+    }
+    // 只测绘制
+    dev->dirty_count = 0;
+}
+
+static int bench_color_mode(int iterations) {
+    st7735_t ref, dev;
+    if (bench_device(&ref) < 0 || bench_device(&dev) < 0) return -1;
+    st7735_default_palette(ref.palette);
+    st7735_default_palette(dev.palette);
+    if (st7735_set_color_mode(&dev, ST7735_COLOR_INDEXED8) < 0) return -1;
+    
+    // 查表展开后必须与RGB565模式逐像素一致
+    static uint16_t expanded[FRAME_PIXELS];
+    for (int op = COLOR_CLEAR; op <= COLOR_TEXT; op++) {
+        run_color(&ref, op, op + 1);
+        run_color(&dev, op, op + 1);
+    }
+    st7735_lut16(expanded, dev.indexbuf, FRAME_PIXELS, dev.palette);
+    if (memcmp(ref.framebuffer, expanded, sizeof(expanded)) != 0) {
+        fprintf(stderr, "indexed8: expanded result mismatch\n");
+        return -1;
+    }
+    free(ref.framebuffer);
+    free(dev.indexbuf);
+    
+    // 经模拟spidev刷新，计入查表展开
+    st7735_mock_t mock[2];
+    st7735_transport_t transport[2] = { st7735_mock_transport(&mock[0]), st7735_mock_transport(&mock[1]) };
+    st7735_t *devs[2] = { &ref, &dev };
+    st7735_config_t config;
+    st7735_config_default(&config);
+    config.gpio_backend = ST7735_GPIO_FAKE;
+    for (int k = 0; k < 2; k++) {
+        config.transport = &transport[k];
+        if (st7735_init_config(devs[k], &config) < 0) return -1;
+    }
+    if (st7735_set_color_mode(&dev, ST7735_COLOR_INDEXED8) < 0) return -1;
+    
+    fprintf(out, "\n%-16s %10s %10s %8s\n", "color mode", "rgb565 ns", "index8 ns", "speedup");
+    for (int op = 0; op < COLOR_COUNT; op++) {
+        double t[2];
+        for (int k = 0; k < 2; k++) {
+            run_color(devs[k], op, 0);
+            uint64_t start = now_ns();
+            for (int i = 0; i < iterations; i++) {
+                run_color(devs[k], op, i);
+            }
+            t[k] = (double)(now_ns() - start) / iterations;
+        }
+        fprintf(out, "%-16s %10.0f %10.0f %7.2fx\n", color_names[op], t[0], t[1], t[0] / t[1]);
+        char name[32];
+        snprintf(name, sizeof(name), "rgb565 %s", color_names[op]);
+        record("color", name, t[0], 0, 0, 0);
+        snprintf(name, sizeof(name), "index8 %s", color_names[op]);
+        record("color", name, t[1], 0, 0, 0);
+    }
+    fprintf(out, "framebuffer: %u -> %u bytes\n", (unsigned)(FRAME_PIXELS * sizeof(uint16_t)),
+            (unsigned)FRAME_PIXELS);
+    
+    st7735_deinit(&ref);
+    st7735_deinit(&dev);
+    return 0;
+}
+
+// ===== 降分辨率渲染：1/2、1/4分辨率绘制，刷新时放大 =====
+
+static const uint8_t render_scales[] = { 1, 2, 4 };
+
+// 仪表盘一帧：清屏、圆弧刻度、指针和读数，坐标按当前宽高缩放
+static void draw_gauge(st7735_t *dev, int i) {
+    int w = dev->width, h = dev->height;
+    int r = h / 2 - 2;
+    char text[16];
+    
+    st7735_clear(dev, ST7735_BLACK);
+    st7735_fill_circle(dev, w / 2, h / 2, r, ST7735_BLUE);
+    st7735_draw_circle(dev, w / 2, h / 2, r, ST7735_WHITE);
+    st7735_draw_line(dev, w / 2, h / 2, w / 2 + (i % (2 * r)) - r, h / 2 - r / 2, ST7735_RED);
+    snprintf(text, sizeof(text), "%3d", i % 1000);
+    st7735_draw_string(dev, text, 2, 2, ST7735_YELLOW, ST7735_BLACK, 1);
+}
+
+static int bench_render_scale(int iterations) {
+    st7735_mock_t mock;
+    st7735_transport_t transport = st7735_mock_transport(&mock);
+    st7735_config_t config;
+    st7735_t dev;
+    
+    st7735_config_default(&config);
+    config.gpio_backend = ST7735_GPIO_FAKE;
+    config.rotation = ST7735_ROTATION_90;
+    config.transport = &transport;
+    if (st7735_init_config(&dev, &config) < 0) return -1;
+    
+    fprintf(out, "\n%-16s %10s %10s %10s %10s\n", "render scale", "size", "draw ns",
+            "flush ns", "fb bytes");
+    for (unsigned k = 0; k < sizeof(render_scales); k++) {
+        if (st7735_set_render_scale(&dev, render_scales[k]) < 0) return -1;
+        st7735_update(&dev);
+        
+        uint64_t start = now_ns();
+        for (int i = 0; i < iterations; i++) {
+            draw_gauge(&dev, i);
+            dev.dirty_count = 0;
+        }
+        double t_draw = (double)(now_ns() - start) / iterations;
+        start = now_ns();
+        for (int i = 0; i < iterations; i++) {
+            st7735_update_full(&dev);
+        }
+        double t_flush = (double)(now_ns() - start) / iterations;
+        
+        char size[16], name[32];
+        snprintf(size, sizeof(size), "%ux%u", dev.width, dev.height);
+        fprintf(out, "%-16s %10s %10.0f %10.0f %10u\n", render_scales[k] == 1 ? "full" :
+                render_scales[k] == 2 ? "1/2" : "1/4", size, t_draw, t_flush,
+                (unsigned)(dev.width * dev.height * sizeof(uint16_t)));
+        snprintf(name, sizeof(name), "draw %s", size);
+        record("scale", name, t_draw, 0, 0, 0);
+        snprintf(name, sizeof(name), "flush %s", size);
+        record("scale", name, t_flush, 0, 0, 0);
+    }
+    
+    st7735_deinit(&dev);
+    return 0;
+}
+
+// ===== 状态屏：每帧整屏重画 vs 保留模式场景 =====
+
+#define PANELS 6
+
+static const char *panel_labels[PANELS] = { "CPU %", "TEMP C", "MEM MB", "NET KB/s", "DISK %", "UPTIME h" };
+
+// 第i帧各面板的数值：只有两个在变
+static int panel_value(int panel, int i) {
+    if (panel == 0) return i % 100;
+    if (panel == 3) return (i * 7) % 1000;
+    return 10 * panel + 3;
+}
+
+// 立即模式：清屏后画出全部标题、面板框、标签和数值
+static void draw_status(st7735_t *dev, int i) {
+    st7735_clear(dev, ST7735_BLACK);
+    st7735_fill_rect(dev, 0, 0, dev->width, 16, ST7735_BLUE);
+    st7735_draw_string(dev, "NODE STATUS", 4, 4, ST7735_WHITE, ST7735_WHITE, 1);
+    for (int p = 0; p < PANELS; p++) {
+        int x = 1 + (p % 2) * 80, y = 18 + (p / 2) * 37;
+        char value[8];
+        snprintf(value, sizeof(value), "%4d", panel_value(p, i));
+        st7735_draw_round_rect(dev, x, y, 78, 36, 4, ST7735_CYAN);
+        st7735_draw_string(dev, panel_labels[p], x + 4, y + 4, ST7735_YELLOW, ST7735_BLACK, 1);
+        st7735_draw_string(dev, value, x + 4, y + 16, ST7735_WHITE, ST7735_BLACK, 2);
+    }
+}
+
+// 保留模式：同样的项，第一次全部提交，之后每帧重新提交数值（未变的被忽略）
+static void scene_status(st7735_scene_t *scene, int i, bool first) {
+    char name[16], value[8];
+    if (first) {
+        st7735_scene_rect(scene, "bar", 0, 0, ST7735_WIDTH, 16, ST7735_BLUE, true);
+        st7735_scene_text(scene, "title", 4, 4, "NODE STATUS", ST7735_WHITE, ST7735_WHITE, 1);
+    }
+    for (int p = 0; p < PANELS; p++) {
+        int x = 1 + (p % 2) * 80, y = 18 + (p / 2) * 37;
+        if (first) {
+            snprintf(name, sizeof(name), "box%d", p);
+            st7735_scene_round_rect(scene, name, x, y, 78, 36, 4, ST7735_CYAN, false);
+            snprintf(name, sizeof(name), "label%d", p);
+            st7735_scene_text(scene, name, x + 4, y + 4, panel_labels[p], ST7735_YELLOW, ST7735_BLACK, 1);
+        }
+        snprintf(name, sizeof(name), "value%d", p);
+        snprintf(value, sizeof(value), "%4d", panel_value(p, i));
+        st7735_scene_text(scene, name, x + 4, y + 16, value, ST7735_WHITE, ST7735_BLACK, 2);
+    }
+}
+
+static int bench_scene(int iterations) {
+    st7735_mock_t mock[2];
+    st7735_transport_t transport[2] = { st7735_mock_transport(&mock[0]), st7735_mock_transport(&mock[1]) };
+    st7735_t imm, ret;
+    st7735_t *devs[2] = { &imm, &ret };
+    st7735_config_t config;
+    st7735_config_default(&config);
+    config.gpio_backend = ST7735_GPIO_FAKE;
+    for (int k = 0; k < 2; k++) {
+        config.transport = &transport[k];
+        if (st7735_init_config(devs[k], &config) < 0) return -1;
+    }
+    st7735_scene_t *scene = st7735_scene_create(&ret, ST7735_BLACK);
+    if (!scene) return -1;
+    
+    // 两种方式画出的每一帧必须逐像素一致
+    for (int i = 0; i < 3; i++) {
+        draw_status(&imm, i);
+        st7735_update(&imm);
+        scene_status(scene, i, i == 0);
+        st7735_scene_update(scene);
+        if (memcmp(imm.framebuffer, ret.framebuffer, FRAME_PIXELS * sizeof(uint16_t)) != 0) {
+            fprintf(stderr, "scene: frame %d mismatch\n", i);
+            return -1;
+        }
+    }
+    
+    static const char *names[2] = { "redraw all", "scene" };
+    fprintf(out, "\n%-16s %10s %10s %8s   (%d panels, 2 values change per frame)\n",
+            "status screen", "ns/frame", "bytes", "ioctls", PANELS);
+    for (int k = 0; k < 2; k++) {
+        st7735_mock_reset(&mock[k]);
+        uint64_t start = now_ns();
+        for (int i = 3; i < iterations + 3; i++) {
+            if (k == 0) {
+                draw_status(&imm, i);
+                st7735_update(&imm);
+            } else {
+                scene_status(scene, i, false);
+                st7735_scene_update(scene);
+            }
+        }
+        double ns = (double)(now_ns() - start) / iterations;
+        double bytes = (double)mock[k].bytes / iterations;
+        double ioctls = (double)mock[k].ioctls / iterations;
+        fprintf(out, "%-16s %10.0f %10.0f %8.2f\n", names[k], ns, bytes, ioctls);
+        record("scene", names[k], ns, bytes, ioctls, 0);
+    }
+    
+    st7735_scene_stats_t stats;
+    st7735_scene_get_stats(scene, &stats);
+    fprintf(out, "scene: %u items, %.1f tiles/frame, %.1f item draws/frame\n", stats.items,
+            (double)stats.tiles / (iterations + 3), (double)stats.draws / (iterations + 3));
+    
+    st7735_scene_destroy(scene);
+    st7735_deinit(&imm);
+    st7735_deinit(&ret);
+    return 0;
+}
+
+// ===== 固定工作负载：绘制 + 刷新，经模拟spidev计量线上流量 =====
+
+typedef enum {
+    WORK_CLEAR,
+    WORK_RECT,
+    WORK_CIRCLE,
+    WORK_LINE,
+    WORK_TEXT1,
+    WORK_TEXT2,
+    WORK_FULL,
+    WORK_COUNT
+} work_t;
+
+static const char *work_names[WORK_COUNT] = {
+    "clear", "fill_rect 30x20", "fill_circle r20", "draw_line",
+    "text size 1", "text size 2", "update_full",
+};
+
+// 每次操作绘制一个图元并刷新，位置由i决定，结果可重复
+static void run_work(st7735_t *dev, work_t work, int i) {
+    uint16_t color = (uint16_t)(i * 0x9E37);
+    int x = (i * 37) % dev->width;
+    int y = (i * 23) % dev->height;
+    
+    switch (work) {
+        case WORK_CLEAR:
+            st7735_clear(dev, color);
+            break;
+        case WORK_RECT:
+            st7735_fill_rect(dev, x % (dev->width - 30), y % (dev->height - 20), 30, 20, color);
+            break;
+        case WORK_CIRCLE:
+            st7735_fill_circle(dev, 20 + x % (dev->width - 40), 20 + y % (dev->height - 40), 20, color);
+            break;
+        case WORK_LINE:
+            st7735_draw_line(dev, x, 0, dev->width - 1 - x, dev->height - 1, color);
+            break;
+        case WORK_TEXT1:
+            st7735_draw_string(dev, "CPU 42.5% TEMP 51C", 0, y % (dev->height - 8),
+                               ST7735_WHITE, ST7735_BLUE, 1);
+            break;
+        case WORK_TEXT2:
+            st7735_draw_string(dev, "12:34:56", 0, y % (dev->height - 16),
+                               ST7735_WHITE, ST7735_BLUE, 2);
+            break;
+        case WORK_FULL:
+            st7735_mark_dirty(dev, 0, 0, dev->width, dev->height);
+            break;
+        default:
+            break;
+    }
+    st7735_update(dev);
+}
+
+static int bench_workload(int iterations) {
+    st7735_mock_t mock;
+    st7735_transport_t transport = st7735_mock_transport(&mock);
+    st7735_config_t config;
+    st7735_t dev;
+    
+    st7735_config_default(&config);
+    config.gpio_backend = ST7735_GPIO_FAKE;
+    config.transport = &transport;
+    if (st7735_init_config(&dev, &config) < 0) return -1;
+    
+    fprintf(out, "\n%-16s %10s %10s %8s %10s %10s   (SPI %.1f MHz)\n", "workload", "ns/op",
+            "bytes/op", "ioctls", "bus us", "fps", spi_hz / 1e6);
+    for (int work = 0; work < WORK_COUNT; work++) {
+        run_work(&dev, work, 0);
+        st7735_mock_reset(&mock);
+        
+        uint64_t start = now_ns();
+        for (int i = 0; i < iterations; i++) {
+            run_work(&dev, work, i);
+        }
+        double ns = (double)(now_ns() - start) / iterations;
+        double bytes = (double)mock.bytes / iterations;
+        double ioctls = (double)mock.ioctls / iterations;
+        double bus_ns = st7735_mock_bus_ns(&mock, spi_hz) / iterations;
+        // 同步刷新时绘制、打包和总线传输依次进行
+        double fps = 1e9 / (ns + bus_ns);
+        
+        fprintf(out, "%-16s %10.0f %10.0f %8.2f %10.1f %10.1f\n", work_names[work], ns,
+                bytes, ioctls, bus_ns / 1000.0, fps);
+        record("workload", work_names[work], ns, bytes, ioctls, fps);
+    }
+    
+    if (out == stdout) {
+        fprintf(out, "\n");
+        st7735_print_stats(&dev, out);
+    }
+    
+    // 关闭序列不计入
+    st7735_deinit(&dev);
+    return 0;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [iterations] [--json|--csv] [--spi-hz HZ]\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    int iterations = 2000;
+    output_t format = OUTPUT_TEXT;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) {
+            format = OUTPUT_JSON;
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            format = OUTPUT_CSV;
+        } else if (strcmp(argv[i], "--spi-hz") == 0 && i + 1 < argc) {
+            spi_hz = atof(argv[++i]);
+        } else if (argv[i][0] != '-') {
+            iterations = atoi(argv[i]);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (iterations <= 0) iterations = 2000;
+    if (spi_hz <= 0) spi_hz = 16000000.0;
+    out = format == OUTPUT_TEXT ? stdout : stderr;
+    // 固定随机数种子，每次运行的数据相同
+    srand(1);
+    
+    fprintf(out, "ST7735 性能测试: %dx%d, %d 次迭代\n\n", ST7735_WIDTH, ST7735_HEIGHT, iterations);
+    
+    if (bench_swap(iterations) < 0) return 1;
+    if (bench_wire_format(iterations) < 0) return 1;
+    if (bench_rgb888(iterations) < 0) return 1;
+    if (bench_blend(iterations) < 0) return 1;
+    if (bench_primitives(iterations) < 0) return 1;
+    if (bench_text(iterations) < 0) return 1;
+    if (bench_blit(iterations) < 0) return 1;
+    if (bench_color_mode(iterations) < 0) return 1;
+    if (bench_render_scale(iterations) < 0) return 1;
+    if (bench_scene(iterations) < 0) return 1;
+    if (bench_workload(iterations) < 0) return 1;
+    
+    print_records(format, iterations);
+    return 0;
+}
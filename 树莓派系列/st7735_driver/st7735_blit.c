@@ -0,0 +1,253 @@
+#include "st7735_blit.h"
+#include "st7735_pixel.h"
+#include <stdlib.h>
+#include <string.h>
+
+// 裁剪结果：目标区域左上角、源偏移和可见尺寸
+typedef struct {
+    int dx, dy;
+    int sx, sy;
+    int w, h;
+} blit_clip_t;
+
+static int blit_clip(const st7735_t *dev, int x, int y, int w, int h, blit_clip_t *c) {
+    if (!dev || !dev->framebuffer) return -1;
+    
+    // 视口坐标平移到屏幕坐标后与裁剪区域求交
+    const st7735_clip_t *r = &dev->clip;
+    x += r->ox;
+    y += r->oy;
+    c->sx = x < r->x0 ? r->x0 - x : 0;
+    c->sy = y < r->y0 ? r->y0 - y : 0;
+    c->dx = x + c->sx;
+    c->dy = y + c->sy;
+    c->w = (x + w > r->x1 ? r->x1 - x : w) - c->sx;
+    c->h = (y + h > r->y1 ? r->y1 - y : h) - c->sy;
+    return (c->w > 0 && c->h > 0) ? 0 : -1;
+}
+
+static void blit_dirty(st7735_t *dev, const blit_clip_t *c) {
+    st7735_mark_dirty(dev, c->dx, c->dy, c->w, c->h);
+}
+
+void st7735_blit(st7735_t *dev, int x, int y, const uint16_t *src,
+                 uint16_t w, uint16_t h) {
+    blit_clip_t c;
+    if (!src || blit_clip(dev, x, y, w, h, &c) < 0) return;
+    
+    const uint16_t *s = src + c.sy * w + c.sx;
+    uint16_t *d = &dev->framebuffer[c.dy * dev->width + c.dx];
+    for (int j = 0; j < c.h; j++, s += w, d += dev->width) {
+        memcpy(d, s, c.w * sizeof(uint16_t));
+    }
+    blit_dirty(dev, &c);
+}
+
+void st7735_blit_key(st7735_t *dev, int x, int y, const uint16_t *src,
+                     uint16_t w, uint16_t h, uint16_t key) {
+    blit_clip_t c;
+    if (!src || blit_clip(dev, x, y, w, h, &c) < 0) return;
+    
+    const uint16_t *s = src + c.sy * w + c.sx;
+    uint16_t *d = &dev->framebuffer[c.dy * dev->width + c.dx];
+    for (int j = 0; j < c.h; j++, s += w, d += dev->width) {
+        // 非透明像素成段复制
+        int i = 0;
+        while (i < c.w) {
+            while (i < c.w && s[i] == key) i++;
+            int start = i;
+            while (i < c.w && s[i] != key) i++;
+            if (i > start) memcpy(d + start, s + start, (i - start) * sizeof(uint16_t));
+        }
+    }
+    blit_dirty(dev, &c);
+}
+
+void st7735_blit_mono(st7735_t *dev, int x, int y, const uint8_t *bits,
+                      uint16_t w, uint16_t h, uint16_t fg, uint16_t bg) {
+    blit_clip_t c;
+    if (!bits || blit_clip(dev, x, y, w, h, &c) < 0) return;
+    
+    int stride = (w + 7) / 8;
+    bool opaque = fg != bg;
+    const uint8_t *row = bits + c.sy * stride;
+    uint16_t *d = &dev->framebuffer[c.dy * dev->width + c.dx];
+    
+    for (int j = 0; j < c.h; j++, row += stride, d += dev->width) {
+        // 按连续的同值位成段填充
+        int i = 0;
+        while (i < c.w) {
+            int sx = c.sx + i;
+            int on = (row[sx >> 3] >> (7 - (sx & 7))) & 1;
+            int start = i;
+            for (i++; i < c.w; i++) {
+                sx = c.sx + i;
+                if (((row[sx >> 3] >> (7 - (sx & 7))) & 1) != on) break;
+            }
+            if (on || opaque) st7735_fill16(d + start, on ? fg : bg, i - start);
+        }
+    }
+    blit_dirty(dev, &c);
+}
+
+// ===== RLE =====
+
+// 编码一行，out为NULL时只计算长度
+static uint32_t rle_encode_row(const uint16_t *src, int w, bool keyed, uint16_t key,
+                               uint16_t *out) {
+    uint32_t n = 0;
+    int i = 0;
+    
+    while (i < w) {
+        int run = 1;
+        while (i + run < w && run < (int)ST7735_RLE_MAX && src[i + run] == src[i]) run++;
+        
+        // 两个以上相同像素或透明像素编码为重复段
+        if (run >= 2 || (keyed && src[i] == key)) {
+            if (out) {
+                out[n] = ST7735_RLE_RUN | run;
+                out[n + 1] = src[i];
+            }
+            n += 2;
+            i += run;
+            continue;
+        }
+        
+        // 原样段延伸到下一个重复段或透明像素之前
+        int start = i;
+        i++;
+        while (i < w && i - start < (int)ST7735_RLE_MAX &&
+               !(keyed && src[i] == key) && !(i + 1 < w && src[i + 1] == src[i])) {
+            i++;
+        }
+        if (out) {
+            out[n] = i - start;
+            memcpy(&out[n + 1], &src[start], (i - start) * sizeof(uint16_t));
+        }
+        n += 1 + (i - start);
+    }
+    return n;
+}
+
+int st7735_rle_encode(st7735_rle_t *rle, const uint16_t *src, uint16_t w, uint16_t h,
+                      bool keyed, uint16_t key) {
+    if (!rle || !src || w == 0 || h == 0) return -1;
+    
+    uint32_t words = 0;
+    for (int j = 0; j < h; j++) {
+        words += rle_encode_row(src + j * w, w, keyed, key, NULL);
+    }
+    
+    rle->data = (uint16_t *)malloc(words * sizeof(uint16_t));
+    if (!rle->data) return -1;
+    
+    uint16_t *out = rle->data;
+    for (int j = 0; j < h; j++) {
+        out += rle_encode_row(src + j * w, w, keyed, key, out);
+    }
+    
+    rle->width = w;
+    rle->height = h;
+    rle->keyed = keyed;
+    rle->key = key;
+    rle->words = words;
+    return 0;
+}
+
+void st7735_rle_free(st7735_rle_t *rle) {
+    if (!rle) return;
+    free(rle->data);
+    rle->data = NULL;
+    rle->words = 0;
+}
+
+void st7735_blit_rle(st7735_t *dev, int x, int y, const st7735_rle_t *rle) {
+    blit_clip_t c;
+    if (!rle || !rle->data || blit_clip(dev, x, y, rle->width, rle->height, &c) < 0) return;
+    
+    const uint16_t *p = rle->data;
+    int x0 = c.sx;
+    int x1 = c.sx + c.w;
+    
+    // 上方被裁掉的行也要解码以找到下一行的起点
+    for (int j = 0; j < c.sy + c.h; j++) {
+        bool visible = j >= c.sy;
+        uint16_t *d = visible ? &dev->framebuffer[(c.dy + j - c.sy) * dev->width + c.dx] : NULL;
+        int i = 0;
+        
+        while (i < rle->width) {
+            uint16_t head = *p++;
+            int n = head & ST7735_RLE_MAX;
+            
+            // 与可见列的交集[a, b)
+            int a = i > x0 ? i : x0;
+            int b = i + n < x1 ? i + n : x1;
+            
+            if (head & ST7735_RLE_RUN) {
+                uint16_t color = *p++;
+                if (visible && a < b && !(rle->keyed && color == rle->key)) {
+                    st7735_fill16(d + (a - x0), color, b - a);
+                }
+            } else {
+                if (visible && a < b) memcpy(d + (a - x0), p + (a - i), (b - a) * sizeof(uint16_t));
+                p += n;
+            }
+            i += n;
+        }
+    }
+    blit_dirty(dev, &c);
+}
+
+// ===== 半透明 =====
+
+void st7735_fill_rect_alpha(st7735_t *dev, int x, int y, uint16_t w, uint16_t h,
+                            uint16_t color, uint8_t alpha) {
+    blit_clip_t c;
+    if (alpha == 0 || blit_clip(dev, x, y, w, h, &c) < 0) return;
+    
+    uint16_t *d = &dev->framebuffer[c.dy * dev->width + c.dx];
+    for (int j = 0; j < c.h; j++, d += dev->width) {
+        st7735_blend16_color(d, color, c.w, alpha);
+    }
+    blit_dirty(dev, &c);
+}
+
+void st7735_blit_alpha(st7735_t *dev, int x, int y, const uint16_t *src,
+                       uint16_t w, uint16_t h, uint8_t alpha) {
+    blit_clip_t c;
+    if (!src || alpha == 0 || blit_clip(dev, x, y, w, h, &c) < 0) return;
+    
+    const uint16_t *s = src + c.sy * w + c.sx;
+    uint16_t *d = &dev->framebuffer[c.dy * dev->width + c.dx];
+    for (int j = 0; j < c.h; j++, s += w, d += dev->width) {
+        st7735_blend16(d, s, c.w, alpha);
+    }
+    blit_dirty(dev, &c);
+}
+
+void st7735_blit_masked(st7735_t *dev, int x, int y, const uint16_t *src, const uint8_t *mask,
+                        uint16_t w, uint16_t h) {
+    blit_clip_t c;
+    if (!src || !mask || blit_clip(dev, x, y, w, h, &c) < 0) return;
+    
+    const uint16_t *s = src + c.sy * w + c.sx;
+    const uint8_t *m = mask + c.sy * w + c.sx;
+    uint16_t *d = &dev->framebuffer[c.dy * dev->width + c.dx];
+    for (int j = 0; j < c.h; j++, s += w, m += w, d += dev->width) {
+        st7735_blend16_alpha(d, s, m, c.w);
+    }
+    blit_dirty(dev, &c);
+}
+
+void st7735_blit_alpha8(st7735_t *dev, int x, int y, const uint8_t *mask,
+                        uint16_t w, uint16_t h, uint16_t color) {
+    blit_clip_t c;
+    if (!mask || blit_clip(dev, x, y, w, h, &c) < 0) return;
+    
+    const uint8_t *m = mask + c.sy * w + c.sx;
+    uint16_t *d = &dev->framebuffer[c.dy * dev->width + c.dx];
+    for (int j = 0; j < c.h; j++, m += w, d += dev->width) {
+        st7735_blend16_color_alpha(d, color, m, c.w);
+    }
+    blit_dirty(dev, &c);
+}
@@ -0,0 +1,55 @@
+#ifndef ST7735_BLIT_H
+#define ST7735_BLIT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "st7735.h"
+
+// 位图绘制：坐标相对当前视口，与裁剪区域整块求交一次，之后逐行复制。坐标可以为负（部分移出）
+
+// RLE压缩精灵，每行独立编码，解码时直接写入framebuffer行：
+//   头字 0x8000|n : 重复，后跟1个颜色，表示n个相同像素
+//   头字 n        : 原样，后跟n个颜色
+// 带透明色时透明像素总是编码为重复段，绘制时整段跳过
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+    uint16_t key;           // 透明色（keyed为true时有效）
+    bool keyed;
+    uint32_t words;         // data中uint16_t的个数
+    uint16_t *data;
+} st7735_rle_t;
+
+#define ST7735_RLE_RUN      0x8000u
+#define ST7735_RLE_MAX      0x7FFFu
+
+// RGB565位图，行优先、紧密排列
+void st7735_blit(st7735_t *dev, int x, int y, const uint16_t *src,
+                 uint16_t w, uint16_t h);
+// 跳过等于key的像素
+void st7735_blit_key(st7735_t *dev, int x, int y, const uint16_t *src,
+                     uint16_t w, uint16_t h, uint16_t key);
+// 1bpp位图，高位在前，每行按字节对齐；bg与fg相同时背景透明
+void st7735_blit_mono(st7735_t *dev, int x, int y, const uint8_t *bits,
+                      uint16_t w, uint16_t h, uint16_t fg, uint16_t bg);
+
+// 压缩RGB565位图，失败返回-1；keyed为false时key被忽略
+int st7735_rle_encode(st7735_rle_t *rle, const uint16_t *src, uint16_t w, uint16_t h,
+                      bool keyed, uint16_t key);
+void st7735_rle_free(st7735_rle_t *rle);
+void st7735_blit_rle(st7735_t *dev, int x, int y, const st7735_rle_t *rle);
+
+// 半透明绘制：alpha为0（透明）..255（不透明），量化为33级
+void st7735_fill_rect_alpha(st7735_t *dev, int x, int y, uint16_t w, uint16_t h,
+                            uint16_t color, uint8_t alpha);
+// 整个位图按同一alpha叠加到framebuffer
+void st7735_blit_alpha(st7735_t *dev, int x, int y, const uint16_t *src,
+                       uint16_t w, uint16_t h, uint8_t alpha);
+// 带alpha通道的精灵：mask与src同尺寸，每像素一个alpha
+void st7735_blit_masked(st7735_t *dev, int x, int y, const uint16_t *src, const uint8_t *mask,
+                        uint16_t w, uint16_t h);
+// 8位覆盖率位图（抗锯齿字形、图标）按color绘制
+void st7735_blit_alpha8(st7735_t *dev, int x, int y, const uint8_t *mask,
+                        uint16_t w, uint16_t h, uint16_t color);
+
+#endif // ST7735_BLIT_H
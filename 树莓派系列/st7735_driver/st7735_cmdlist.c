@@ -0,0 +1,112 @@
+#include "st7735_cmdlist.h"
+#include <string.h>
+#include <unistd.h>
+
+void st7735_cmdlist_reset(st7735_cmdlist_t *cl) {
+    cl->seg_count = 0;
+    cl->buf_len = 0;
+    cl->overflow = 0;
+}
+
+// 追加一段内部字节，与上一段DC相同且地址连续时直接延长
+static void push_internal(st7735_cmdlist_t *cl, uint8_t dc, const uint8_t *bytes, uint8_t n) {
+    if (n == 0) return;
+    if (cl->buf_len + n > ST7735_CMDLIST_MAX_BYTES) {
+        cl->overflow = 1;
+        return;
+    }
+    
+    st7735_cmdseg_t *last = cl->seg_count ? &cl->seg[cl->seg_count - 1] : NULL;
+    if (last && !last->ext && last->dc == dc && last->delay_us == 0 &&
+        last->offset + last->len == cl->buf_len) {
+        last->len += n;
+    } else {
+        if (cl->seg_count >= ST7735_CMDLIST_MAX_SEGS) {
+            cl->overflow = 1;
+            return;
+        }
+        cl->seg[cl->seg_count++] = (st7735_cmdseg_t){
+            .ext = NULL, .offset = cl->buf_len, .len = n, .dc = dc, .delay_us = 0
+        };
+    }
+    
+    memcpy(&cl->buf[cl->buf_len], bytes, n);
+    cl->buf_len += n;
+}
+
+void st7735_cmdlist_cmd(st7735_cmdlist_t *cl, uint8_t cmd, const uint8_t *params, uint8_t n) {
+    push_internal(cl, 0, &cmd, 1);
+    push_internal(cl, 1, params, n);
+}
+
+void st7735_cmdlist_data(st7735_cmdlist_t *cl, const void *data, uint32_t len) {
+    if (len == 0) return;
+    if (cl->seg_count >= ST7735_CMDLIST_MAX_SEGS) {
+        cl->overflow = 1;
+        return;
+    }
+    cl->seg[cl->seg_count++] = (st7735_cmdseg_t){
+        .ext = (const uint8_t *)data, .offset = 0, .len = len, .dc = 1, .delay_us = 0
+    };
+}
+
+void st7735_cmdlist_delay(st7735_cmdlist_t *cl, uint32_t delay_us) {
+    if (cl->seg_count == 0) {
+        usleep(delay_us);
+        return;
+    }
+    cl->seg[cl->seg_count - 1].delay_us += delay_us;
+}
+
+// 提交当前累积的同DC传输
+static int flush_group(st7735_cmdlist_t *cl, st7735_cmdlist_sink_t sink, void *ctx,
+                       int dc, struct spi_ioc_transfer *xfer, unsigned *n) {
+    if (*n == 0) return 0;
+    
+    int ret = sink(ctx, dc, xfer, *n);
+    cl->stats.ioctls++;
+    cl->stats.transfers += *n;
+    *n = 0;
+    return ret;
+}
+
+int st7735_cmdlist_exec(st7735_cmdlist_t *cl, st7735_cmdlist_sink_t sink, void *ctx) {
+    if (!cl || !sink || cl->overflow) return -1;
+    
+    struct spi_ioc_transfer xfer[ST7735_CMDLIST_MAX_SEGS];
+    unsigned n = 0;
+    int dc = -1;
+    int ret = 0;
+    
+    memset(&cl->stats, 0, sizeof(cl->stats));
+    cl->stats.segments = cl->seg_count;
+    
+    for (unsigned i = 0; i < cl->seg_count; i++) {
+        const st7735_cmdseg_t *seg = &cl->seg[i];
+        
+        if (seg->dc != dc) {
+            if (flush_group(cl, sink, ctx, dc, xfer, &n) < 0) ret = -1;
+            dc = seg->dc;
+            cl->stats.dc_switches++;
+        }
+        
+        memset(&xfer[n], 0, sizeof(xfer[n]));
+        xfer[n].tx_buf = (unsigned long)(seg->ext ? seg->ext : &cl->buf[seg->offset]);
+        xfer[n].len = seg->len;
+        xfer[n].bits_per_word = 8;
+        n++;
+        
+        cl->stats.bytes += seg->len;
+        // 旧路径：命令和内部参数逐字节发送，外部数据一次发送
+        cl->stats.legacy_ioctls += seg->ext ? 1 : seg->len;
+        
+        if (seg->delay_us) {
+            if (flush_group(cl, sink, ctx, dc, xfer, &n) < 0) ret = -1;
+            usleep(seg->delay_us);
+        }
+    }
+    
+    if (flush_group(cl, sink, ctx, dc, xfer, &n) < 0) ret = -1;
+    
+    return ret < 0 ? -1 : (int)cl->stats.ioctls;
+}
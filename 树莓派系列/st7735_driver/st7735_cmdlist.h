@@ -0,0 +1,54 @@
+#ifndef ST7735_CMDLIST_H
+#define ST7735_CMDLIST_H
+
+#include <stdint.h>
+#include <linux/spi/spidev.h>
+
+// 命令列表容量
+#define ST7735_CMDLIST_MAX_SEGS   64
+#define ST7735_CMDLIST_MAX_BYTES  256
+
+// 一段DC电平相同的连续字节
+typedef struct {
+    const uint8_t *ext;     // 外部数据（如framebuffer），NULL表示位于内部缓冲
+    uint32_t offset;        // 内部缓冲中的偏移
+    uint32_t len;
+    uint8_t dc;             // 0命令 1数据
+    uint32_t delay_us;      // 本段发送后的等待时间
+} st7735_cmdseg_t;
+
+// 执行统计
+typedef struct {
+    uint32_t segments;      // 段数
+    uint32_t transfers;     // spi_ioc_transfer个数
+    uint32_t ioctls;        // SPI_IOC_MESSAGE调用次数
+    uint32_t dc_switches;   // DC切换次数
+    uint32_t bytes;         // 总字节数
+    uint32_t legacy_ioctls; // 逐字节发送时需要的ioctl次数（对比用）
+} st7735_cmdlist_stats_t;
+
+typedef struct {
+    st7735_cmdseg_t seg[ST7735_CMDLIST_MAX_SEGS];
+    uint8_t buf[ST7735_CMDLIST_MAX_BYTES];
+    uint16_t seg_count;
+    uint16_t buf_len;
+    uint8_t overflow;       // 容量不足时置位，执行时拒绝
+    st7735_cmdlist_stats_t stats;
+} st7735_cmdlist_t;
+
+// 发送一组DC相同的传输：由调用者设置DC并提交一次SPI_IOC_MESSAGE(n)
+typedef int (*st7735_cmdlist_sink_t)(void *ctx, int dc,
+                                     struct spi_ioc_transfer *xfer, unsigned n);
+
+void st7735_cmdlist_reset(st7735_cmdlist_t *cl);
+// 追加命令及其参数（参数复制到内部缓冲）
+void st7735_cmdlist_cmd(st7735_cmdlist_t *cl, uint8_t cmd, const uint8_t *params, uint8_t n);
+// 追加外部数据（不复制，执行完之前必须保持有效）
+void st7735_cmdlist_data(st7735_cmdlist_t *cl, const void *data, uint32_t len);
+// 在上一段之后插入等待
+void st7735_cmdlist_delay(st7735_cmdlist_t *cl, uint32_t delay_us);
+
+// 按DC分组打包成尽量少的ioctl并交给sink执行，返回ioctl次数，失败返回-1
+int st7735_cmdlist_exec(st7735_cmdlist_t *cl, st7735_cmdlist_sink_t sink, void *ctx);
+
+#endif // ST7735_CMDLIST_H
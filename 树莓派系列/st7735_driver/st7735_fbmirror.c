@@ -0,0 +1,314 @@
+// fbmirror：把Linux framebuffer（如/dev/fb0上的控制台）镜像到ST7735。
+// 每个周期按16x16分块采样并计算哈希，只把哈希变化的块写入framebuffer并标记脏区域，
+// 相邻的块由脏区域合并成少数几个窗口发送。画面不变时只有采样和哈希的开销，
+// 没有SPI传输；周期在有变化时缩短、空闲时逐步放长
+#include "st7735.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <linux/fb.h>
+
+#define TILE            16
+// 有变化后的刷新周期，保证在shell中打字时回显及时
+#define TICK_ACTIVE_MS  20
+// 空闲时周期逐次加倍到这个上限
+#define TICK_IDLE_MS    100
+
+typedef struct {
+    int fd;
+    const uint8_t *map;
+    size_t map_size;
+    struct fb_var_screeninfo var;
+    uint32_t line_length;
+    uint32_t bytes_per_pixel;
+    // 面板每列/每行对应的源像素字节偏移，-1表示留黑
+    int32_t *col;
+    int32_t *row;
+    // 每块上一次的哈希
+    uint64_t *hash;
+    uint16_t tiles_x;
+    uint16_t tiles_y;
+} mirror_t;
+
+static volatile sig_atomic_t running = 1;
+
+static void on_signal(int sig) {
+    (void)sig;
+    running = 0;
+}
+
+static int mirror_open(mirror_t *m, const char *path) {
+    struct fb_fix_screeninfo fix;
+    
+    memset(m, 0, sizeof(*m));
+    m->fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (m->fd < 0) {
+        fprintf(stderr, "Error: Failed to open %s\n", path);
+        return -1;
+    }
+    if (ioctl(m->fd, FBIOGET_FSCREENINFO, &fix) < 0 ||
+        ioctl(m->fd, FBIOGET_VSCREENINFO, &m->var) < 0) {
+        fprintf(stderr, "Error: %s is not a framebuffer device\n", path);
+        close(m->fd);
+        return -1;
+    }
+    
+    m->bytes_per_pixel = m->var.bits_per_pixel / 8;
+    if (m->bytes_per_pixel < 2 || m->bytes_per_pixel > 4) {
+        fprintf(stderr, "Error: Unsupported framebuffer depth %u bpp\n", m->var.bits_per_pixel);
+        close(m->fd);
+        return -1;
+    }
+    
+    m->line_length = fix.line_length;
+    m->map_size = fix.smem_len;
+    void *map = mmap(NULL, m->map_size, PROT_READ, MAP_SHARED, m->fd, 0);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "Error: Failed to map %s\n", path);
+        close(m->fd);
+        return -1;
+    }
+    m->map = (const uint8_t *)map;
+    return 0;
+}
+
+static void mirror_close(mirror_t *m) {
+    if (m->map) munmap((void *)m->map, m->map_size);
+    if (m->fd >= 0) close(m->fd);
+    free(m->col);
+    free(m->row);
+    free(m->hash);
+}
+
+// 建立采样表：crop为真时从(crop_x, crop_y)起1:1裁剪，否则保持比例缩小到面板内居中。
+// 缩小时取每个目标像素中心对应的源像素，控制台文字的笔画不会被平均成灰色
+static int mirror_map(mirror_t *m, const st7735_t *dev, bool crop, uint32_t crop_x, uint32_t crop_y) {
+    uint32_t sw = m->var.xres;
+    uint32_t sh = m->var.yres;
+    uint32_t dw = dev->width;
+    uint32_t dh = dev->height;
+    uint32_t ox = 0, oy = 0;
+    
+    m->col = (int32_t *)malloc(dw * sizeof(int32_t));
+    m->row = (int32_t *)malloc(dh * sizeof(int32_t));
+    m->tiles_x = (dw + TILE - 1) / TILE;
+    m->tiles_y = (dh + TILE - 1) / TILE;
+    m->hash = (uint64_t *)calloc(m->tiles_x * m->tiles_y, sizeof(uint64_t));
+    if (!m->col || !m->row || !m->hash) return -1;
+    
+    if (!crop) {
+        // 源图比面板小时不放大，1:1居中
+        uint32_t out_w = sw < dw ? sw : dw;
+        uint32_t out_h = sh < dh ? sh : dh;
+        if ((uint64_t)sw * out_h > (uint64_t)sh * out_w) {
+            out_h = (uint64_t)sh * out_w / sw;
+        } else {
+            out_w = (uint64_t)sw * out_h / sh;
+        }
+        ox = (dw - out_w) / 2;
+        oy = (dh - out_h) / 2;
+        dw = out_w;
+        dh = out_h;
+    }
+    
+    for (uint32_t x = 0; x < dev->width; x++) {
+        int64_t sx = -1;
+        if (x >= ox && x < ox + dw) {
+            sx = crop ? crop_x + x : (uint64_t)((x - ox) * 2 + 1) * sw / (2 * dw);
+        }
+        sx += m->var.xoffset;
+        m->col[x] = (sx >= m->var.xoffset && sx < m->var.xoffset + sw) ?
+                    (int32_t)(sx * m->bytes_per_pixel) : -1;
+    }
+    for (uint32_t y = 0; y < dev->height; y++) {
+        int64_t sy = -1;
+        if (y >= oy && y < oy + dh) {
+            sy = crop ? crop_y + y : (uint64_t)((y - oy) * 2 + 1) * sh / (2 * dh);
+        }
+        sy += m->var.yoffset;
+        m->row[y] = (sy >= m->var.yoffset && sy < m->var.yoffset + sh &&
+                     (uint64_t)(sy + 1) * m->line_length <= m->map_size) ?
+                    (int32_t)(sy * m->line_length) : -1;
+    }
+    return 0;
+}
+
+// 按bitfield描述取出一个通道，扩展到8位
+static inline uint8_t channel(uint32_t v, const struct fb_bitfield *f) {
+    uint32_t c = (v >> f->offset) & ((1u << f->length) - 1);
+    return f->length >= 8 ? c >> (f->length - 8) : c << (8 - f->length);
+}
+
+static inline uint32_t source_value(const mirror_t *m, const uint8_t *p) {
+    switch (m->bytes_per_pixel) {
+        case 2:  return *(const uint16_t *)p;
+        case 3:  return p[0] | (p[1] << 8) | (p[2] << 16);
+        default: return *(const uint32_t *)p;
+    }
+}
+
+static inline uint16_t source_pixel(const mirror_t *m, uint32_t v) {
+    // 常见的RGB565直接使用
+    if (m->bytes_per_pixel == 2 && m->var.red.offset == 11 && m->var.green.length == 6) return v;
+    return st7735_color_rgb(channel(v, &m->var.red), channel(v, &m->var.green),
+                            channel(v, &m->var.blue));
+}
+
+// 对一块的源像素计算哈希（64位FNV-1a）：只读不转换，空闲时每周期的开销就是这些
+static uint64_t hash_tile(const mirror_t *m, uint16_t x0, uint16_t y0, uint16_t w, uint16_t h) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    
+    for (uint16_t y = 0; y < h; y++) {
+        int32_t row = m->row[y0 + y];
+        if (row < 0) continue;
+        for (uint16_t x = 0; x < w; x++) {
+            int32_t col = m->col[x0 + x];
+            if (col < 0) continue;
+            hash = (hash ^ source_value(m, m->map + row + col)) * 0x100000001b3ull;
+        }
+    }
+    return hash;
+}
+
+// 把一块转换成RGB565写入framebuffer
+static void copy_tile(const mirror_t *m, st7735_t *dev, uint16_t x0, uint16_t y0,
+                      uint16_t w, uint16_t h) {
+    for (uint16_t y = y0; y < y0 + h; y++) {
+        int32_t row = m->row[y];
+        uint16_t *dst = &dev->framebuffer[y * dev->width];
+        for (uint16_t x = x0; x < x0 + w; x++) {
+            int32_t col = m->col[x];
+            dst[x] = (row < 0 || col < 0) ? 0 : source_pixel(m, source_value(m, m->map + row + col));
+        }
+    }
+}
+
+// 一个周期：计算全部块的哈希，变化的块转换后写入framebuffer并标记脏区域，返回变化的块数
+static int mirror_tick(mirror_t *m, st7735_t *dev, bool force) {
+    int changed = 0;
+    
+    for (uint16_t ty = 0; ty < m->tiles_y; ty++) {
+        for (uint16_t tx = 0; tx < m->tiles_x; tx++) {
+            uint16_t x0 = tx * TILE;
+            uint16_t y0 = ty * TILE;
+            uint16_t w = dev->width - x0 < TILE ? dev->width - x0 : TILE;
+            uint16_t h = dev->height - y0 < TILE ? dev->height - y0 : TILE;
+            uint64_t *hash = &m->hash[ty * m->tiles_x + tx];
+            
+            uint64_t next = hash_tile(m, x0, y0, w, h);
+            if (next == *hash && !force) continue;
+            
+            *hash = next;
+            copy_tile(m, dev, x0, y0, w, h);
+            st7735_mark_dirty(dev, x0, y0, w, h);
+            changed++;
+        }
+    }
+    
+    if (changed) st7735_update(dev);
+    return changed;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [-d fbdev] [-D spidev] [-r 0|90|180|270] [-c X,Y] [-i idle_ms] [-s seconds]\n"
+            "  -d  source framebuffer (default /dev/fb0)\n"
+            "  -D  SPI device of the panel (default /dev/spidev0.0)\n"
+            "  -r  panel rotation (default 90)\n"
+            "  -c  crop 1:1 from X,Y instead of scaling the whole framebuffer\n"
+            "  -i  longest polling interval when idle (default %d ms)\n"
+            "  -s  print transfer stats every N seconds\n",
+            prog, TICK_IDLE_MS);
+}
+
+int main(int argc, char *argv[]) {
+    const char *fb_path = "/dev/fb0";
+    bool crop = false;
+    uint32_t crop_x = 0, crop_y = 0;
+    uint32_t idle_ms = TICK_IDLE_MS;
+    uint32_t stats_s = 0;
+    st7735_config_t config;
+    int opt;
+    
+    st7735_config_default(&config);
+    // 守护进程重启时面板已点亮，不必复位
+    config.warm_start = true;
+    
+    while ((opt = getopt(argc, argv, "d:D:r:c:i:s:h")) != -1) {
+        switch (opt) {
+            case 'd':
+                fb_path = optarg;
+                break;
+            case 'D':
+                config.spi_device = optarg;
+                break;
+            case 'r':
+                config.rotation = (st7735_rotation_t)(atoi(optarg) / 90 % 4);
+                break;
+            case 'c':
+                if (sscanf(optarg, "%u,%u", &crop_x, &crop_y) != 2) {
+                    usage(argv[0]);
+                    return 1;
+                }
+                crop = true;
+                break;
+            case 'i':
+                idle_ms = atoi(optarg);
+                if (idle_ms < TICK_ACTIVE_MS) idle_ms = TICK_ACTIVE_MS;
+                break;
+            case 's':
+                stats_s = atoi(optarg);
+                break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    
+    mirror_t mirror;
+    if (mirror_open(&mirror, fb_path) < 0) return 1;
+    
+    st7735_t lcd;
+    if (st7735_init_config(&lcd, &config) < 0) {
+        fprintf(stderr, "初始化失败\n");
+        mirror_close(&mirror);
+        return 1;
+    }
+    if (mirror_map(&mirror, &lcd, crop, crop_x, crop_y) < 0) {
+        fprintf(stderr, "Error: Out of memory\n");
+        st7735_deinit(&lcd);
+        mirror_close(&mirror);
+        return 1;
+    }
+    
+    printf("镜像 %s (%ux%u, %u bpp) -> ST7735 %ux%u\n", fb_path, mirror.var.xres,
+           mirror.var.yres, mirror.var.bits_per_pixel, lcd.width, lcd.height);
+    if (stats_s) st7735_set_stats_dump(&lcd, stdout, stats_s * 1000);
+    
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    
+    // 第一次整屏发送，之后只发送变化的块
+    uint32_t tick_ms = TICK_ACTIVE_MS;
+    bool force = true;
+    while (running) {
+        if (mirror_tick(&mirror, &lcd, force) > 0) {
+            tick_ms = TICK_ACTIVE_MS;
+        } else if (tick_ms < idle_ms) {
+            tick_ms = tick_ms * 2 < idle_ms ? tick_ms * 2 : idle_ms;
+        }
+        force = false;
+        usleep(tick_ms * 1000);
+    }
+    
+    if (stats_s) st7735_print_stats(&lcd, stdout);
+    st7735_deinit(&lcd);
+    mirror_close(&mirror);
+    return 0;
+}
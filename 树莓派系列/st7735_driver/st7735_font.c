@@ -0,0 +1,151 @@
+#include "st7735_font.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+struct st7735_font {
+    const uint8_t *map;
+    size_t size;
+    const st7735_font_header_t *header;
+    const st7735_font_glyph_t *index;
+    const uint8_t *bitmaps;
+    size_t bitmap_size;
+};
+
+st7735_font_t *st7735_font_open(const char *path) {
+    if (!path) return NULL;
+    
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        fprintf(stderr, "Error: Failed to open font %s\n", path);
+        return NULL;
+    }
+    
+    struct stat st;
+    void *map = MAP_FAILED;
+    bool short_file = fstat(fd, &st) == 0 && (size_t)st.st_size < sizeof(st7735_font_header_t);
+    if (!short_file) map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, short_file ? "Error: %s is not a valid font\n" :
+                "Error: Failed to map font %s\n", path);
+        return NULL;
+    }
+    // 查找是随机访问，关闭预读，只读入实际用到的页
+    madvise(map, st.st_size, MADV_RANDOM);
+    
+    // 只检查文件头和块表，索引项和位图在查找时逐个检查，打开时不读入整个索引
+    const st7735_font_header_t *h = (const st7735_font_header_t *)map;
+    size_t index_end = sizeof(*h) + (size_t)h->count * sizeof(st7735_font_glyph_t);
+    bool ok = memcmp(h->magic, ST7735_FONT_MAGIC, sizeof(h->magic)) == 0 &&
+              h->height > 0 && h->ascent <= h->height &&
+              index_end <= h->bitmap_offset && h->bitmap_offset <= (size_t)st.st_size;
+    for (int b = 0; ok && b < 256; b++) {
+        ok = h->block[b] <= h->block[b + 1];
+    }
+    st7735_font_t *font = ok && h->block[256] <= h->count ?
+                          (st7735_font_t *)calloc(1, sizeof(*font)) : NULL;
+    if (!font) {
+        fprintf(stderr, "Error: %s is not a valid font\n", path);
+        munmap(map, st.st_size);
+        return NULL;
+    }
+    
+    font->map = (const uint8_t *)map;
+    font->size = st.st_size;
+    font->header = h;
+    font->index = (const st7735_font_glyph_t *)(font->map + sizeof(*h));
+    font->bitmaps = font->map + h->bitmap_offset;
+    font->bitmap_size = st.st_size - h->bitmap_offset;
+    return font;
+}
+
+void st7735_font_close(st7735_font_t *font) {
+    if (!font) return;
+    munmap((void *)font->map, font->size);
+    free(font);
+}
+
+uint16_t st7735_font_height(const st7735_font_t *font) {
+    return font ? font->header->height : 0;
+}
+
+// 先按块表缩小到同一高字节的码点，二分查找只访问索引中的一小段
+const st7735_font_glyph_t *st7735_font_find(const st7735_font_t *font, uint32_t code,
+                                            const uint8_t **bitmap) {
+    if (!font) return NULL;
+    
+    const st7735_font_header_t *h = font->header;
+    uint32_t lo, hi;
+    if (code < 0x10000) {
+        lo = h->block[code >> 8];
+        hi = h->block[(code >> 8) + 1];
+    } else {
+        lo = h->block[256];
+        hi = h->count;
+    }
+    
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        const st7735_font_glyph_t *g = &font->index[mid];
+        if (g->code < code) {
+            lo = mid + 1;
+        } else if (g->code > code) {
+            hi = mid;
+        } else {
+            size_t bytes = (size_t)h->height * ((g->width + 7) / 8);
+            if (g->offset > font->bitmap_size || bytes > font->bitmap_size - g->offset) return NULL;
+            if (bitmap) *bitmap = font->bitmaps + g->offset;
+            return g;
+        }
+    }
+    return NULL;
+}
+
+uint32_t st7735_utf8_next(const char **s) {
+    const uint8_t *p = (const uint8_t *)*s;
+    uint32_t c = p[0];
+    int len;
+    uint32_t min;
+    
+    if (c < 0x80) {
+        *s += 1;
+        return c;
+    } else if ((c & 0xE0) == 0xC0) {
+        len = 2;
+        min = 0x80;
+        c &= 0x1F;
+    } else if ((c & 0xF0) == 0xE0) {
+        len = 3;
+        min = 0x800;
+        c &= 0x0F;
+    } else if ((c & 0xF8) == 0xF0) {
+        len = 4;
+        min = 0x10000;
+        c &= 0x07;
+    } else {
+        *s += 1;
+        return 0xFFFD;
+    }
+    
+    for (int i = 1; i < len; i++) {
+        // 截断时遇到结尾的0也在这里停下
+        if ((p[i] & 0xC0) != 0x80) {
+            *s += 1;
+            return 0xFFFD;
+        }
+        c = (c << 6) | (p[i] & 0x3F);
+    }
+    // 过长编码、代理区和超出范围的码点
+    if (c < min || (c >= 0xD800 && c <= 0xDFFF) || c > 0x10FFFF) {
+        *s += 1;
+        return 0xFFFD;
+    }
+    *s += len;
+    return c;
+}
@@ -0,0 +1,49 @@
+#ifndef ST7735_FONT_H
+#define ST7735_FONT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 点阵字体文件（.s7f）：mmap后按码点查找，只有用到的字形所在页才会被读入内存。
+// 文件布局（小端）：
+//   st7735_font_header_t
+//   st7735_font_glyph_t[count]    按码点升序
+//   位图区：每个字形height行，每行(width + 7) / 8字节，高位在前
+// 由st7735_bdf2font从BDF字体生成
+
+#define ST7735_FONT_MAGIC   "ST7735F1"
+
+typedef struct {
+    char magic[8];
+    uint16_t height;            // 行高（像素），所有字形位图同高
+    uint16_t ascent;            // 顶部到基线的距离
+    uint32_t count;             // 字形数
+    uint32_t bitmap_offset;     // 位图区在文件中的偏移
+    uint32_t block[257];        // BMP内码点高字节为b的字形从索引第block[b]项开始；
+                                // block[256]起为BMP以外的码点
+} st7735_font_header_t;
+
+typedef struct {
+    uint32_t code;              // Unicode码点
+    uint32_t offset;            // 位图相对位图区的偏移
+    uint8_t width;              // 位图宽度（像素）
+    int8_t left;                // 位图左边相对笔位置的偏移
+    uint8_t advance;            // 笔前进量
+    uint8_t reserved;
+} st7735_font_glyph_t;
+
+typedef struct st7735_font st7735_font_t;
+
+// 打开字体文件，格式错误或越界时返回NULL
+st7735_font_t *st7735_font_open(const char *path);
+void st7735_font_close(st7735_font_t *font);
+uint16_t st7735_font_height(const st7735_font_t *font);
+
+// 查找码点，不存在时返回NULL；*bitmap指向映射中的位图
+const st7735_font_glyph_t *st7735_font_find(const st7735_font_t *font, uint32_t code,
+                                            const uint8_t **bitmap);
+
+// 解码一个UTF-8字符并前移*s；非法或截断的序列返回U+FFFD并只跳过一个字节
+uint32_t st7735_utf8_next(const char **s);
+
+#endif // ST7735_FONT_H
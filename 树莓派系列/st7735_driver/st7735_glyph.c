@@ -0,0 +1,145 @@
+#include "st7735_glyph.h"
+#include "st7735_pixel.h"
+#include <stdlib.h>
+#include <string.h>
+
+// 缓存项，按使用时间串成双向链表（表头最近使用）
+typedef struct glyph_entry {
+    uint64_t key;
+    uint16_t *pixels;
+    uint32_t bytes;
+    struct glyph_entry *hash_next;
+    struct glyph_entry *prev;
+    struct glyph_entry *next;
+} glyph_entry_t;
+
+struct st7735_glyph_cache {
+    size_t budget;
+    glyph_entry_t *buckets[ST7735_GLYPH_HASH_BUCKETS];
+    glyph_entry_t *head;        // 最近使用
+    glyph_entry_t *tail;        // 最久未用，优先淘汰
+    st7735_glyph_stats_t stats;
+};
+
+static uint64_t glyph_key(uint8_t code, uint8_t size, uint16_t fg, uint16_t bg) {
+    return ((uint64_t)code << 40) | ((uint64_t)size << 32) | ((uint32_t)fg << 16) | bg;
+}
+
+static unsigned glyph_bucket(uint64_t key) {
+    // 乘法散列，取高位
+    return (unsigned)((key * 0x9E3779B97F4A7C15ull) >> 58) % ST7735_GLYPH_HASH_BUCKETS;
+}
+
+static void lru_unlink(st7735_glyph_cache_t *cache, glyph_entry_t *e) {
+    if (e->prev) e->prev->next = e->next; else cache->head = e->next;
+    if (e->next) e->next->prev = e->prev; else cache->tail = e->prev;
+    e->prev = e->next = NULL;
+}
+
+static void lru_push_front(st7735_glyph_cache_t *cache, glyph_entry_t *e) {
+    e->prev = NULL;
+    e->next = cache->head;
+    if (cache->head) cache->head->prev = e;
+    cache->head = e;
+    if (!cache->tail) cache->tail = e;
+}
+
+static void evict(st7735_glyph_cache_t *cache, glyph_entry_t *e) {
+    glyph_entry_t **link = &cache->buckets[glyph_bucket(e->key)];
+    while (*link != e) link = &(*link)->hash_next;
+    *link = e->hash_next;
+    
+    lru_unlink(cache, e);
+    cache->stats.entries--;
+    cache->stats.bytes -= e->bytes;
+    free(e->pixels);
+    free(e);
+}
+
+// 每个源像素行展开一次，再复制size次
+static void expand(uint16_t *dst, const uint8_t bitmap[8], uint8_t size,
+                   uint16_t fg, uint16_t bg) {
+    int side = 8 * size;
+    
+    for (int j = 0; j < 8; j++) {
+        uint16_t *row = dst + j * size * side;
+        uint8_t line = bitmap[j];
+        for (int i = 0; i < 8; i++) {
+            st7735_fill16(row + i * size, (line & 0x80) ? fg : bg, size);
+            line <<= 1;
+        }
+        for (int k = 1; k < size; k++) {
+            memcpy(row + k * side, row, side * sizeof(uint16_t));
+        }
+    }
+}
+
+st7735_glyph_cache_t *st7735_glyph_cache_create(size_t budget) {
+    st7735_glyph_cache_t *cache = calloc(1, sizeof(*cache));
+    if (!cache) return NULL;
+    cache->budget = budget;
+    return cache;
+}
+
+void st7735_glyph_cache_destroy(st7735_glyph_cache_t *cache) {
+    if (!cache) return;
+    while (cache->tail) evict(cache, cache->tail);
+    free(cache);
+}
+
+const uint16_t *st7735_glyph_cache_get(st7735_glyph_cache_t *cache, uint8_t code,
+                                       const uint8_t bitmap[8], uint8_t size,
+                                       uint16_t fg, uint16_t bg) {
+    if (!cache || size == 0) return NULL;
+    
+    uint64_t key = glyph_key(code, size, fg, bg);
+    unsigned bucket = glyph_bucket(key);
+    
+    for (glyph_entry_t *e = cache->buckets[bucket]; e; e = e->hash_next) {
+        if (e->key == key) {
+            if (e != cache->head) {
+                lru_unlink(cache, e);
+                lru_push_front(cache, e);
+            }
+            cache->stats.hits++;
+            return e->pixels;
+        }
+    }
+    
+    cache->stats.misses++;
+    uint32_t bytes = 64u * size * size * sizeof(uint16_t);
+    if (bytes > cache->budget) return NULL;
+    
+    while (cache->tail && cache->stats.bytes + bytes > cache->budget) {
+        evict(cache, cache->tail);
+        cache->stats.evictions++;
+    }
+    
+    glyph_entry_t *e = calloc(1, sizeof(*e));
+    if (!e) return NULL;
+    e->pixels = malloc(bytes);
+    if (!e->pixels) {
+        free(e);
+        return NULL;
+    }
+    expand(e->pixels, bitmap, size, fg, bg);
+    e->key = key;
+    e->bytes = bytes;
+    
+    e->hash_next = cache->buckets[bucket];
+    cache->buckets[bucket] = e;
+    lru_push_front(cache, e);
+    cache->stats.entries++;
+    cache->stats.bytes += bytes;
+    
+    return e->pixels;
+}
+
+void st7735_glyph_cache_stats(const st7735_glyph_cache_t *cache, st7735_glyph_stats_t *stats) {
+    if (!stats) return;
+    if (!cache) {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+    *stats = cache->stats;
+}
@@ -0,0 +1,35 @@
+#ifndef ST7735_GLYPH_H
+#define ST7735_GLYPH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 字形缓存：把8x8点阵按(字符, 放大倍数, 前景色, 背景色)预展开成RGB565，
+// 绘制时只需逐行复制。按字节预算做LRU淘汰
+
+#define ST7735_GLYPH_CACHE_BYTES    (32 * 1024)   // 默认预算
+#define ST7735_GLYPH_HASH_BUCKETS   64
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    uint32_t entries;           // 当前缓存的字形数
+    uint32_t bytes;             // 当前占用的像素字节数
+} st7735_glyph_stats_t;
+
+typedef struct st7735_glyph_cache st7735_glyph_cache_t;
+
+// budget为像素数据的字节上限
+st7735_glyph_cache_t *st7735_glyph_cache_create(size_t budget);
+void st7735_glyph_cache_destroy(st7735_glyph_cache_t *cache);
+
+// 取得展开后的字形：(8*size)x(8*size)像素，行优先；
+// 单个字形超过预算或内存不足时返回NULL，调用者应退回直接绘制
+const uint16_t *st7735_glyph_cache_get(st7735_glyph_cache_t *cache, uint8_t code,
+                                       const uint8_t bitmap[8], uint8_t size,
+                                       uint16_t fg, uint16_t bg);
+
+void st7735_glyph_cache_stats(const st7735_glyph_cache_t *cache, st7735_glyph_stats_t *stats);
+
+#endif // ST7735_GLYPH_H
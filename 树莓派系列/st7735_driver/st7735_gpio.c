@@ -0,0 +1,257 @@
+#include "st7735_gpio.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+
+#define GPIO_DEFAULT_CHIP    "/dev/gpiochip0"
+// sysfs导出后等待udev设置权限的最长时间
+#define SYSFS_EXPORT_WAIT_MS 100
+
+#if ST7735_STATS
+static uint64_t gpio_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+#endif
+
+static int line_value(uint8_t values, int line) {
+    return (values >> line) & 1;
+}
+
+// ===== 字符设备后端 =====
+
+static int chardev_open(st7735_gpio_t *gpio, const char *chip) {
+    struct gpiohandle_request req;
+    memset(&req, 0, sizeof(req));
+    
+    int chip_fd = open(chip ? chip : GPIO_DEFAULT_CHIP, O_RDWR | O_CLOEXEC);
+    if (chip_fd < 0) return -1;
+    
+    for (int line = 0; line < ST7735_LINE_COUNT; line++) {
+        if (gpio->pins[line] < 0) continue;
+        gpio->handle_index[line] = req.lines;
+        req.lineoffsets[req.lines] = gpio->pins[line];
+        req.default_values[req.lines] = line_value(gpio->values, line);
+        req.lines++;
+    }
+    req.flags = GPIOHANDLE_REQUEST_OUTPUT;
+    strncpy(req.consumer_label, "st7735", sizeof(req.consumer_label) - 1);
+    
+    int ret = ioctl(chip_fd, GPIO_GET_LINEHANDLE_IOCTL, &req);
+    int err = errno;
+    close(chip_fd);
+    if (ret < 0) {
+        // CE0/CE1常被SPI控制器自身占用（EBUSY），此时交给硬件片选；
+        // 其他错误（权限、DC/RST被占用等）去掉片选也无济于事
+        if (err == EBUSY && gpio->pins[ST7735_LINE_CS] >= 0) {
+            gpio->pins[ST7735_LINE_CS] = -1;
+            return chardev_open(gpio, chip);
+        }
+        return -1;
+    }
+    
+    gpio->handle_fd = req.fd;
+    gpio->handle_lines = req.lines;
+    return 0;
+}
+
+static void chardev_write(st7735_gpio_t *gpio) {
+    struct gpiohandle_data data;
+    memset(&data, 0, sizeof(data));
+    
+    for (int line = 0; line < ST7735_LINE_COUNT; line++) {
+        if (gpio->pins[line] < 0) continue;
+        data.values[gpio->handle_index[line]] = line_value(gpio->values, line);
+    }
+    ioctl(gpio->handle_fd, GPIOHANDLE_SET_LINE_VALUES_IOCTL, &data);
+    gpio->writes++;
+}
+
+// ===== sysfs后端 =====
+
+// 失败时errno为open/write的错误（调用者据此区分EBUSY）
+static int sysfs_write_file(const char *path, const char *text) {
+    int fd = open(path, O_WRONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+    int ret = write(fd, text, strlen(text));
+    int err = errno;
+    close(fd);
+    errno = err;
+    return ret < 0 ? -1 : 0;
+}
+
+// 出错路径上清理导出，保留调用者要检查的errno
+static void sysfs_unexport(int pin) {
+    char buffer[16];
+    int err = errno;
+    snprintf(buffer, sizeof(buffer), "%d", pin);
+    sysfs_write_file("/sys/class/gpio/unexport", buffer);
+    errno = err;
+}
+
+// *exported返回这条线是否由这里导出；已被他人导出的线关闭时要保留。
+// 失败返回-1，errno为导致失败的错误
+static int sysfs_open_line(int pin, int value, bool *exported) {
+    char path[64];
+    snprintf(path, sizeof(path), "/sys/class/gpio/gpio%d", pin);
+    
+    *exported = false;
+    if (access(path, F_OK) != 0) {
+        char buffer[16];
+        snprintf(buffer, sizeof(buffer), "%d", pin);
+        if (sysfs_write_file("/sys/class/gpio/export", buffer) < 0) return -1;
+        *exported = true;
+    }
+    
+    // 导出后udev异步修改权限，轮询代替固定等待
+    snprintf(path, sizeof(path), "/sys/class/gpio/gpio%d/direction", pin);
+    for (int waited = 0; ; waited++) {
+        // "high"/"low"同时设置方向和初始电平，避免毛刺
+        if (sysfs_write_file(path, value ? "high" : "low") == 0) break;
+        if (waited >= SYSFS_EXPORT_WAIT_MS) {
+            if (*exported) sysfs_unexport(pin);
+            *exported = false;
+            return -1;
+        }
+        usleep(1000);
+    }
+    
+    snprintf(path, sizeof(path), "/sys/class/gpio/gpio%d/value", pin);
+    int fd = open(path, O_WRONLY | O_CLOEXEC);
+    if (fd < 0 && *exported) {
+        sysfs_unexport(pin);
+        *exported = false;
+    }
+    return fd;
+}
+
+static int sysfs_open(st7735_gpio_t *gpio) {
+    for (int line = 0; line < ST7735_LINE_COUNT; line++) {
+        bool exported;
+        if (gpio->pins[line] < 0) continue;
+        gpio->value_fd[line] = sysfs_open_line(gpio->pins[line],
+                                               line_value(gpio->values, line), &exported);
+        if (exported) gpio->exported |= ST7735_LINE_BIT(line);
+        if (gpio->value_fd[line] < 0) {
+            // 片选被SPI控制器占用（EBUSY）时交给硬件片选，与chardev后端一致；
+            // 其他错误去掉片选也无济于事
+            if (line == ST7735_LINE_CS && errno == EBUSY) {
+                gpio->pins[line] = -1;
+                continue;
+            }
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// ===== 公共接口 =====
+
+int st7735_gpio_open(st7735_gpio_t *gpio, st7735_gpio_backend_t backend,
+                     const char *chip, const int pins[ST7735_LINE_COUNT],
+                     uint8_t initial) {
+    if (!gpio || !pins) return -1;
+    
+    memset(gpio, 0, sizeof(*gpio));
+    gpio->handle_fd = -1;
+    for (int line = 0; line < ST7735_LINE_COUNT; line++) {
+        gpio->pins[line] = pins[line];
+        gpio->value_fd[line] = -1;
+    }
+    gpio->values = initial;
+    
+    if (backend == ST7735_GPIO_AUTO || backend == ST7735_GPIO_CHARDEV) {
+        if (chardev_open(gpio, chip) == 0) {
+            gpio->backend = ST7735_GPIO_CHARDEV;
+            return 0;
+        }
+        if (backend == ST7735_GPIO_CHARDEV) {
+            fprintf(stderr, "Error: Failed to request GPIO lines from %s\n",
+                    chip ? chip : GPIO_DEFAULT_CHIP);
+            return -1;
+        }
+        fprintf(stderr, "Warning: Failed to request GPIO lines from %s, trying sysfs\n",
+                chip ? chip : GPIO_DEFAULT_CHIP);
+        // chardev_open可能已去掉片选，sysfs重新按调用者的配置尝试
+        gpio->pins[ST7735_LINE_CS] = pins[ST7735_LINE_CS];
+        backend = ST7735_GPIO_SYSFS;
+    }
+    
+    gpio->backend = backend;
+    if (backend == ST7735_GPIO_SYSFS && sysfs_open(gpio) < 0) {
+        fprintf(stderr, "Error: Failed to export GPIO lines via sysfs\n");
+        st7735_gpio_close(gpio);
+        return -1;
+    }
+    return 0;
+}
+
+void st7735_gpio_close(st7735_gpio_t *gpio) {
+    if (!gpio) return;
+    
+    if (gpio->handle_fd >= 0) {
+        close(gpio->handle_fd);
+        gpio->handle_fd = -1;
+    }
+    
+    for (int line = 0; line < ST7735_LINE_COUNT; line++) {
+        if (gpio->value_fd[line] >= 0) {
+            close(gpio->value_fd[line]);
+            gpio->value_fd[line] = -1;
+        }
+        if (gpio->exported & ST7735_LINE_BIT(line)) sysfs_unexport(gpio->pins[line]);
+    }
+    gpio->exported = 0;
+}
+
+void st7735_gpio_set_mask(st7735_gpio_t *gpio, uint8_t mask, uint8_t values) {
+    uint8_t next = (gpio->values & ~mask) | (values & mask);
+    uint8_t changed = next ^ gpio->values;
+    if (!changed) return;
+    
+    gpio->values = next;
+    gpio->toggles++;
+    if (gpio->backend == ST7735_GPIO_FAKE) return;
+    
+#if ST7735_STATS
+    uint64_t start = gpio_now_ns();
+#endif
+    switch (gpio->backend) {
+        case ST7735_GPIO_CHARDEV:
+            chardev_write(gpio);
+            break;
+        case ST7735_GPIO_SYSFS:
+            for (int line = 0; line < ST7735_LINE_COUNT; line++) {
+                if (!(changed & ST7735_LINE_BIT(line)) || gpio->value_fd[line] < 0) continue;
+                pwrite(gpio->value_fd[line], line_value(next, line) ? "1" : "0", 1, 0);
+                gpio->writes++;
+            }
+            break;
+        default:
+            break;
+    }
+#if ST7735_STATS
+    gpio->write_ns += gpio_now_ns() - start;
+#endif
+}
+
+void st7735_gpio_set(st7735_gpio_t *gpio, int line, int value) {
+    st7735_gpio_set_mask(gpio, ST7735_LINE_BIT(line),
+                         value ? ST7735_LINE_BIT(line) : 0);
+}
+
+const char *st7735_gpio_backend_name(st7735_gpio_backend_t backend) {
+    switch (backend) {
+        case ST7735_GPIO_CHARDEV: return "chardev";
+        case ST7735_GPIO_SYSFS:   return "sysfs";
+        case ST7735_GPIO_FAKE:    return "fake";
+        default:                  return "auto";
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef ST7735_GPIO_H
+#define ST7735_GPIO_H
+
+#include <stdint.h>
+
+// 运行统计（计数和计时），编译时-DST7735_STATS=0完全去掉
+#ifndef ST7735_STATS
+#define ST7735_STATS 1
+#endif
+
+// 控制线编号
+enum {
+    ST7735_LINE_RST = 0,
+    ST7735_LINE_DC,
+    ST7735_LINE_CS,
+    ST7735_LINE_BL,
+    ST7735_LINE_COUNT
+};
+
+#define ST7735_LINE_BIT(line)  (1u << (line))
+
+// GPIO后端
+typedef enum {
+    ST7735_GPIO_AUTO = 0,   // 优先字符设备，失败时退回sysfs
+    ST7735_GPIO_CHARDEV,    // /dev/gpiochipN 行句柄，一次ioctl设置所有线
+    ST7735_GPIO_SYSFS,      // /sys/class/gpio，value文件只打开一次
+    ST7735_GPIO_FAKE        // 纯内存，用于无硬件的测试和性能测量
+} st7735_gpio_backend_t;
+
+// GPIO句柄：初始化时申请一次，之后只做电平切换
+typedef struct {
+    st7735_gpio_backend_t backend;
+    int pins[ST7735_LINE_COUNT];        // BCM编号，-1表示未连接
+    uint8_t values;                     // 当前电平缓存（按ST7735_LINE_BIT）
+    int handle_fd;                      // chardev行句柄
+    uint8_t handle_index[ST7735_LINE_COUNT];
+    uint8_t handle_lines;
+    int value_fd[ST7735_LINE_COUNT];    // sysfs value文件
+    uint8_t exported;                   // 由本驱动导出的sysfs线（按ST7735_LINE_BIT），关闭时只取消这些
+    unsigned long writes;               // 实际发出的写操作（系统调用）次数
+    unsigned long toggles;              // 电平发生变化的次数
+    uint64_t write_ns;                  // 写操作累计耗时（ST7735_STATS）
+} st7735_gpio_t;
+
+// 申请控制线；pins为-1的线被忽略，initial为各线初始电平
+int st7735_gpio_open(st7735_gpio_t *gpio, st7735_gpio_backend_t backend,
+                     const char *chip, const int pins[ST7735_LINE_COUNT],
+                     uint8_t initial);
+void st7735_gpio_close(st7735_gpio_t *gpio);
+
+// 同时设置mask中的线，电平未变化时不产生系统调用
+void st7735_gpio_set_mask(st7735_gpio_t *gpio, uint8_t mask, uint8_t values);
+void st7735_gpio_set(st7735_gpio_t *gpio, int line, int value);
+
+const char *st7735_gpio_backend_name(st7735_gpio_backend_t backend);
+
+#endif // ST7735_GPIO_H
@@ -0,0 +1,645 @@
+#include "st7735_image.h"
+#include "st7735_pixel.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#ifdef ST7735_HAVE_PNG
+#include <png.h>
+#endif
+#ifdef ST7735_HAVE_JPEG
+#include <setjmp.h>
+#include <jpeglib.h>
+#endif
+
+// 源图尺寸上限，防止损坏的文件头申请巨大的行缓冲
+#define IMAGE_MAX_DIM 16384
+
+// ===== 图像源：逐行输出RGB888 =====
+
+typedef struct image_src {
+    uint32_t width;
+    uint32_t height;
+    // 读取下一行，失败返回-1
+    int (*read_row)(struct image_src *src, uint8_t *rgb);
+    // 目标尺寸确定后、第一次读取前调用；解码器可借此降低输出分辨率
+    int (*start)(struct image_src *src, uint32_t dst_w, uint32_t dst_h);
+    void (*close)(struct image_src *src);
+    FILE *fp;
+    // PPM/PGM
+    unsigned channels;
+    unsigned maxval;
+    uint8_t *raw;
+    // 内存RGB888
+    const uint8_t *mem;
+    uint32_t stride;
+    uint32_t row;
+    // PNG/JPEG解码器状态
+    void *priv;
+} image_src_t;
+
+static void src_close_file(image_src_t *src) {
+    free(src->raw);
+    if (src->fp) fclose(src->fp);
+}
+
+// ----- PPM (P6) / PGM (P5) -----
+
+// 读取文件头中的一个十进制数，跳过空白和注释
+static int ppm_number(FILE *fp, uint32_t *value, bool last) {
+    int c = fgetc(fp);
+    for (;;) {
+        if (c == '#') {
+            while (c != '\n' && c != EOF) c = fgetc(fp);
+        } else if (isspace(c)) {
+            c = fgetc(fp);
+        } else {
+            break;
+        }
+    }
+    if (!isdigit(c)) return -1;
+    
+    uint32_t v = 0;
+    while (isdigit(c)) {
+        if (v > 1000000) return -1;
+        v = v * 10 + (c - '0');
+        c = fgetc(fp);
+    }
+    // maxval之后恰好一个空白字符，随后是像素数据
+    if (last) {
+        if (!isspace(c)) return -1;
+    } else {
+        ungetc(c, fp);
+    }
+    *value = v;
+    return 0;
+}
+
+static int ppm_read_row(image_src_t *src, uint8_t *rgb) {
+    uint32_t w = src->width;
+    unsigned bytes = src->maxval > 255 ? 2 : 1;
+    size_t len = (size_t)w * src->channels * bytes;
+    
+    // 最常见的8位RGB直接读入输出行
+    if (src->channels == 3 && src->maxval == 255) {
+        return fread(rgb, 1, len, src->fp) == len ? 0 : -1;
+    }
+    if (fread(src->raw, 1, len, src->fp) != len) return -1;
+    
+    for (uint32_t i = 0; i < w * src->channels; i++) {
+        unsigned v = bytes == 2 ? (src->raw[i * 2] << 8) | src->raw[i * 2 + 1] : src->raw[i];
+        uint8_t v8 = src->maxval == 255 ? v : (uint8_t)((v * 255 + src->maxval / 2) / src->maxval);
+        if (src->channels == 3) {
+            rgb[i] = v8;
+        } else {
+            rgb[i * 3] = rgb[i * 3 + 1] = rgb[i * 3 + 2] = v8;
+        }
+    }
+    return 0;
+}
+
+static int ppm_open(image_src_t *src) {
+    char magic[2];
+    uint32_t maxval;
+    
+    if (fread(magic, 1, 2, src->fp) != 2 || magic[0] != 'P' ||
+        (magic[1] != '5' && magic[1] != '6') ||
+        ppm_number(src->fp, &src->width, false) < 0 ||
+        ppm_number(src->fp, &src->height, false) < 0 ||
+        ppm_number(src->fp, &maxval, true) < 0 ||
+        maxval == 0 || maxval > 65535) {
+        fprintf(stderr, "Error: Invalid PPM header\n");
+        return -1;
+    }
+    
+    src->channels = magic[1] == '6' ? 3 : 1;
+    src->maxval = maxval;
+    src->read_row = ppm_read_row;
+    src->close = src_close_file;
+    if (src->width == 0 || src->height == 0 || src->width > IMAGE_MAX_DIM) return -1;
+    
+    src->raw = (uint8_t *)malloc((size_t)src->width * src->channels * 2);
+    return src->raw ? 0 : -1;
+}
+
+// ----- PNG -----
+
+#ifdef ST7735_HAVE_PNG
+typedef struct {
+    png_structp png;
+    png_infop info;
+} png_priv_t;
+
+static int png_src_read_row(image_src_t *src, uint8_t *rgb) {
+    png_priv_t *p = (png_priv_t *)src->priv;
+    if (setjmp(png_jmpbuf(p->png))) return -1;
+    png_read_row(p->png, rgb, NULL);
+    return 0;
+}
+
+static void png_src_close(image_src_t *src) {
+    png_priv_t *p = (png_priv_t *)src->priv;
+    if (p) {
+        png_destroy_read_struct(&p->png, &p->info, NULL);
+        free(p);
+    }
+    src_close_file(src);
+}
+
+static int png_open(image_src_t *src) {
+    png_priv_t *p = (png_priv_t *)calloc(1, sizeof(*p));
+    if (!p) return -1;
+    src->priv = p;
+    src->close = png_src_close;
+    src->read_row = png_src_read_row;
+    
+    p->png = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    if (!p->png) return -1;
+    p->info = png_create_info_struct(p->png);
+    if (!p->info) return -1;
+    if (setjmp(png_jmpbuf(p->png))) return -1;
+    
+    png_init_io(p->png, src->fp);
+    png_read_info(p->png, p->info);
+    
+    // 隔行扫描的PNG需要整幅图像才能得到完整的行
+    if (png_get_interlace_type(p->png, p->info) != PNG_INTERLACE_NONE) {
+        fprintf(stderr, "Error: Interlaced PNG is not supported\n");
+        return -1;
+    }
+    
+    // 统一转换为8位RGB：调色板/灰度展开，去掉16位精度和alpha
+    int color = png_get_color_type(p->png, p->info);
+    if (color == PNG_COLOR_TYPE_PALETTE) png_set_palette_to_rgb(p->png);
+    if (color == PNG_COLOR_TYPE_GRAY || color == PNG_COLOR_TYPE_GRAY_ALPHA) {
+        png_set_expand_gray_1_2_4_to_8(p->png);
+        png_set_gray_to_rgb(p->png);
+    }
+    png_set_strip_16(p->png);
+    png_set_strip_alpha(p->png);
+    png_read_update_info(p->png, p->info);
+    
+    src->width = png_get_image_width(p->png, p->info);
+    src->height = png_get_image_height(p->png, p->info);
+    if (src->width > IMAGE_MAX_DIM || png_get_rowbytes(p->png, p->info) != src->width * 3) {
+        return -1;
+    }
+    return 0;
+}
+#endif
+
+// ----- JPEG -----
+
+#ifdef ST7735_HAVE_JPEG
+typedef struct {
+    struct jpeg_decompress_struct cinfo;
+    struct jpeg_error_mgr jerr;
+    jmp_buf jmp;
+    bool created;
+} jpeg_priv_t;
+
+static void jpeg_error_exit(j_common_ptr cinfo) {
+    jpeg_priv_t *p = (jpeg_priv_t *)cinfo->client_data;
+    char message[JMSG_LENGTH_MAX];
+    (*cinfo->err->format_message)(cinfo, message);
+    fprintf(stderr, "Error: JPEG: %s\n", message);
+    longjmp(p->jmp, 1);
+}
+
+// 按目标尺寸选择DCT缩放（1/2、1/4、1/8），解码量随之减少
+static int jpeg_src_start(image_src_t *src, uint32_t dst_w, uint32_t dst_h) {
+    jpeg_priv_t *p = (jpeg_priv_t *)src->priv;
+    if (setjmp(p->jmp)) return -1;
+    
+    unsigned denom = 8;
+    while (denom > 1 && ((src->width + denom - 1) / denom < dst_w ||
+                         (src->height + denom - 1) / denom < dst_h)) {
+        denom /= 2;
+    }
+    p->cinfo.scale_num = 1;
+    p->cinfo.scale_denom = denom;
+    p->cinfo.out_color_space = JCS_RGB;
+    jpeg_start_decompress(&p->cinfo);
+    
+    if (p->cinfo.output_components != 3) return -1;
+    src->width = p->cinfo.output_width;
+    src->height = p->cinfo.output_height;
+    return 0;
+}
+
+static int jpeg_src_read_row(image_src_t *src, uint8_t *rgb) {
+    jpeg_priv_t *p = (jpeg_priv_t *)src->priv;
+    if (setjmp(p->jmp)) return -1;
+    JSAMPROW row = rgb;
+    return jpeg_read_scanlines(&p->cinfo, &row, 1) == 1 ? 0 : -1;
+}
+
+static void jpeg_src_close(image_src_t *src) {
+    jpeg_priv_t *p = (jpeg_priv_t *)src->priv;
+    if (p) {
+        // 未读完的图像直接丢弃
+        if (p->created) jpeg_destroy_decompress(&p->cinfo);
+        free(p);
+    }
+    src_close_file(src);
+}
+
+static int jpeg_open(image_src_t *src) {
+    jpeg_priv_t *p = (jpeg_priv_t *)calloc(1, sizeof(*p));
+    if (!p) return -1;
+    src->priv = p;
+    src->close = jpeg_src_close;
+    src->read_row = jpeg_src_read_row;
+    src->start = jpeg_src_start;
+    
+    p->cinfo.err = jpeg_std_error(&p->jerr);
+    p->jerr.error_exit = jpeg_error_exit;
+    p->cinfo.client_data = p;
+    if (setjmp(p->jmp)) return -1;
+    
+    jpeg_create_decompress(&p->cinfo);
+    p->created = true;
+    jpeg_stdio_src(&p->cinfo, src->fp);
+    jpeg_read_header(&p->cinfo, TRUE);
+    
+    src->width = p->cinfo.image_width;
+    src->height = p->cinfo.image_height;
+    return src->width > IMAGE_MAX_DIM ? -1 : 0;
+}
+#endif
+
+// 按文件头识别格式
+static int src_open_file(image_src_t *src, const char *path) {
+    uint8_t magic[4] = { 0 };
+    
+    memset(src, 0, sizeof(*src));
+    src->fp = fopen(path, "rb");
+    if (!src->fp) {
+        fprintf(stderr, "Error: Failed to open image %s\n", path);
+        return -1;
+    }
+    size_t n = fread(magic, 1, sizeof(magic), src->fp);
+    rewind(src->fp);
+    src->close = src_close_file;
+    
+    int ret = -1;
+    if (n >= 2 && magic[0] == 'P' && (magic[1] == '5' || magic[1] == '6')) {
+        ret = ppm_open(src);
+    } else if (n >= 4 && magic[0] == 0x89 && magic[1] == 'P' && magic[2] == 'N' && magic[3] == 'G') {
+#ifdef ST7735_HAVE_PNG
+        ret = png_open(src);
+#else
+        fprintf(stderr, "Error: PNG support not compiled in\n");
+#endif
+    } else if (n >= 2 && magic[0] == 0xFF && magic[1] == 0xD8) {
+#ifdef ST7735_HAVE_JPEG
+        ret = jpeg_open(src);
+#else
+        fprintf(stderr, "Error: JPEG support not compiled in\n");
+#endif
+    } else {
+        fprintf(stderr, "Error: Unknown image format %s\n", path);
+    }
+    
+    if (ret < 0) src->close(src);
+    return ret;
+}
+
+static int mem_read_row(image_src_t *src, uint8_t *rgb) {
+    if (src->row >= src->height) return -1;
+    memcpy(rgb, src->mem + (size_t)src->row++ * src->stride, (size_t)src->width * 3);
+    return 0;
+}
+
+static void mem_close(image_src_t *src) {
+    (void)src;
+}
+
+// ===== 定点缩放 =====
+
+// 缩小时取区域平均（box），放大时线性插值；两个方向分别选择。
+// 只保留一行源图、两行水平缩放结果和一行累加器
+typedef struct {
+    uint32_t src_w, src_h;
+    uint32_t dst_w, dst_h;
+    bool x_box, y_box;
+    uint32_t *x0;           // box：目标列j覆盖源列[x0[j], x0[j+1])；插值：左侧源列
+    uint32_t *xinv;         // box：65536/列数
+    uint8_t *xf;            // 插值：右侧源列的权重（8位小数）
+    uint8_t *src_row;
+    uint8_t *rows[2];       // 水平缩放后的行
+    int64_t row_index[2];   // rows[]对应的源行号，-1表示空
+    uint32_t *acc;          // 垂直box的累加行
+    uint32_t src_y;         // 已读取的源行数
+    uint32_t dst_y;         // 已输出的目标行数
+} scaler_t;
+
+static void scaler_free(scaler_t *s) {
+    free(s->x0);
+    free(s->xinv);
+    free(s->xf);
+    free(s->src_row);
+    free(s->rows[0]);
+    free(s->rows[1]);
+    free(s->acc);
+}
+
+static int scaler_init(scaler_t *s, uint32_t src_w, uint32_t src_h, uint32_t dst_w, uint32_t dst_h) {
+    memset(s, 0, sizeof(*s));
+    s->src_w = src_w;
+    s->src_h = src_h;
+    s->dst_w = dst_w;
+    s->dst_h = dst_h;
+    s->x_box = src_w >= dst_w;
+    s->y_box = src_h >= dst_h;
+    s->row_index[0] = s->row_index[1] = -1;
+    
+    s->x0 = (uint32_t *)malloc((dst_w + 1) * sizeof(uint32_t));
+    s->xinv = (uint32_t *)malloc(dst_w * sizeof(uint32_t));
+    s->xf = (uint8_t *)malloc(dst_w);
+    s->src_row = (uint8_t *)malloc((size_t)src_w * 3);
+    s->rows[0] = (uint8_t *)malloc(dst_w * 3);
+    s->rows[1] = (uint8_t *)malloc(dst_w * 3);
+    s->acc = (uint32_t *)malloc(dst_w * 3 * sizeof(uint32_t));
+    if (!s->x0 || !s->xinv || !s->xf || !s->src_row || !s->rows[0] || !s->rows[1] || !s->acc) {
+        scaler_free(s);
+        return -1;
+    }
+    
+    if (s->x_box) {
+        for (uint32_t j = 0; j <= dst_w; j++) {
+            s->x0[j] = (uint64_t)j * src_w / dst_w;
+        }
+        for (uint32_t j = 0; j < dst_w; j++) {
+            uint32_t n = s->x0[j + 1] - s->x0[j];
+            s->xinv[j] = (65536 + n / 2) / n;
+        }
+    } else {
+        // 像素中心对齐：sx = (j + 0.5) * src_w / dst_w - 0.5
+        for (uint32_t j = 0; j < dst_w; j++) {
+            int64_t sx = ((int64_t)(2 * j + 1) * src_w * 256) / (2 * dst_w) - 128;
+            if (sx < 0) sx = 0;
+            s->x0[j] = sx >> 8;
+            s->xf[j] = sx & 0xFF;
+            if (s->x0[j] >= src_w - 1) {
+                s->x0[j] = src_w - 1;
+                s->xf[j] = 0;
+            }
+        }
+    }
+    return 0;
+}
+
+// 一行源图缩放到目标宽度
+static void scale_row_x(const scaler_t *s, const uint8_t *in, uint8_t *out) {
+    if (s->src_w == s->dst_w) {
+        memcpy(out, in, s->dst_w * 3);
+        return;
+    }
+    
+    if (s->x_box) {
+        for (uint32_t j = 0; j < s->dst_w; j++) {
+            const uint8_t *p = in + s->x0[j] * 3;
+            const uint8_t *end = in + s->x0[j + 1] * 3;
+            uint32_t r = 0, g = 0, b = 0;
+            for (; p < end; p += 3) {
+                r += p[0];
+                g += p[1];
+                b += p[2];
+            }
+            uint32_t inv = s->xinv[j];
+            out[j * 3]     = (r * inv + 32768) >> 16;
+            out[j * 3 + 1] = (g * inv + 32768) >> 16;
+            out[j * 3 + 2] = (b * inv + 32768) >> 16;
+        }
+        return;
+    }
+    
+    for (uint32_t j = 0; j < s->dst_w; j++) {
+        const uint8_t *p = in + s->x0[j] * 3;
+        const uint8_t *q = s->xf[j] ? p + 3 : p;
+        unsigned f = s->xf[j];
+        for (int c = 0; c < 3; c++) {
+            out[j * 3 + c] = (p[c] * (256 - f) + q[c] * f + 128) >> 8;
+        }
+    }
+}
+
+static int read_scaled_row(scaler_t *s, image_src_t *src, uint8_t *out) {
+    if (s->src_y >= s->src_h || src->read_row(src, s->src_row) < 0) return -1;
+    s->src_y++;
+    scale_row_x(s, s->src_row, out);
+    return 0;
+}
+
+// 输出下一行目标图像（RGB888，dst_w个像素）
+static int scaler_next_row(scaler_t *s, image_src_t *src, uint8_t *out) {
+    uint32_t r = s->dst_y++;
+    uint32_t w3 = s->dst_w * 3;
+    
+    if (s->y_box) {
+        uint32_t end = (uint64_t)(r + 1) * s->src_h / s->dst_h;
+        uint32_t n = end - s->src_y;
+        if (n == 1) return read_scaled_row(s, src, out);
+        
+        memset(s->acc, 0, w3 * sizeof(uint32_t));
+        while (s->src_y < end) {
+            if (read_scaled_row(s, src, s->rows[0]) < 0) return -1;
+            for (uint32_t k = 0; k < w3; k++) s->acc[k] += s->rows[0][k];
+        }
+        uint32_t inv = (65536 + n / 2) / n;
+        for (uint32_t k = 0; k < w3; k++) {
+            out[k] = (s->acc[k] * inv + 32768) >> 16;
+        }
+        return 0;
+    }
+    
+    // 垂直插值：保留源行i和i+1
+    int64_t sy = ((int64_t)(2 * r + 1) * s->src_h * 256) / (2 * s->dst_h) - 128;
+    if (sy < 0) sy = 0;
+    int64_t i = sy >> 8;
+    unsigned f = sy & 0xFF;
+    int64_t next = i + 1 < s->src_h ? i + 1 : i;
+    
+    while (s->row_index[1] < next) {
+        uint8_t *tmp = s->rows[0];
+        s->rows[0] = s->rows[1];
+        s->rows[1] = tmp;
+        s->row_index[0] = s->row_index[1];
+        if (read_scaled_row(s, src, s->rows[1]) < 0) return -1;
+        s->row_index[1] = s->src_y - 1;
+    }
+    
+    if (next == i || f == 0) {
+        memcpy(out, s->rows[next == i ? 1 : 0], w3);
+        return 0;
+    }
+    const uint8_t *a = s->rows[0];
+    const uint8_t *b = s->rows[1];
+    for (uint32_t k = 0; k < w3; k++) {
+        out[k] = (a[k] * (256 - f) + b[k] * f + 128) >> 8;
+    }
+    return 0;
+}
+
+// ===== 量化并写入framebuffer =====
+
+static inline uint8_t clamp8(int v) {
+    return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+
+// Floyd-Steinberg：误差以1/16为单位保存在当前行和下一行
+static void diffuse_row(uint16_t *dst, const uint8_t *rgb, uint32_t n,
+                        int16_t *err_cur, int16_t *err_next) {
+    static const uint8_t keep_mask[3] = { 0xF8, 0xFC, 0xF8 };
+    static const uint8_t shift[3] = { 5, 6, 5 };
+    
+    memset(err_next, 0, (n + 2) * 3 * sizeof(int16_t));
+    for (uint32_t i = 0; i < n; i++) {
+        uint8_t q[3];
+        for (int c = 0; c < 3; c++) {
+            int v = clamp8(rgb[i * 3 + c] + err_cur[(i + 1) * 3 + c] / 16);
+            q[c] = v & keep_mask[c];
+            // 面板把截断后的值按高位复制扩展，误差以扩展后的值计算
+            int e = v - (q[c] | (q[c] >> shift[c]));
+            err_cur[(i + 2) * 3 + c] += e * 7;
+            err_next[i * 3 + c] += e * 3;
+            err_next[(i + 1) * 3 + c] += e * 5;
+            err_next[(i + 2) * 3 + c] += e;
+        }
+        dst[i] = (uint16_t)((q[0] << 8) | (q[1] << 3) | (q[2] >> 3));
+    }
+}
+
+static void fit_size(const st7735_t *dev, uint32_t sw, uint32_t sh,
+                     const st7735_image_opts_t *opts, uint32_t *dw, uint32_t *dh) {
+    uint32_t w = opts->width;
+    uint32_t h = opts->height;
+    
+    if (!w && !h) {
+        // 适配当前裁剪区域（未设置时为整屏）
+        uint32_t cw = dev->clip.x1 - dev->clip.x0;
+        uint32_t ch = dev->clip.y1 - dev->clip.y0;
+        w = cw;
+        h = (uint64_t)sh * w / sw;
+        if (h > ch) {
+            h = ch;
+            w = (uint64_t)sw * h / sh;
+        }
+    } else if (!w) {
+        w = (uint64_t)sw * h / sh;
+    } else if (!h) {
+        h = (uint64_t)sh * w / sw;
+    }
+    *dw = w ? w : 1;
+    *dh = h ? h : 1;
+}
+
+static int draw_src(st7735_t *dev, image_src_t *src, int x, int y,
+                    const st7735_image_opts_t *opts) {
+    static const st7735_image_opts_t defaults = { 0, 0, ST7735_DITHER_NONE };
+    if (!opts) opts = &defaults;
+    if (src->width == 0 || src->height == 0) return -1;
+    
+    uint32_t dst_w, dst_h;
+    fit_size(dev, src->width, src->height, opts, &dst_w, &dst_h);
+    if (dst_w > IMAGE_MAX_DIM || dst_h > IMAGE_MAX_DIM) return -1;
+    if (src->start && src->start(src, dst_w, dst_h) < 0) return -1;
+    
+    scaler_t s;
+    if (scaler_init(&s, src->width, src->height, dst_w, dst_h) < 0) return -1;
+    
+    // 平移到屏幕坐标，水平方向的可见范围
+    const st7735_clip_t *clip = &dev->clip;
+    x += clip->ox;
+    y += clip->oy;
+    int xa = x < clip->x0 ? clip->x0 : x;
+    int xb = x + (int)dst_w > clip->x1 ? clip->x1 : x + (int)dst_w;
+    uint32_t visible = xb > xa ? xb - xa : 0;
+    
+    uint8_t *line = (uint8_t *)malloc(dst_w * 3);
+    int16_t *err[2] = { NULL, NULL };
+    if (opts->dither == ST7735_DITHER_DIFFUSION) {
+        err[0] = (int16_t *)calloc((visible + 2) * 3, sizeof(int16_t));
+        err[1] = (int16_t *)calloc((visible + 2) * 3, sizeof(int16_t));
+    }
+    int ret = line && (opts->dither != ST7735_DITHER_DIFFUSION || (err[0] && err[1])) ? 0 : -1;
+    
+    int ya = -1, yb = -1;
+    for (uint32_t r = 0; ret == 0 && r < dst_h; r++) {
+        int sy = y + (int)r;
+        // 裁剪区域以下的行不再解码
+        if (sy >= clip->y1) break;
+        if (scaler_next_row(&s, src, line) < 0) {
+            ret = -1;
+            break;
+        }
+        if (sy < clip->y0 || visible == 0) continue;
+        
+        uint16_t *dst = dev->framebuffer + sy * dev->width + xa;
+        const uint8_t *rgb = line + (xa - x) * 3;
+        switch (opts->dither) {
+            case ST7735_DITHER_ORDERED:
+                st7735_rgb888_to_565_dither(dst, rgb, visible, xa, sy);
+                break;
+            case ST7735_DITHER_DIFFUSION: {
+                diffuse_row(dst, rgb, visible, err[0], err[1]);
+                int16_t *tmp = err[0];
+                err[0] = err[1];
+                err[1] = tmp;
+                break;
+            }
+            default:
+                st7735_rgb888_to_565(dst, rgb, visible);
+                break;
+        }
+        if (ya < 0) ya = sy;
+        yb = sy + 1;
+    }
+    
+    if (ya >= 0) st7735_mark_dirty(dev, xa, ya, visible, yb - ya);
+    
+    free(err[0]);
+    free(err[1]);
+    free(line);
+    scaler_free(&s);
+    return ret;
+}
+
+// ===== 公共接口 =====
+
+int st7735_image_info(const char *path, uint32_t *width, uint32_t *height) {
+    image_src_t src;
+    if (!path || src_open_file(&src, path) < 0) return -1;
+    if (width) *width = src.width;
+    if (height) *height = src.height;
+    src.close(&src);
+    return 0;
+}
+
+int st7735_draw_image(st7735_t *dev, const char *path, int x, int y,
+                      const st7735_image_opts_t *opts) {
+    image_src_t src;
+    if (!dev || !dev->framebuffer || !path) return -1;
+    if (src_open_file(&src, path) < 0) return -1;
+    
+    int ret = draw_src(dev, &src, x, y, opts);
+    src.close(&src);
+    return ret;
+}
+
+int st7735_draw_rgb888(st7735_t *dev, int x, int y, const uint8_t *rgb,
+                       uint32_t width, uint32_t height, uint32_t stride,
+                       const st7735_image_opts_t *opts) {
+    if (!dev || !dev->framebuffer || !rgb || width > IMAGE_MAX_DIM) return -1;
+    
+    image_src_t src;
+    memset(&src, 0, sizeof(src));
+    src.width = width;
+    src.height = height;
+    src.mem = rgb;
+    src.stride = stride ? stride : width * 3;
+    src.read_row = mem_read_row;
+    src.close = mem_close;
+    return draw_src(dev, &src, x, y, opts);
+}
@@ -0,0 +1,36 @@
+#ifndef ST7735_IMAGE_H
+#define ST7735_IMAGE_H
+
+#include <stdint.h>
+#include "st7735.h"
+
+// 图像绘制：逐行读取源图，定点缩放后转换为RGB565直接写入framebuffer。
+// 内存只占一行源图和几行目标宽度的缓冲，与图像总大小无关。
+// 支持PPM/PGM（P6/P5）；编译时找到libpng/libjpeg则同时支持PNG/JPEG
+
+typedef enum {
+    ST7735_DITHER_NONE = 0,     // 直接截断
+    ST7735_DITHER_ORDERED,      // 4x4有序抖动，无状态，适合动画
+    ST7735_DITHER_DIFFUSION     // Floyd-Steinberg误差扩散，静态图片效果最好
+} st7735_dither_t;
+
+typedef struct {
+    // 目标尺寸：都为0时保持比例缩放到当前裁剪区域内；只给一个时另一个按比例
+    uint16_t width;
+    uint16_t height;
+    st7735_dither_t dither;
+} st7735_image_opts_t;
+
+// 读取图像文件头得到原始尺寸，失败返回-1
+int st7735_image_info(const char *path, uint32_t *width, uint32_t *height);
+
+// 绘制图像文件，左上角在视口坐标(x, y)，裁剪区域外的部分不绘制；opts为NULL时使用默认值
+int st7735_draw_image(st7735_t *dev, const char *path, int x, int y,
+                      const st7735_image_opts_t *opts);
+
+// 绘制内存中的RGB888图像（例如别处渲染好的图表），stride为每行字节数
+int st7735_draw_rgb888(st7735_t *dev, int x, int y, const uint8_t *rgb,
+                       uint32_t width, uint32_t height, uint32_t stride,
+                       const st7735_image_opts_t *opts);
+
+#endif // ST7735_IMAGE_H
@@ -0,0 +1,51 @@
+#include "st7735_mock.h"
+#include <string.h>
+
+static int mock_transfer(void *ctx, int dc, struct spi_ioc_transfer *xfer, unsigned n) {
+    st7735_mock_t *mock = (st7735_mock_t *)ctx;
+    
+    mock->ioctls++;
+    mock->transfers += n;
+    if (dc != mock->last_dc) {
+        mock->dc_switches++;
+        mock->last_dc = dc;
+    }
+    for (unsigned i = 0; i < n; i++) {
+        mock->bytes += xfer[i].len;
+        if (!dc) mock->cmd_bytes += xfer[i].len;
+        // 读命令得到全0，驱动会当作读不到状态
+        if (xfer[i].rx_buf) memset((void *)(unsigned long)xfer[i].rx_buf, 0, xfer[i].len);
+    }
+    return 0;
+}
+
+void st7735_mock_reset(st7735_mock_t *mock) {
+    memset(mock, 0, sizeof(*mock));
+    mock->last_dc = -1;
+}
+
+st7735_transport_t st7735_mock_transport(st7735_mock_t *mock) {
+    st7735_mock_reset(mock);
+    return (st7735_transport_t){ .transfer = mock_transfer, .ctx = mock, .max_transfer = 0 };
+}
+
+double st7735_mock_bus_ns(const st7735_mock_t *mock, double spi_hz) {
+    return spi_hz > 0 ? mock->bytes * 8.0 * 1e9 / spi_hz : 0;
+}
+
+static int vpanel_transfer(void *ctx, int dc, struct spi_ioc_transfer *xfer, unsigned n) {
+    st7735_vpanel_t *vp = (st7735_vpanel_t *)ctx;
+    
+    for (unsigned i = 0; i < n; i++) {
+        if (xfer[i].rx_buf) {
+            st7735_vpanel_read(vp, (uint8_t *)(unsigned long)xfer[i].rx_buf, xfer[i].len);
+        } else if (xfer[i].tx_buf) {
+            st7735_vpanel_write(vp, dc, (const uint8_t *)(unsigned long)xfer[i].tx_buf, xfer[i].len);
+        }
+    }
+    return 0;
+}
+
+st7735_transport_t st7735_vpanel_transport(st7735_vpanel_t *vp) {
+    return (st7735_transport_t){ .transfer = vpanel_transfer, .ctx = vp, .max_transfer = 0 };
+}
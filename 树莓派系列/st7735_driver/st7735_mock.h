@@ -0,0 +1,29 @@
+#ifndef ST7735_MOCK_H
+#define ST7735_MOCK_H
+
+#include <stdint.h>
+#include "st7735.h"
+#include "st7735_vpanel.h"
+
+// 模拟spidev：只记录线上流量，不需要硬件
+typedef struct {
+    uint64_t ioctls;        // SPI_IOC_MESSAGE调用次数
+    uint64_t transfers;     // spi_ioc_transfer个数
+    uint64_t bytes;         // 总字节数
+    uint64_t cmd_bytes;     // 其中DC为低（命令）的字节数
+    uint64_t dc_switches;   // DC电平变化次数
+    int last_dc;
+} st7735_mock_t;
+
+// 清零计数，返回可放入st7735_config_t的传输接口
+st7735_transport_t st7735_mock_transport(st7735_mock_t *mock);
+void st7735_mock_reset(st7735_mock_t *mock);
+
+// 按给定SPI时钟估算发送这些字节所需的时间（不含ioctl间隙）
+double st7735_mock_bus_ns(const st7735_mock_t *mock, double spi_hz);
+
+// 把传输接到虚拟面板：发送的字节交给模拟器解释，读传输从模拟器取应答。
+// 硬件复位线不经过传输接口，rst_pin设为-1时驱动改发SWRESET
+st7735_transport_t st7735_vpanel_transport(st7735_vpanel_t *vp);
+
+#endif // ST7735_MOCK_H
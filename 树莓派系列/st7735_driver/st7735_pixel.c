@@ -0,0 +1,629 @@
+#include "st7735_pixel.h"
+#include <string.h>
+#include <stdbool.h>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// 以64位字访问像素缓冲时避免违反严格别名规则
+typedef uint64_t __attribute__((may_alias)) u64_alias;
+
+// 64位字内同时交换4个像素的高低字节
+static inline uint64_t swap16x4(uint64_t v) {
+    return ((v & 0x00FF00FF00FF00FFull) << 8) | ((v >> 8) & 0x00FF00FF00FF00FFull);
+}
+
+void st7735_swap16(uint16_t *dst, const uint16_t *src, size_t n) {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    memcpy(dst, src, n * sizeof(uint16_t));
+#else
+    size_t i = 0;
+    
+#if defined(__ARM_NEON)
+    for (; i + 8 <= n; i += 8) {
+        uint8x16_t v = vld1q_u8((const uint8_t *)(src + i));
+        vst1q_u8((uint8_t *)(dst + i), vrev16q_u8(v));
+    }
+#elif defined(__SSE2__)
+    for (; i + 8 <= n; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        _mm_storeu_si128((__m128i *)(dst + i), v);
+    }
+#endif
+    
+    // 无SIMD时按64位字处理；memcpy避免非对齐访问
+    for (; i + 4 <= n; i += 4) {
+        uint64_t v;
+        memcpy(&v, src + i, sizeof(v));
+        v = swap16x4(v);
+        memcpy(dst + i, &v, sizeof(v));
+    }
+    
+    for (; i < n; i++) {
+        dst[i] = (uint16_t)((src[i] << 8) | (src[i] >> 8));
+    }
+#endif
+}
+
+// 禁止编译器自动向量化，保持逐像素的对比基准
+__attribute__((optimize("no-tree-vectorize")))
+void st7735_swap16_scalar(uint16_t *dst, const uint16_t *src, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = (uint16_t)((src[i] << 8) | (src[i] >> 8));
+    }
+}
+
+// 单个RGB565像素截断为12位
+static inline uint16_t rgb444(uint16_t p) {
+    return ((p >> 4) & 0x0F00) | ((p >> 3) & 0x00F0) | ((p >> 1) & 0x000F);
+}
+
+static inline size_t pack444_tail(uint8_t *dst, const uint16_t *src, size_t n) {
+    size_t out = 0;
+    size_t i = 0;
+    
+    for (; i + 2 <= n; i += 2) {
+        uint16_t a = rgb444(src[i]);
+        uint16_t b = rgb444(src[i + 1]);
+        dst[out++] = a >> 4;
+        dst[out++] = ((a & 0x0F) << 4) | (b >> 8);
+        dst[out++] = b & 0xFF;
+    }
+    if (i < n) {
+        uint16_t a = rgb444(src[i]);
+        dst[out++] = a >> 4;
+        dst[out++] = (a & 0x0F) << 4;
+    }
+    return out;
+}
+
+size_t st7735_pack444(uint8_t *dst, const uint16_t *src, size_t n) {
+    size_t i = 0;
+    size_t out = 0;
+    
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    // 64位字内4个像素同时截断，再拼成48位大端写出6字节。
+    // 每组先读8字节后写6字节，原地打包时写入位置总在未读数据之前
+    for (; i + 4 <= n; i += 4) {
+        uint64_t v;
+        memcpy(&v, src + i, sizeof(v));
+        v = ((v >> 4) & 0x0F000F000F000F00ull) |
+            ((v >> 3) & 0x00F000F000F000F0ull) |
+            ((v >> 1) & 0x000F000F000F000Full);
+        uint64_t w = ((v & 0xFFF) << 52) | (((v >> 16) & 0xFFF) << 40) |
+                     (((v >> 32) & 0xFFF) << 28) | (((v >> 48) & 0xFFF) << 16);
+        w = __builtin_bswap64(w);
+        memcpy(dst + out, &w, 6);
+        out += 6;
+    }
+#endif
+    
+    return out + pack444_tail(dst + out, src + i, n - i);
+}
+
+// 逐像素参考实现，仅用于性能对比
+__attribute__((optimize("no-tree-vectorize")))
+size_t st7735_pack444_scalar(uint8_t *dst, const uint16_t *src, size_t n) {
+    return pack444_tail(dst, src, n);
+}
+
+static const uint8_t bayer4[4][4] = {
+    {  0,  8,  2, 10 },
+    { 12,  4, 14,  6 },
+    {  3, 11,  1,  9 },
+    { 15,  7, 13,  5 },
+};
+
+// 通道扩展到8位，加阈值后取高4位
+static inline unsigned dither4(unsigned v8, unsigned d) {
+    unsigned q = (v8 + d) >> 4;
+    return q > 15 ? 15 : q;
+}
+
+void st7735_dither444(uint16_t *dst, const uint16_t *src, size_t n, unsigned x, unsigned y) {
+    const uint8_t *row = bayer4[y & 3];
+    
+    for (size_t i = 0; i < n; i++) {
+        uint16_t p = src[i];
+        unsigned d = row[(x + i) & 3];
+        unsigned r8 = ((p >> 8) & 0xF8) | (p >> 13);
+        unsigned g8 = ((p >> 3) & 0xFC) | ((p >> 9) & 0x03);
+        unsigned b8 = ((p << 3) & 0xF8) | ((p >> 2) & 0x07);
+        // 放回RGB565各通道的高4位
+        dst[i] = (dither4(r8, d) << 12) | (dither4(g8, d) << 7) | (dither4(b8, d) << 1);
+    }
+}
+
+static inline uint16_t rgb565(unsigned r, unsigned g, unsigned b) {
+    return (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+}
+
+#if defined(__ARM_NEON)
+// 16个像素：vld3解交织后用移位插入拼成RGB565
+static inline void rgb888x16_to_565(uint16_t *dst, uint8x16x3_t v) {
+    uint16x8_t lo = vshll_n_u8(vget_low_u8(v.val[0]), 8);
+    uint16x8_t hi = vshll_n_u8(vget_high_u8(v.val[0]), 8);
+    lo = vsriq_n_u16(lo, vshll_n_u8(vget_low_u8(v.val[1]), 8), 5);
+    hi = vsriq_n_u16(hi, vshll_n_u8(vget_high_u8(v.val[1]), 8), 5);
+    lo = vsriq_n_u16(lo, vshll_n_u8(vget_low_u8(v.val[2]), 8), 11);
+    hi = vsriq_n_u16(hi, vshll_n_u8(vget_high_u8(v.val[2]), 8), 11);
+    vst1q_u16(dst, lo);
+    vst1q_u16(dst + 8, hi);
+}
+#endif
+
+void st7735_rgb888_to_565(uint16_t *dst, const uint8_t *src, size_t n) {
+    size_t i = 0;
+    
+#if defined(__ARM_NEON)
+    for (; i + 16 <= n; i += 16) {
+        rgb888x16_to_565(dst + i, vld3q_u8(src + i * 3));
+    }
+#endif
+    
+    // 其余平台交给编译器自动向量化
+    for (; i < n; i++) {
+        dst[i] = rgb565(src[i * 3], src[i * 3 + 1], src[i * 3 + 2]);
+    }
+}
+
+// 逐像素参考实现，仅用于性能对比
+__attribute__((optimize("no-tree-vectorize")))
+void st7735_rgb888_to_565_scalar(uint16_t *dst, const uint8_t *src, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = rgb565(src[i * 3], src[i * 3 + 1], src[i * 3 + 2]);
+    }
+}
+
+static inline unsigned add_sat8(unsigned v, unsigned d) {
+    v += d;
+    return v > 255 ? 255 : v;
+}
+
+void st7735_rgb888_to_565_dither(uint16_t *dst, const uint8_t *src, size_t n,
+                                 unsigned x, unsigned y) {
+    const uint8_t *row = bayer4[y & 3];
+    // 阈值覆盖被截断的位：R/B截3位（0..7），G截2位（0..3）
+    uint8_t d5[16], d6[16];
+    for (int k = 0; k < 16; k++) {
+        d5[k] = row[(x + k) & 3] >> 1;
+        d6[k] = row[(x + k) & 3] >> 2;
+    }
+    size_t i = 0;
+    
+#if defined(__ARM_NEON)
+    uint8x16_t t5 = vld1q_u8(d5);
+    uint8x16_t t6 = vld1q_u8(d6);
+    for (; i + 16 <= n; i += 16) {
+        uint8x16x3_t v = vld3q_u8(src + i * 3);
+        v.val[0] = vqaddq_u8(v.val[0], t5);
+        v.val[1] = vqaddq_u8(v.val[1], t6);
+        v.val[2] = vqaddq_u8(v.val[2], t5);
+        rgb888x16_to_565(dst + i, v);
+    }
+#endif
+    
+    for (; i < n; i++) {
+        unsigned k = i & 15;
+        dst[i] = rgb565(add_sat8(src[i * 3], d5[k]), add_sat8(src[i * 3 + 1], d6[k]),
+                        add_sat8(src[i * 3 + 2], d5[k]));
+    }
+}
+
+// 查表没有合适的SIMD指令，每次取4个索引拼成64位字写出，交换字节序也按字进行
+static inline uint64_t lut16x4(const uint8_t *src, const uint16_t *palette) {
+    return (uint64_t)palette[src[0]] | (uint64_t)palette[src[1]] << 16 |
+           (uint64_t)palette[src[2]] << 32 | (uint64_t)palette[src[3]] << 48;
+}
+
+void st7735_lut16(uint16_t *dst, const uint8_t *src, size_t n, const uint16_t palette[256]) {
+    size_t i = 0;
+    
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    for (; i + 4 <= n; i += 4) {
+        uint64_t v = lut16x4(src + i, palette);
+        memcpy(dst + i, &v, sizeof(v));
+    }
+#endif
+    
+    for (; i < n; i++) {
+        dst[i] = palette[src[i]];
+    }
+}
+
+void st7735_lut16_swap(uint16_t *dst, const uint8_t *src, size_t n, const uint16_t palette[256]) {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    st7735_lut16(dst, src, n, palette);
+#else
+    size_t i = 0;
+    
+    for (; i + 4 <= n; i += 4) {
+        uint64_t v = swap16x4(lut16x4(src + i, palette));
+        memcpy(dst + i, &v, sizeof(v));
+    }
+    
+    for (; i < n; i++) {
+        uint16_t p = palette[src[i]];
+        dst[i] = (uint16_t)((p << 8) | (p >> 8));
+    }
+#endif
+}
+
+// 第i个源像素：RGB565缓冲或调色板索引，swap时交换字节序
+static inline uint16_t upscale_src(const uint16_t *src, const uint8_t *idx,
+                                   const uint16_t *palette, size_t i, bool swap) {
+    uint16_t p = idx ? palette[idx[i]] : src[i];
+    return swap ? (uint16_t)((p << 8) | (p >> 8)) : p;
+}
+
+// 每个源像素复制scale份；调用处的src/idx/swap都是常量，编译器展开成各自的循环
+static inline void upscale(uint16_t *dst, const uint16_t *src, const uint8_t *idx,
+                           const uint16_t *palette, size_t n, unsigned scale,
+                           unsigned phase, bool swap) {
+    size_t i = 0;
+    
+    // 区域从源像素中间开始：第一个源像素只剩scale - phase份
+    if (phase) {
+        uint16_t p = upscale_src(src, idx, palette, 0, swap);
+        for (; phase < scale && n > 0; phase++, n--) *dst++ = p;
+        i = 1;
+    }
+    
+#if defined(__ARM_NEON) || defined(__SSE2__)
+    // RGB565源每次8个像素：与自身交错一次是2倍，两次是4倍
+    if (!idx && (scale == 2 || scale == 4)) {
+        for (; n >= 8 * scale; n -= 8 * scale, i += 8) {
+#if defined(__ARM_NEON)
+            uint16x8_t v = vld1q_u16(src + i);
+            if (swap) v = vreinterpretq_u16_u8(vrev16q_u8(vreinterpretq_u8_u16(v)));
+            uint16x8x2_t d = vzipq_u16(v, v);
+            if (scale == 2) {
+                vst1q_u16(dst, d.val[0]);
+                vst1q_u16(dst + 8, d.val[1]);
+            } else {
+                for (int k = 0; k < 2; k++) {
+                    uint16x8x2_t q = vzipq_u16(d.val[k], d.val[k]);
+                    vst1q_u16(dst + k * 16, q.val[0]);
+                    vst1q_u16(dst + k * 16 + 8, q.val[1]);
+                }
+            }
+#else
+            __m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+            if (swap) v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+            __m128i lo = _mm_unpacklo_epi16(v, v);
+            __m128i hi = _mm_unpackhi_epi16(v, v);
+            if (scale == 2) {
+                _mm_storeu_si128((__m128i *)dst, lo);
+                _mm_storeu_si128((__m128i *)(dst + 8), hi);
+            } else {
+                _mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi32(lo, lo));
+                _mm_storeu_si128((__m128i *)(dst + 8), _mm_unpackhi_epi32(lo, lo));
+                _mm_storeu_si128((__m128i *)(dst + 16), _mm_unpacklo_epi32(hi, hi));
+                _mm_storeu_si128((__m128i *)(dst + 24), _mm_unpackhi_epi32(hi, hi));
+            }
+#endif
+            dst += 8 * scale;
+        }
+    }
+#endif
+    
+    // 剩余的整个源像素：2倍一个32位字，4倍一个64位字；memcpy避免非对齐访问
+    if (scale == 2) {
+        for (; n >= 2; n -= 2, i++, dst += 2) {
+            uint32_t v = upscale_src(src, idx, palette, i, swap) * 0x00010001u;
+            memcpy(dst, &v, sizeof(v));
+        }
+    } else if (scale == 4) {
+        for (; n >= 4; n -= 4, i++, dst += 4) {
+            uint64_t v = upscale_src(src, idx, palette, i, swap) * 0x0001000100010001ull;
+            memcpy(dst, &v, sizeof(v));
+        }
+    } else {
+        for (; n >= scale; n -= scale, i++) {
+            uint16_t p = upscale_src(src, idx, palette, i, swap);
+            for (unsigned k = 0; k < scale; k++) *dst++ = p;
+        }
+    }
+    
+    // 区域在源像素中间结束
+    if (n > 0) {
+        uint16_t p = upscale_src(src, idx, palette, i, swap);
+        while (n--) *dst++ = p;
+    }
+}
+
+// 线格式为大端，大端主机上不需要交换
+#define WIRE_SWAP (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+
+void st7735_upscale16(uint16_t *dst, const uint16_t *src, size_t n, unsigned scale, unsigned phase) {
+    upscale(dst, src, NULL, NULL, n, scale, phase, false);
+}
+
+void st7735_upscale16_swap(uint16_t *dst, const uint16_t *src, size_t n, unsigned scale,
+                           unsigned phase) {
+    upscale(dst, src, NULL, NULL, n, scale, phase, WIRE_SWAP);
+}
+
+void st7735_upscale_lut16(uint16_t *dst, const uint8_t *src, size_t n, unsigned scale,
+                          unsigned phase, const uint16_t palette[256]) {
+    upscale(dst, NULL, src, palette, n, scale, phase, false);
+}
+
+void st7735_upscale_lut16_swap(uint16_t *dst, const uint8_t *src, size_t n, unsigned scale,
+                               unsigned phase, const uint16_t palette[256]) {
+    upscale(dst, NULL, src, palette, n, scale, phase, WIRE_SWAP);
+}
+
+void st7735_fill16(uint16_t *dst, uint16_t color, size_t n) {
+    // 先逐像素写到8字节对齐，再整字写入
+    while (n > 0 && ((uintptr_t)dst & 7)) {
+        *dst++ = color;
+        n--;
+    }
+    
+    uint64_t pattern = color * 0x0001000100010001ull;
+    u64_alias *dst64 = (u64_alias *)dst;
+    
+#if defined(__ARM_NEON)
+    uint16x8_t v = vdupq_n_u16(color);
+    for (; n >= 16; n -= 16, dst64 += 4) {
+        vst1q_u16((uint16_t *)dst64, v);
+        vst1q_u16((uint16_t *)(dst64 + 2), v);
+    }
+#elif defined(__SSE2__)
+    __m128i v = _mm_set1_epi16((short)color);
+    for (; n >= 16; n -= 16, dst64 += 4) {
+        _mm_storeu_si128((__m128i *)dst64, v);
+        _mm_storeu_si128((__m128i *)(dst64 + 2), v);
+    }
+#endif
+    
+    for (; n >= 4; n -= 4) {
+        *dst64++ = pattern;
+    }
+    
+    dst = (uint16_t *)dst64;
+    while (n-- > 0) {
+        *dst++ = color;
+    }
+}
+
+// ===== 半透明混合 =====
+// 8位alpha先量化为0..32，各通道 out = (s * a + d * (32 - a)) >> 5，
+// alpha为0/255时结果与目标/源完全相同。所有实现结果一致
+
+static inline unsigned alpha5(unsigned alpha) {
+    return (alpha + 4) >> 3;
+}
+
+// 逐通道计算的单个像素
+static inline uint16_t blend565(uint16_t s, uint16_t d, unsigned a) {
+    unsigned r = ((s >> 11) * a + (d >> 11) * (32 - a)) >> 5;
+    unsigned g = (((s >> 5) & 0x3F) * a + ((d >> 5) & 0x3F) * (32 - a)) >> 5;
+    unsigned b = ((s & 0x1F) * a + (d & 0x1F) * (32 - a)) >> 5;
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+// SWAR：像素展开成G在高位、R/B在低位的32位字（----GGGGGG-----RRRRR------BBBBB），
+// 通道之间留出5位空隙，乘以0..32的alpha不会进位到相邻通道，一次乘法算完三个通道
+#define SWAR_MASK32     0x07E0F81Fu
+#define SWAR_MASK64     0x07E0F81F07E0F81Full
+
+static inline uint32_t swar_expand(uint16_t p) {
+    return (p | ((uint32_t)p << 16)) & SWAR_MASK32;
+}
+
+static inline uint16_t swar_pack(uint32_t x) {
+    return (uint16_t)((x | (x >> 16)) & 0xFFFF);
+}
+
+static inline uint16_t swar_blend(uint16_t s, uint16_t d, unsigned a) {
+    uint32_t x = (swar_expand(s) * a + swar_expand(d) * (32 - a)) >> 5;
+    return swar_pack(x & SWAR_MASK32);
+}
+
+// 64位字中放两个展开的像素，各占32位，一次乘法混合两个像素
+static inline uint64_t swar_expand2(uint32_t two) {
+    uint64_t x = (two & 0xFFFF) | ((uint64_t)(two >> 16) << 32);
+    return (x | (x << 16)) & SWAR_MASK64;
+}
+
+static inline uint32_t swar_pack2(uint64_t x) {
+    x |= x >> 16;
+    return (uint32_t)(x & 0xFFFF) | ((uint32_t)(x >> 32) << 16);
+}
+
+static inline uint32_t swar_blend2(uint32_t s, uint32_t d, unsigned a) {
+    uint64_t x = (swar_expand2(s) * a + swar_expand2(d) * (32 - a)) >> 5;
+    return swar_pack2(x & SWAR_MASK64);
+}
+
+#if defined(__ARM_NEON)
+// 8个像素，通道拆到16位通道中计算（最大63 * 32，不会溢出）
+static inline uint16x8_t blend565x8(uint16x8_t s, uint16x8_t d, uint16x8_t a) {
+    uint16x8_t ia = vsubq_u16(vdupq_n_u16(32), a);
+    uint16x8_t m5 = vdupq_n_u16(0x1F);
+    uint16x8_t m6 = vdupq_n_u16(0x3F);
+    uint16x8_t r = vmlaq_u16(vmulq_u16(vshrq_n_u16(s, 11), a), vshrq_n_u16(d, 11), ia);
+    uint16x8_t g = vmlaq_u16(vmulq_u16(vandq_u16(vshrq_n_u16(s, 5), m6), a),
+                             vandq_u16(vshrq_n_u16(d, 5), m6), ia);
+    uint16x8_t b = vmlaq_u16(vmulq_u16(vandq_u16(s, m5), a), vandq_u16(d, m5), ia);
+    uint16x8_t p = vshlq_n_u16(vshrq_n_u16(r, 5), 11);
+    p = vorrq_u16(p, vshlq_n_u16(vshrq_n_u16(g, 5), 5));
+    return vorrq_u16(p, vshrq_n_u16(b, 5));
+}
+
+static inline uint16x8_t alpha5x8(const uint8_t *alpha) {
+    return vshrq_n_u16(vaddq_u16(vmovl_u8(vld1_u8(alpha)), vdupq_n_u16(4)), 3);
+}
+#elif defined(__SSE2__)
+static inline __m128i blend565x8(__m128i s, __m128i d, __m128i a) {
+    __m128i ia = _mm_sub_epi16(_mm_set1_epi16(32), a);
+    __m128i m5 = _mm_set1_epi16(0x1F);
+    __m128i m6 = _mm_set1_epi16(0x3F);
+    __m128i r = _mm_add_epi16(_mm_mullo_epi16(_mm_srli_epi16(s, 11), a),
+                              _mm_mullo_epi16(_mm_srli_epi16(d, 11), ia));
+    __m128i g = _mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(s, 5), m6), a),
+                              _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(d, 5), m6), ia));
+    __m128i b = _mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(s, m5), a),
+                              _mm_mullo_epi16(_mm_and_si128(d, m5), ia));
+    __m128i p = _mm_slli_epi16(_mm_srli_epi16(r, 5), 11);
+    p = _mm_or_si128(p, _mm_slli_epi16(_mm_srli_epi16(g, 5), 5));
+    return _mm_or_si128(p, _mm_srli_epi16(b, 5));
+}
+
+static inline __m128i alpha5x8(const uint8_t *alpha) {
+    __m128i a = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)alpha), _mm_setzero_si128());
+    return _mm_srli_epi16(_mm_add_epi16(a, _mm_set1_epi16(4)), 3);
+}
+#endif
+
+void st7735_blend16(uint16_t *dst, const uint16_t *src, size_t n, uint8_t alpha) {
+    unsigned a = alpha5(alpha);
+    if (a == 0) return;
+    if (a == 32) {
+        memmove(dst, src, n * sizeof(uint16_t));
+        return;
+    }
+    size_t i = 0;
+    
+#if defined(__ARM_NEON)
+    uint16x8_t va = vdupq_n_u16(a);
+    for (; i + 8 <= n; i += 8) {
+        vst1q_u16(dst + i, blend565x8(vld1q_u16(src + i), vld1q_u16(dst + i), va));
+    }
+#elif defined(__SSE2__)
+    __m128i va = _mm_set1_epi16((short)a);
+    for (; i + 8 <= n; i += 8) {
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+        _mm_storeu_si128((__m128i *)(dst + i), blend565x8(s, d, va));
+    }
+#endif
+    
+    for (; i + 2 <= n; i += 2) {
+        uint32_t s, d;
+        memcpy(&s, src + i, sizeof(s));
+        memcpy(&d, dst + i, sizeof(d));
+        d = swar_blend2(s, d, a);
+        memcpy(dst + i, &d, sizeof(d));
+    }
+    
+    if (i < n) {
+        dst[i] = swar_blend(src[i], dst[i], a);
+    }
+}
+
+// 逐通道参考实现，仅用于正确性检查和性能对比
+__attribute__((optimize("no-tree-vectorize")))
+void st7735_blend16_scalar(uint16_t *dst, const uint16_t *src, size_t n, uint8_t alpha) {
+    unsigned a = alpha5(alpha);
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = blend565(src[i], dst[i], a);
+    }
+}
+
+void st7735_blend16_color(uint16_t *dst, uint16_t color, size_t n, uint8_t alpha) {
+    unsigned a = alpha5(alpha);
+    if (a == 0) return;
+    if (a == 32) {
+        st7735_fill16(dst, color, n);
+        return;
+    }
+    size_t i = 0;
+    
+#if defined(__ARM_NEON)
+    uint16x8_t va = vdupq_n_u16(a);
+    uint16x8_t vc = vdupq_n_u16(color);
+    for (; i + 8 <= n; i += 8) {
+        vst1q_u16(dst + i, blend565x8(vc, vld1q_u16(dst + i), va));
+    }
+#elif defined(__SSE2__)
+    __m128i va = _mm_set1_epi16((short)a);
+    __m128i vc = _mm_set1_epi16((short)color);
+    for (; i + 8 <= n; i += 8) {
+        __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+        _mm_storeu_si128((__m128i *)(dst + i), blend565x8(vc, d, va));
+    }
+#endif
+    
+    // 颜色的一项对所有像素相同，每两个像素只剩一次乘法
+    uint64_t cs = swar_expand2(color | ((uint32_t)color << 16)) * a;
+    for (; i + 2 <= n; i += 2) {
+        uint32_t d;
+        memcpy(&d, dst + i, sizeof(d));
+        uint64_t x = (cs + swar_expand2(d) * (32 - a)) >> 5;
+        d = swar_pack2(x & SWAR_MASK64);
+        memcpy(dst + i, &d, sizeof(d));
+    }
+    
+    if (i < n) {
+        dst[i] = swar_blend(color, dst[i], a);
+    }
+}
+
+void st7735_blend16_alpha(uint16_t *dst, const uint16_t *src, const uint8_t *alpha, size_t n) {
+    size_t i = 0;
+    
+#if defined(__ARM_NEON)
+    for (; i + 8 <= n; i += 8) {
+        vst1q_u16(dst + i, blend565x8(vld1q_u16(src + i), vld1q_u16(dst + i), alpha5x8(alpha + i)));
+    }
+#elif defined(__SSE2__)
+    for (; i + 8 <= n; i += 8) {
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+        _mm_storeu_si128((__m128i *)(dst + i), blend565x8(s, d, alpha5x8(alpha + i)));
+    }
+#endif
+    
+    // 每个像素的alpha不同，按32位字逐像素混合；全透明/不透明的像素（精灵和字形的大部分）直接跳过/复制
+    for (; i < n; i++) {
+        unsigned a = alpha5(alpha[i]);
+        if (a == 32) {
+            dst[i] = src[i];
+        } else if (a != 0) {
+            dst[i] = swar_blend(src[i], dst[i], a);
+        }
+    }
+}
+
+__attribute__((optimize("no-tree-vectorize")))
+void st7735_blend16_alpha_scalar(uint16_t *dst, const uint16_t *src, const uint8_t *alpha,
+                                 size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = blend565(src[i], dst[i], alpha5(alpha[i]));
+    }
+}
+
+void st7735_blend16_color_alpha(uint16_t *dst, uint16_t color, const uint8_t *alpha, size_t n) {
+    size_t i = 0;
+    
+#if defined(__ARM_NEON)
+    uint16x8_t vc = vdupq_n_u16(color);
+    for (; i + 8 <= n; i += 8) {
+        vst1q_u16(dst + i, blend565x8(vc, vld1q_u16(dst + i), alpha5x8(alpha + i)));
+    }
+#elif defined(__SSE2__)
+    __m128i vc = _mm_set1_epi16((short)color);
+    for (; i + 8 <= n; i += 8) {
+        __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+        _mm_storeu_si128((__m128i *)(dst + i), blend565x8(vc, d, alpha5x8(alpha + i)));
+    }
+#endif
+    
+    uint32_t c = swar_expand(color);
+    for (; i < n; i++) {
+        unsigned a = alpha5(alpha[i]);
+        if (a == 32) {
+            dst[i] = color;
+        } else if (a != 0) {
+            uint32_t x = (c * a + swar_expand(dst[i]) * (32 - a)) >> 5;
+            dst[i] = swar_pack(x & SWAR_MASK32);
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef ST7735_PIXEL_H
+#define ST7735_PIXEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 像素内核：发送阶段的格式转换和光栅化的填充
+
+// RGB565主机字节序 -> 屏幕要求的大端字节序
+void st7735_swap16(uint16_t *dst, const uint16_t *src, size_t n);
+// 逐像素参考实现，仅用于性能对比
+void st7735_swap16_scalar(uint16_t *dst, const uint16_t *src, size_t n);
+
+// RGB565 -> RGB444线格式：每两个像素打包成3字节（R1G1 B1R2 G2B2），
+// 各通道截断低位；n为奇数时最后一个像素占2字节。返回写入的字节数。
+// dst可以与src指向同一缓冲（原地打包）
+size_t st7735_pack444(uint8_t *dst, const uint16_t *src, size_t n);
+size_t st7735_pack444_scalar(uint8_t *dst, const uint16_t *src, size_t n);
+// 4x4有序抖动，结果仍为RGB565但低位已量化，之后由st7735_pack444截断得到抖动后的RGB444。
+// x, y为第一个像素的屏幕坐标
+void st7735_dither444(uint16_t *dst, const uint16_t *src, size_t n, unsigned x, unsigned y);
+
+// RGB888（每像素3字节R,G,B）-> RGB565，各通道截断低位
+void st7735_rgb888_to_565(uint16_t *dst, const uint8_t *src, size_t n);
+void st7735_rgb888_to_565_scalar(uint16_t *dst, const uint8_t *src, size_t n);
+// 同上，截断前加4x4有序抖动阈值；x, y为第一个像素的屏幕坐标
+void st7735_rgb888_to_565_dither(uint16_t *dst, const uint8_t *src, size_t n,
+                                 unsigned x, unsigned y);
+
+// 8位调色板索引 -> RGB565：st7735_lut16得到主机字节序，
+// st7735_lut16_swap查表的同时交换字节序，直接得到RGB565线格式
+void st7735_lut16(uint16_t *dst, const uint8_t *src, size_t n, const uint16_t palette[256]);
+void st7735_lut16_swap(uint16_t *dst, const uint8_t *src, size_t n, const uint16_t palette[256]);
+
+// 水平放大（降分辨率渲染的发送阶段）：src的每个像素复制scale份，从src[0]的第phase份
+// （0 <= phase < scale）开始，共输出n个像素。_swap同时交换字节序得到RGB565线格式，
+// _lut的源为调色板索引。2倍和4倍时每个源像素一次写一个32/64位字
+void st7735_upscale16(uint16_t *dst, const uint16_t *src, size_t n, unsigned scale, unsigned phase);
+void st7735_upscale16_swap(uint16_t *dst, const uint16_t *src, size_t n, unsigned scale,
+                           unsigned phase);
+void st7735_upscale_lut16(uint16_t *dst, const uint8_t *src, size_t n, unsigned scale,
+                          unsigned phase, const uint16_t palette[256]);
+void st7735_upscale_lut16_swap(uint16_t *dst, const uint8_t *src, size_t n, unsigned scale,
+                               unsigned phase, const uint16_t palette[256]);
+
+// 用同一颜色填充n个像素（span光栅化的内层循环）
+void st7735_fill16(uint16_t *dst, uint16_t color, size_t n);
+
+// 半透明混合（主机字节序RGB565）：dst = src * alpha + dst * (1 - alpha)。
+// alpha为0..255，量化为33级；NEON/SSE2每次8个像素，其余平台按64位字每次两个像素
+void st7735_blend16(uint16_t *dst, const uint16_t *src, size_t n, uint8_t alpha);
+void st7735_blend16_scalar(uint16_t *dst, const uint16_t *src, size_t n, uint8_t alpha);
+void st7735_blend16_color(uint16_t *dst, uint16_t color, size_t n, uint8_t alpha);
+// 每个像素一个alpha（精灵的alpha通道、抗锯齿字形的覆盖率）
+void st7735_blend16_alpha(uint16_t *dst, const uint16_t *src, const uint8_t *alpha, size_t n);
+void st7735_blend16_alpha_scalar(uint16_t *dst, const uint16_t *src, const uint8_t *alpha,
+                                 size_t n);
+void st7735_blend16_color_alpha(uint16_t *dst, uint16_t color, const uint8_t *alpha, size_t n);
+
+#endif // ST7735_PIXEL_H
@@ -0,0 +1,466 @@
+#include "st7735_scene.h"
+#include "st7735_blit.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define TILE ST7735_SCENE_TILE
+
+typedef enum {
+    ITEM_RECT,
+    ITEM_ROUND_RECT,
+    ITEM_CIRCLE,
+    ITEM_TEXT,
+    ITEM_BLIT
+} item_kind_t;
+
+// 绘制参数；提交时整体比较判断是否变化，构造前先清零使填充字节也一致
+typedef struct {
+    uint8_t kind;
+    bool fill;
+    bool keyed;
+    uint8_t size;
+    int16_t x, y;
+    uint16_t w, h, r;
+    uint16_t color, bg, key;
+    const uint16_t *src;
+    char text[ST7735_SCENE_TEXT];
+} item_params_t;
+
+typedef struct {
+    char name[ST7735_SCENE_NAME];
+    bool used;
+    bool visible;
+    item_params_t p;
+    int tx0, ty0, tx1, ty1;     // 覆盖的块（闭区间），tx0 > tx1表示不在屏上
+} item_t;
+
+struct st7735_scene {
+    st7735_t *dev;
+    uint16_t bg;
+    uint16_t width, height;     // 建立块网格时的屏幕尺寸，旋转后重建
+    const st7735_font_t *font;  // 计算文本范围时的字体，换字体后重建
+    int cols, rows;
+    uint64_t *cover;            // 每块被哪些项覆盖（按项下标的位掩码）
+    uint8_t *invalid;           // 每块是否需要重画
+    int invalid_count;
+    item_t items[ST7735_SCENE_MAX_ITEMS];
+    uint8_t order[ST7735_SCENE_MAX_ITEMS];  // 从下到上的项下标
+    int count;
+    st7735_scene_stats_t stats;
+};
+
+// 把屏幕坐标的闭区间矩形换算成块范围，完全在屏外时为空
+static void tile_range(const st7735_scene_t *s, int x0, int y0, int x1, int y1,
+                       int *tx0, int *ty0, int *tx1, int *ty1) {
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 >= s->width) x1 = s->width - 1;
+    if (y1 >= s->height) y1 = s->height - 1;
+    if (x0 > x1 || y0 > y1) {
+        *tx0 = *ty0 = 1;
+        *tx1 = *ty1 = 0;
+        return;
+    }
+    *tx0 = x0 / TILE;
+    *ty0 = y0 / TILE;
+    *tx1 = x1 / TILE;
+    *ty1 = y1 / TILE;
+}
+
+static void invalidate_tiles(st7735_scene_t *s, int tx0, int ty0, int tx1, int ty1) {
+    for (int ty = ty0; ty <= ty1; ty++) {
+        for (int tx = tx0; tx <= tx1; tx++) {
+            uint8_t *t = &s->invalid[ty * s->cols + tx];
+            if (!*t) {
+                *t = 1;
+                s->invalid_count++;
+            }
+        }
+    }
+}
+
+// 项的包围盒（屏幕坐标闭区间），与st7735_draw_*实际写入的范围一致
+static void item_bounds(st7735_t *dev, const item_params_t *p, int *x0, int *y0, int *x1, int *y1) {
+    *x0 = p->x;
+    *y0 = p->y;
+    switch (p->kind) {
+        case ITEM_CIRCLE:
+            *x0 = p->x - p->r;
+            *y0 = p->y - p->r;
+            *x1 = p->x + p->r;
+            *y1 = p->y + p->r;
+            return;
+        case ITEM_TEXT: {
+            // 按当前字体排版
+            int left, right, height;
+            st7735_measure_string(dev, p->text, p->size, &left, &right, &height);
+            *x0 = p->x + left;
+            *x1 = p->x + right;
+            *y1 = p->y + height - 1;
+            return;
+        }
+        default:
+            *x1 = p->x + p->w - 1;
+            *y1 = p->y + p->h - 1;
+            return;
+    }
+}
+
+static void item_update_range(st7735_scene_t *s, item_t *it) {
+    int x0, y0, x1, y1;
+    item_bounds(s->dev, &it->p, &x0, &y0, &x1, &y1);
+    tile_range(s, x0, y0, x1, y1, &it->tx0, &it->ty0, &it->tx1, &it->ty1);
+}
+
+// 把项放到块上（或从块上拿走），覆盖的块都要重画
+static void item_cover(st7735_scene_t *s, int index, bool on) {
+    item_t *it = &s->items[index];
+    if (!it->visible) return;
+    
+    uint64_t bit = 1ull << index;
+    for (int ty = it->ty0; ty <= it->ty1; ty++) {
+        for (int tx = it->tx0; tx <= it->tx1; tx++) {
+            uint64_t *c = &s->cover[ty * s->cols + tx];
+            *c = on ? (*c | bit) : (*c & ~bit);
+        }
+    }
+    invalidate_tiles(s, it->tx0, it->ty0, it->tx1, it->ty1);
+}
+
+// 按当前屏幕尺寸重建块网格，全部重画
+static void rebuild_grid(st7735_scene_t *s) {
+    s->width = s->dev->width;
+    s->height = s->dev->height;
+    s->font = s->dev->font;
+    s->cols = (s->width + TILE - 1) / TILE;
+    s->rows = (s->height + TILE - 1) / TILE;
+    memset(s->cover, 0, s->cols * s->rows * sizeof(uint64_t));
+    memset(s->invalid, 0, s->cols * s->rows);
+    s->invalid_count = 0;
+    
+    for (int i = 0; i < ST7735_SCENE_MAX_ITEMS; i++) {
+        if (!s->items[i].used) continue;
+        item_update_range(s, &s->items[i]);
+        item_cover(s, i, true);
+    }
+    invalidate_tiles(s, 0, 0, s->cols - 1, s->rows - 1);
+}
+
+st7735_scene_t *st7735_scene_create(st7735_t *dev, uint16_t bg) {
+    if (!dev) return NULL;
+    
+    st7735_scene_t *s = (st7735_scene_t *)calloc(1, sizeof(*s));
+    if (!s) return NULL;
+    
+    // 按长边分配，旋转后宽高交换也够用
+    int side = dev->width > dev->height ? dev->width : dev->height;
+    size_t tiles = (size_t)((side + TILE - 1) / TILE) * ((side + TILE - 1) / TILE);
+    s->cover = (uint64_t *)calloc(tiles, sizeof(uint64_t));
+    s->invalid = (uint8_t *)calloc(tiles, 1);
+    if (!s->cover || !s->invalid) {
+        st7735_scene_destroy(s);
+        return NULL;
+    }
+    s->dev = dev;
+    s->bg = bg;
+    rebuild_grid(s);
+    return s;
+}
+
+void st7735_scene_destroy(st7735_scene_t *scene) {
+    if (!scene) return;
+    free(scene->cover);
+    free(scene->invalid);
+    free(scene);
+}
+
+static int find_item(const st7735_scene_t *s, const char *name) {
+    for (int k = 0; k < s->count; k++) {
+        int i = s->order[k];
+        if (strcmp(s->items[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+// 新建或更新一项；参数不变时什么都不做
+static int submit(st7735_scene_t *s, const char *name, const item_params_t *p) {
+    if (!s || !name || strlen(name) >= ST7735_SCENE_NAME) return -1;
+    
+    int i = find_item(s, name);
+    if (i >= 0) {
+        item_t *it = &s->items[i];
+        if (memcmp(&it->p, p, sizeof(*p)) == 0) {
+            s->stats.unchanged++;
+            return 0;
+        }
+        // 旧位置和新位置都要重画
+        item_cover(s, i, false);
+        it->p = *p;
+        item_update_range(s, it);
+        item_cover(s, i, true);
+        s->stats.changes++;
+        return 0;
+    }
+    
+    i = 0;
+    while (i < ST7735_SCENE_MAX_ITEMS && s->items[i].used) i++;
+    if (i == ST7735_SCENE_MAX_ITEMS) return -1;
+    
+    item_t *it = &s->items[i];
+    memset(it, 0, sizeof(*it));
+    strcpy(it->name, name);
+    it->used = true;
+    it->visible = true;
+    it->p = *p;
+    item_update_range(s, it);
+    item_cover(s, i, true);
+    s->order[s->count++] = (uint8_t)i;
+    s->stats.changes++;
+    return 0;
+}
+
+int st7735_scene_rect(st7735_scene_t *scene, const char *name, uint16_t x, uint16_t y,
+                      uint16_t w, uint16_t h, uint16_t color, bool fill) {
+    item_params_t p;
+    memset(&p, 0, sizeof(p));
+    p.kind = ITEM_RECT;
+    p.x = x;
+    p.y = y;
+    p.w = w;
+    p.h = h;
+    p.color = color;
+    p.fill = fill;
+    return submit(scene, name, &p);
+}
+
+int st7735_scene_round_rect(st7735_scene_t *scene, const char *name, uint16_t x, uint16_t y,
+                            uint16_t w, uint16_t h, uint16_t r, uint16_t color, bool fill) {
+    item_params_t p;
+    memset(&p, 0, sizeof(p));
+    p.kind = ITEM_ROUND_RECT;
+    p.x = x;
+    p.y = y;
+    p.w = w;
+    p.h = h;
+    p.r = r;
+    p.color = color;
+    p.fill = fill;
+    return submit(scene, name, &p);
+}
+
+int st7735_scene_circle(st7735_scene_t *scene, const char *name, uint16_t x, uint16_t y,
+                        uint16_t r, uint16_t color, bool fill) {
+    item_params_t p;
+    memset(&p, 0, sizeof(p));
+    p.kind = ITEM_CIRCLE;
+    p.x = x;
+    p.y = y;
+    p.r = r;
+    p.color = color;
+    p.fill = fill;
+    return submit(scene, name, &p);
+}
+
+int st7735_scene_text(st7735_scene_t *scene, const char *name, uint16_t x, uint16_t y,
+                      const char *text, uint16_t fg, uint16_t bg, uint8_t size) {
+    if (!text || size == 0) return -1;
+    
+    item_params_t p;
+    memset(&p, 0, sizeof(p));
+    p.kind = ITEM_TEXT;
+    p.x = x;
+    p.y = y;
+    p.color = fg;
+    p.bg = bg;
+    p.size = size;
+    strncpy(p.text, text, sizeof(p.text) - 1);
+    // 截断时不留半个UTF-8字符
+    size_t n = strlen(p.text);
+    if (text[n] != '\0') {
+        while (n > 0 && ((uint8_t)text[n] & 0xC0) == 0x80) n--;
+        p.text[n] = '\0';
+    }
+    return submit(scene, name, &p);
+}
+
+int st7735_scene_blit(st7735_scene_t *scene, const char *name, int x, int y,
+                      const uint16_t *src, uint16_t w, uint16_t h, bool keyed, uint16_t key) {
+    if (!src) return -1;
+    
+    item_params_t p;
+    memset(&p, 0, sizeof(p));
+    p.kind = ITEM_BLIT;
+    p.x = x;
+    p.y = y;
+    p.w = w;
+    p.h = h;
+    p.src = src;
+    p.keyed = keyed;
+    p.key = keyed ? key : 0;
+    return submit(scene, name, &p);
+}
+
+int st7735_scene_remove(st7735_scene_t *scene, const char *name) {
+    if (!scene || !name) return -1;
+    
+    int i = find_item(scene, name);
+    if (i < 0) return -1;
+    
+    item_cover(scene, i, false);
+    scene->items[i].used = false;
+    
+    // 保持其余项的层次
+    int k = 0;
+    while (scene->order[k] != i) k++;
+    memmove(&scene->order[k], &scene->order[k + 1], scene->count - k - 1);
+    scene->count--;
+    return 0;
+}
+
+int st7735_scene_set_visible(st7735_scene_t *scene, const char *name, bool visible) {
+    if (!scene || !name) return -1;
+    
+    int i = find_item(scene, name);
+    if (i < 0) return -1;
+    
+    item_t *it = &scene->items[i];
+    if (it->visible == visible) return 0;
+    if (visible) {
+        it->visible = true;
+        item_cover(scene, i, true);
+    } else {
+        item_cover(scene, i, false);
+        it->visible = false;
+    }
+    return 0;
+}
+
+int st7735_scene_touch(st7735_scene_t *scene, const char *name) {
+    if (!scene || !name) return -1;
+    
+    int i = find_item(scene, name);
+    if (i < 0) return -1;
+    
+    item_t *it = &scene->items[i];
+    if (it->visible) invalidate_tiles(scene, it->tx0, it->ty0, it->tx1, it->ty1);
+    return 0;
+}
+
+void st7735_scene_set_background(st7735_scene_t *scene, uint16_t bg) {
+    if (!scene || scene->bg == bg) return;
+    scene->bg = bg;
+    invalidate_tiles(scene, 0, 0, scene->cols - 1, scene->rows - 1);
+}
+
+void st7735_scene_invalidate(st7735_scene_t *scene, int x, int y, uint16_t w, uint16_t h) {
+    if (!scene || w == 0 || h == 0) return;
+    
+    int tx0, ty0, tx1, ty1;
+    tile_range(scene, x, y, x + w - 1, y + h - 1, &tx0, &ty0, &tx1, &ty1);
+    invalidate_tiles(scene, tx0, ty0, tx1, ty1);
+}
+
+static void draw_item(st7735_t *dev, const item_params_t *p) {
+    switch (p->kind) {
+        case ITEM_RECT:
+            if (p->fill) st7735_fill_rect(dev, p->x, p->y, p->w, p->h, p->color);
+            else st7735_draw_rect(dev, p->x, p->y, p->w, p->h, p->color);
+            break;
+        case ITEM_ROUND_RECT:
+            if (p->fill) st7735_fill_round_rect(dev, p->x, p->y, p->w, p->h, p->r, p->color);
+            else st7735_draw_round_rect(dev, p->x, p->y, p->w, p->h, p->r, p->color);
+            break;
+        case ITEM_CIRCLE:
+            if (p->fill) st7735_fill_circle(dev, p->x, p->y, p->r, p->color);
+            else st7735_draw_circle(dev, p->x, p->y, p->r, p->color);
+            break;
+        case ITEM_TEXT:
+            st7735_draw_string(dev, p->text, p->x, p->y, p->color, p->bg, p->size);
+            break;
+        case ITEM_BLIT:
+            if (p->keyed) st7735_blit_key(dev, p->x, p->y, p->src, p->w, p->h, p->key);
+            else st7735_blit(dev, p->x, p->y, p->src, p->w, p->h);
+            break;
+        default:
+            break;
+    }
+}
+
+// 重画一个矩形：裁剪到该矩形后清背景，再按层次画覆盖它的项
+static void render_rect(st7735_scene_t *s, int x, int y, int w, int h, uint64_t mask) {
+    st7735_t *dev = s->dev;
+    
+    st7735_push_clip(dev, x, y, w, h);
+    st7735_fill_rect(dev, x, y, w, h, s->bg);
+    for (int k = 0; k < s->count && mask; k++) {
+        int i = s->order[k];
+        if (!(mask & (1ull << i))) continue;
+        draw_item(dev, &s->items[i].p);
+        mask &= ~(1ull << i);
+        s->stats.draws++;
+    }
+    st7735_pop_clip(dev);
+    s->stats.rects++;
+}
+
+int st7735_scene_render(st7735_scene_t *scene) {
+    if (!scene) return -1;
+    
+    st7735_t *dev = scene->dev;
+    if (!dev->framebuffer && !dev->indexbuf) return -1;
+    if (dev->width != scene->width || dev->height != scene->height || dev->font != scene->font) {
+        rebuild_grid(scene);
+    }
+    if (scene->invalid_count == 0) return 0;
+    
+    // 场景使用屏幕坐标：暂存应用的裁剪栈，渲染完恢复
+    st7735_clip_t clip = dev->clip;
+    st7735_clip_t stack[ST7735_CLIP_DEPTH];
+    uint8_t depth = dev->clip_depth;
+    memcpy(stack, dev->clip_stack, sizeof(stack));
+    st7735_reset_clip(dev);
+    
+    // 每行相邻的失效块合并成一个矩形，覆盖它们的项各画一次
+    int tiles = 0;
+    for (int ty = 0; ty < scene->rows; ty++) {
+        uint8_t *row = &scene->invalid[ty * scene->cols];
+        const uint64_t *cover = &scene->cover[ty * scene->cols];
+        int tx = 0;
+        while (tx < scene->cols) {
+            if (!row[tx]) {
+                tx++;
+                continue;
+            }
+            int start = tx;
+            uint64_t mask = 0;
+            while (tx < scene->cols && row[tx]) {
+                mask |= cover[tx];
+                row[tx++] = 0;
+            }
+            render_rect(scene, start * TILE, ty * TILE, (tx - start) * TILE, TILE, mask);
+            tiles += tx - start;
+        }
+    }
+    
+    dev->clip = clip;
+    dev->clip_depth = depth;
+    memcpy(dev->clip_stack, stack, sizeof(stack));
+    
+    scene->invalid_count = 0;
+    scene->stats.tiles += tiles;
+    return tiles;
+}
+
+int st7735_scene_update(st7735_scene_t *scene) {
+    int tiles = st7735_scene_render(scene);
+    if (tiles > 0) st7735_update(scene->dev);
+    return tiles;
+}
+
+void st7735_scene_get_stats(const st7735_scene_t *scene, st7735_scene_stats_t *stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    if (!scene) return;
+    *stats = scene->stats;
+    stats->items = scene->count;
+}
@@ -0,0 +1,63 @@
+#ifndef ST7735_SCENE_H
+#define ST7735_SCENE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "st7735.h"
+
+// 保留模式场景：应用按名字提交/更新绘制项，场景记录每项覆盖的16x16块。
+// 项的参数变化时只把它新旧位置覆盖的块标记为失效，渲染时按行把相邻的失效块合并成矩形，
+// 在该矩形的裁剪区域内清为背景色并按层次重画与之相交的项，其余块不动。
+// 状态屏每帧只改几个数值时，绘制和发送量只与变化的块数有关，与场景中的项数无关。
+// 坐标为屏幕坐标；场景拥有整个framebuffer，直接绘制的内容会在所在块重画时被覆盖
+
+#define ST7735_SCENE_TILE       16
+#define ST7735_SCENE_MAX_ITEMS  64      // 每块用64位掩码记录覆盖它的项
+#define ST7735_SCENE_NAME       16      // 名字最大长度（含结尾0）
+#define ST7735_SCENE_TEXT       48      // 文本项最大长度（含结尾0）
+
+typedef struct st7735_scene st7735_scene_t;
+
+typedef struct {
+    uint32_t items;             // 当前项数
+    uint32_t changes;           // 参数确有变化的提交次数
+    uint32_t unchanged;         // 参数相同被忽略的提交次数
+    uint32_t tiles;             // 渲染过的块数
+    uint32_t rects;             // 渲染时合并出的矩形数
+    uint32_t draws;             // 渲染时重画的项次数
+} st7735_scene_stats_t;
+
+// bg为背景色；创建后第一次渲染整屏
+st7735_scene_t *st7735_scene_create(st7735_t *dev, uint16_t bg);
+void st7735_scene_destroy(st7735_scene_t *scene);
+
+// 提交绘制项：名字不存在时新建，放在已有项之上；存在时原位更新参数（层次不变）。
+// 项数已满或名字过长返回-1
+int st7735_scene_rect(st7735_scene_t *scene, const char *name, uint16_t x, uint16_t y,
+                      uint16_t w, uint16_t h, uint16_t color, bool fill);
+int st7735_scene_round_rect(st7735_scene_t *scene, const char *name, uint16_t x, uint16_t y,
+                            uint16_t w, uint16_t h, uint16_t r, uint16_t color, bool fill);
+int st7735_scene_circle(st7735_scene_t *scene, const char *name, uint16_t x, uint16_t y,
+                        uint16_t r, uint16_t color, bool fill);
+// 文本按st7735_draw_string绘制（UTF-8，支持换行，bg与fg相同时背景透明），超长部分截断
+int st7735_scene_text(st7735_scene_t *scene, const char *name, uint16_t x, uint16_t y,
+                      const char *text, uint16_t fg, uint16_t bg, uint8_t size);
+// 位图只保存指针，须在场景使用期间有效；像素内容改变后调用st7735_scene_touch。
+// keyed为true时跳过等于key的像素；与st7735_blit相同，坐标可以为负
+int st7735_scene_blit(st7735_scene_t *scene, const char *name, int x, int y,
+                      const uint16_t *src, uint16_t w, uint16_t h, bool keyed, uint16_t key);
+
+int st7735_scene_remove(st7735_scene_t *scene, const char *name);
+int st7735_scene_set_visible(st7735_scene_t *scene, const char *name, bool visible);
+int st7735_scene_touch(st7735_scene_t *scene, const char *name);       // 强制重画该项
+void st7735_scene_set_background(st7735_scene_t *scene, uint16_t bg);
+void st7735_scene_invalidate(st7735_scene_t *scene, int x, int y, uint16_t w, uint16_t h);
+
+// 重画失效的块（只写framebuffer并记录脏区域），返回重画的块数
+int st7735_scene_render(st7735_scene_t *scene);
+// 渲染后发送：st7735_scene_render + st7735_update
+int st7735_scene_update(st7735_scene_t *scene);
+
+void st7735_scene_get_stats(const st7735_scene_t *scene, st7735_scene_stats_t *stats);
+
+#endif // ST7735_SCENE_H
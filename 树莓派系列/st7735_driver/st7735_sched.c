@@ -0,0 +1,235 @@
+#include "st7735_sched.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+
+struct st7735_sched {
+    int fd;
+    uint64_t period;            // 帧周期（纳秒）
+    bool skip_late;
+    bool started;
+    uint64_t t0;                // 第0帧的期限
+    uint64_t expired;           // 期限已到的最大帧号
+    int64_t frame;              // 当前帧号，-1表示还没有开始
+    uint64_t frame_start;
+    bool in_frame;              // 当前帧的耗时还没有统计
+    // 调度策略
+    bool rt;
+    int old_policy;
+    struct sched_param old_param;
+    // 统计
+    uint64_t frames;
+    uint64_t skipped;
+    uint64_t late;
+    double late_sum;
+    double late_sq;
+    uint64_t late_max;
+    uint64_t work_sum;
+    uint64_t work_max;
+    uint64_t first_start;
+    uint64_t last_start;
+};
+
+static uint64_t sched_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static struct timespec to_timespec(uint64_t ns) {
+    struct timespec ts = {
+        .tv_sec = ns / 1000000000ull,
+        .tv_nsec = ns % 1000000000ull,
+    };
+    return ts;
+}
+
+st7735_sched_t *st7735_sched_create(const st7735_sched_opts_t *opts) {
+    if (!opts || opts->fps <= 0) return NULL;
+    
+    st7735_sched_t *s = (st7735_sched_t *)calloc(1, sizeof(*s));
+    if (!s) return NULL;
+    
+    s->fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    if (s->fd < 0) {
+        fprintf(stderr, "Error: Failed to create timerfd\n");
+        free(s);
+        return NULL;
+    }
+    s->period = (uint64_t)(1e9 / opts->fps);
+    if (s->period == 0) s->period = 1;
+    s->skip_late = opts->skip_late;
+    s->frame = -1;
+    
+    if (opts->rt_priority > 0) {
+        struct sched_param param = { .sched_priority = opts->rt_priority };
+        pthread_getschedparam(pthread_self(), &s->old_policy, &s->old_param);
+        if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0) {
+            s->rt = true;
+        } else {
+            fprintf(stderr, "Warning: SCHED_FIFO not permitted, using normal priority\n");
+        }
+    }
+    return s;
+}
+
+void st7735_sched_destroy(st7735_sched_t *sched) {
+    if (!sched) return;
+    if (sched->rt) pthread_setschedparam(pthread_self(), sched->old_policy, &sched->old_param);
+    close(sched->fd);
+    free(sched);
+}
+
+int st7735_sched_fd(const st7735_sched_t *sched) {
+    return sched ? sched->fd : -1;
+}
+
+// 统计上一帧的绘制+提交时间，结束时已过下一帧期限记为超时
+static void finish_frame(st7735_sched_t *s, uint64_t now) {
+    if (!s->in_frame) return;
+    
+    uint64_t work = now - s->frame_start;
+    s->work_sum += work;
+    if (work > s->work_max) s->work_max = work;
+    if (now > s->t0 + (uint64_t)(s->frame + 1) * s->period) s->late++;
+    s->in_frame = false;
+}
+
+// 等到下一帧的期限，返回要绘制的帧号（按skip_late跳过错过的帧）
+static int64_t wait_frame(st7735_sched_t *s) {
+    finish_frame(s, sched_now());
+    
+    if (!s->started) {
+        // 第0帧立即开始，之后每个周期到期一次
+        s->t0 = sched_now();
+        struct itimerspec its = {
+            .it_interval = to_timespec(s->period),
+            .it_value = to_timespec(s->t0 + s->period),
+        };
+        if (timerfd_settime(s->fd, TFD_TIMER_ABSTIME, &its, NULL) < 0) return -1;
+        s->started = true;
+    }
+    
+    // 读出到期次数，下一帧的期限未到时在poll中睡眠。
+    // 已落后时也要读，否则计数留在timerfd中，之后会提前醒来
+    uint64_t next = (uint64_t)(s->frame + 1);
+    for (;;) {
+        uint64_t count;
+        ssize_t n = read(s->fd, &count, sizeof(count));
+        if (n == (ssize_t)sizeof(count)) {
+            s->expired += count;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && errno != EAGAIN) return -1;
+        if (s->expired >= next) break;
+        
+        struct pollfd pfd = { .fd = s->fd, .events = POLLIN };
+        if (poll(&pfd, 1, -1) < 0 && errno != EINTR) return -1;
+    }
+    
+    if (s->skip_late && s->expired > next) {
+        s->skipped += s->expired - next;
+        next = s->expired;
+    }
+    s->frame = (int64_t)next;
+    return s->frame;
+}
+
+// 开始绘制当前帧：记录开始时刻相对期限的偏差
+static void begin_frame(st7735_sched_t *s) {
+    uint64_t start = sched_now();
+    uint64_t deadline = s->t0 + (uint64_t)s->frame * s->period;
+    uint64_t late = start > deadline ? start - deadline : 0;
+    s->late_sum += late;
+    s->late_sq += (double)late * late;
+    if (late > s->late_max) s->late_max = late;
+    if (s->frames == 0) s->first_start = start;
+    s->last_start = start;
+    s->frames++;
+    
+    s->frame_start = start;
+    s->in_frame = true;
+}
+
+int64_t st7735_sched_wait(st7735_sched_t *sched) {
+    if (!sched) return -1;
+    
+    int64_t frame = wait_frame(sched);
+    if (frame >= 0) begin_frame(sched);
+    return frame;
+}
+
+int st7735_sched_run(st7735_sched_t *sched, st7735_t *dev, uint64_t frames,
+                     st7735_render_fn render, void *user, volatile int *stop) {
+    if (!sched || !dev || !render) return -1;
+    
+    int ret = 0;
+    while (!(stop && *stop)) {
+        int64_t frame = wait_frame(sched);
+        if (frame < 0) {
+            ret = -1;
+            break;
+        }
+        // 跳帧后可能直接越过最后一帧
+        if (frames && (uint64_t)frame >= frames) break;
+        begin_frame(sched);
+        if (!render(dev, (uint64_t)frame, user)) break;
+        st7735_update_async(dev);
+    }
+    finish_frame(sched, sched_now());
+    return ret;
+}
+
+void st7735_sched_get_stats(const st7735_sched_t *sched, st7735_sched_stats_t *stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    if (!sched || sched->frames == 0) return;
+    
+    const st7735_sched_t *s = sched;
+    double mean = s->late_sum / s->frames;
+    double var = s->late_sq / s->frames - mean * mean;
+    // 绘制完成的帧才有耗时
+    uint64_t done = s->in_frame ? s->frames - 1 : s->frames;
+    stats->frames = s->frames;
+    stats->skipped = s->skipped;
+    stats->late = s->late;
+    stats->fps = s->last_start > s->first_start ?
+                 (s->frames - 1) * 1e9 / (s->last_start - s->first_start) : 0;
+    stats->jitter_ms = var > 0 ? sqrt(var) / 1e6 : 0;
+    stats->late_max_ms = s->late_max / 1e6;
+    stats->work_ms = done ? s->work_sum / 1e6 / done : 0;
+    stats->work_max_ms = s->work_max / 1e6;
+}
+
+void st7735_sched_reset_stats(st7735_sched_t *sched) {
+    if (!sched) return;
+    sched->frames = 0;
+    sched->skipped = 0;
+    sched->late = 0;
+    sched->late_sum = 0;
+    sched->late_sq = 0;
+    sched->late_max = 0;
+    sched->work_sum = 0;
+    sched->work_max = 0;
+    // 正在绘制的帧不计入新的统计
+    sched->in_frame = false;
+}
+
+void st7735_print_sched_stats(const st7735_sched_stats_t *stats, FILE *fp) {
+    if (!stats) return;
+    if (!fp) fp = stdout;
+    
+    fprintf(fp, "Frames: %llu drawn, %llu skipped, %llu late, %.1f fps\n",
+            (unsigned long long)stats->frames, (unsigned long long)stats->skipped,
+            (unsigned long long)stats->late, stats->fps);
+    fprintf(fp, "  jitter %.3f ms, max late %.3f ms, work %.3f ms/frame (max %.3f)\n",
+            stats->jitter_ms, stats->late_max_ms, stats->work_ms, stats->work_max_ms);
+}
@@ -0,0 +1,57 @@
+#ifndef ST7735_SCHED_H
+#define ST7735_SCHED_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "st7735.h"
+
+// 帧调度：在单调时钟的timerfd上按绝对期限定时，第n帧的期限是起点 + n * 周期，
+// 绘制和发送耗时的波动不会累积成漂移。两种用法：
+//   循环式：for (;;) { int64_t n = st7735_sched_wait(s); 按帧号n绘制; st7735_update_async(dev); }
+//   回调式：st7735_sched_run()每帧调用绘制函数并提交
+// 帧号对应时间（n / fps秒），动画按帧号计算位置，跳帧时画面仍与时间同步
+
+typedef struct {
+    double fps;             // 目标帧率
+    bool skip_late;         // 落后一帧以上时跳过错过的帧；否则连续补画直到追上
+    int rt_priority;        // >0时把调用线程设为该优先级的SCHED_FIFO（需要root），
+                            // 后台负载高时仍能按时醒来；destroy时恢复
+} st7735_sched_opts_t;
+
+typedef struct {
+    uint64_t frames;        // 绘制的帧数
+    uint64_t skipped;       // 跳过的帧数
+    uint64_t late;          // 超时的帧数：绘制和提交到下一帧期限之后才结束
+    double fps;             // 实际帧率
+    double jitter_ms;       // 帧开始时刻相对期限偏差的标准差
+    double late_max_ms;     // 最大偏差
+    double work_ms;         // 平均每帧绘制+提交时间
+    double work_max_ms;
+} st7735_sched_stats_t;
+
+typedef struct st7735_sched st7735_sched_t;
+
+// 返回false时st7735_sched_run结束
+typedef bool (*st7735_render_fn)(st7735_t *dev, uint64_t frame, void *user);
+
+// 第一次st7735_sched_wait时开始计时
+st7735_sched_t *st7735_sched_create(const st7735_sched_opts_t *opts);
+// 须在创建它的线程中调用（恢复调度策略）
+void st7735_sched_destroy(st7735_sched_t *sched);
+
+// 等到下一帧的期限，返回帧号（从0开始，跳帧时不连续），出错返回-1
+int64_t st7735_sched_wait(st7735_sched_t *sched);
+// timerfd，可放进poll/epoll和其它事件一起等待；可读后再调用st7735_sched_wait不会阻塞
+int st7735_sched_fd(const st7735_sched_t *sched);
+
+// 每帧调用render后用st7735_update_async提交（未开双缓冲时同步刷新）。
+// 帧号到达frames时结束（0不限）；stop非NULL且变为非0时结束
+int st7735_sched_run(st7735_sched_t *sched, st7735_t *dev, uint64_t frames,
+                     st7735_render_fn render, void *user, volatile int *stop);
+
+void st7735_sched_get_stats(const st7735_sched_t *sched, st7735_sched_stats_t *stats);
+void st7735_sched_reset_stats(st7735_sched_t *sched);
+void st7735_print_sched_stats(const st7735_sched_stats_t *stats, FILE *fp);
+
+#endif // ST7735_SCHED_H
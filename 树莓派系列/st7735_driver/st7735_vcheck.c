@@ -0,0 +1,491 @@
+#include "st7735.h"
+#include "st7735_mock.h"
+#include "st7735_vpanel.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// 虚拟面板检查（不需要硬件，可在CI中运行）
+//   st7735_vcheck [-o 目录] [-q]
+// 驱动经st7735_vpanel_transport接到模拟的ST7735：每个场景刷新后比较显存与framebuffer、
+// 玻璃上的画面与期望的方向，检查协议错误，并输出每帧的命令/窗口/字节数。
+// -o把每个场景的玻璃快照保存为PPM，-q只输出每项检查的结果。有不一致时退出码为1
+
+static const char *out_dir;
+static bool quiet;
+static int failures;
+// 显存视图的原点：带偏移的面板上驱动的(0, 0)写在这里
+static uint16_t view_x, view_y;
+
+static const char *rotation_name[] = { "rot0", "rot90", "rot180", "rot270" };
+
+// 初始化接到虚拟面板的设备；不接复位线，冷启动时驱动发SWRESET
+static int open_device(st7735_t *dev, st7735_vpanel_t *vp, st7735_transport_t *transport,
+                       st7735_rotation_t rotation, bool warm) {
+    st7735_config_t config;
+    
+    *transport = st7735_vpanel_transport(vp);
+    st7735_config_default(&config);
+    config.gpio_backend = ST7735_GPIO_FAKE;
+    config.rst_pin = -1;
+    config.rotation = rotation;
+    config.warm_start = warm;
+    config.transport = transport;
+    return st7735_init_config(dev, &config);
+}
+
+static uint16_t fb_pixel(const st7735_t *dev, unsigned x, unsigned y) {
+    size_t i = (size_t)y * dev->width + x;
+    return dev->indexbuf ? dev->palette[dev->indexbuf[i]] : dev->framebuffer[i];
+}
+
+// RGB444线格式时只比较每个通道的高4位
+static uint16_t quantize(const st7735_t *dev, uint16_t c) {
+    return dev->format == ST7735_FORMAT_RGB565 ? c : (c & 0xF79E);
+}
+
+// 逻辑坐标在128x160玻璃上的位置（面板在0度方向MX|MY时是正的）
+static void glass_xy(st7735_rotation_t rotation, unsigned x, unsigned y,
+                     unsigned *gx, unsigned *gy) {
+    switch (rotation) {
+        case ST7735_ROTATION_90:  *gx = 127 - y;  *gy = x;        break;
+        case ST7735_ROTATION_180: *gx = 127 - x;  *gy = 159 - y;  break;
+        case ST7735_ROTATION_270: *gx = y;        *gy = 159 - x;  break;
+        default:                  *gx = x;        *gy = y;        break;
+    }
+}
+
+// 比较显存（当前方向的地址空间，计入滚动偏移）和玻璃快照与framebuffer；
+// 降分辨率时面板上每个scale x scale块对应framebuffer的一个像素
+static void check(const char *name, st7735_t *dev, st7735_vpanel_t *vp) {
+    unsigned s = dev->scale;
+    unsigned w = dev->width * s, h = dev->height * s;
+    uint16_t gw, gh;
+    st7735_vpanel_size(vp, &gw, &gh);
+    uint16_t *view = (uint16_t *)malloc(w * h * sizeof(uint16_t));
+    uint16_t *glass = (uint16_t *)malloc((size_t)gw * gh * sizeof(uint16_t));
+    if (!view || !glass) {
+        fprintf(stderr, "Error: Out of memory\n");
+        exit(1);
+    }
+    
+    st7735_wait_flush(dev);
+    st7735_vpanel_frame(vp);
+    st7735_vpanel_view(vp, view_x, view_y, w, h, view);
+    st7735_vpanel_snapshot(vp, glass);
+    
+    unsigned view_bad = 0, glass_bad = 0;
+    unsigned first_x = 0, first_y = 0;
+    for (unsigned y = 0; y < h; y++) {
+        for (unsigned x = 0; x < w; x++) {
+            uint16_t want = quantize(dev, fb_pixel(dev, x / s, y / s));
+            uint16_t got = quantize(dev, view[((y + dev->scroll) % h) * w + x]);
+            unsigned gx, gy;
+            glass_xy(dev->rotation, x, y, &gx, &gy);
+            uint16_t seen = quantize(dev, glass[gy * gw + gx]);
+            if (got != want && view_bad++ == 0) {
+                first_x = x;
+                first_y = y;
+            }
+            if (seen != want) glass_bad++;
+        }
+    }
+    
+    st7735_vpanel_stats_t stats;
+    st7735_vpanel_get_stats(vp, &stats);
+    bool ok = view_bad == 0 && glass_bad == 0 && stats.last.errors == 0;
+    printf(quiet ? "%-4s %s" : "%-4s %-22s", ok ? "ok" : "FAIL", name);
+    if (!quiet) {
+        printf(" %6llu cmds %4llu windows %6llu px %7llu bytes",
+               (unsigned long long)stats.last.commands, (unsigned long long)stats.last.windows,
+               (unsigned long long)stats.last.pixels,
+               (unsigned long long)(stats.last.commands + stats.last.param_bytes +
+                                    stats.last.pixel_bytes));
+        printf(" %6.3f ms", st7735_vpanel_bus_ns(&stats.last, 16e6) / 1e6);
+    }
+    printf("\n");
+    if (view_bad) {
+        printf("     GRAM: %u pixels differ, first at (%u, %u)\n", view_bad, first_x, first_y);
+    }
+    if (glass_bad) printf("     glass: %u pixels differ\n", glass_bad);
+    if (stats.last.errors) {
+        printf("     protocol: %llu errors, last: %s\n",
+               (unsigned long long)stats.last.errors, st7735_vpanel_last_error(vp));
+    }
+    if (!ok) failures++;
+    
+    if (out_dir) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s.ppm", out_dir, name);
+        st7735_vpanel_save_ppm(vp, path);
+    }
+    free(view);
+    free(glass);
+}
+
+// 测试画面：色块、图形、文字和渐变，覆盖整屏
+static void draw_scene(st7735_t *dev, unsigned seed) {
+    unsigned w = dev->width, h = dev->height;
+    
+    st7735_clear(dev, ST7735_BLACK);
+    for (unsigned y = 0; y < h; y += 4) {
+        uint16_t c = st7735_color_rgb((uint8_t)(y * 255 / h), (uint8_t)(seed * 40), 128);
+        st7735_draw_hline(dev, 0, y, w, c);
+    }
+    st7735_fill_rect(dev, 4, 4, w / 3, h / 4, ST7735_RED);
+    st7735_fill_rect(dev, w / 2, 8, w / 3, h / 5, ST7735_GREEN);
+    st7735_fill_circle(dev, w / 2, h / 2, 20, ST7735_BLUE);
+    st7735_draw_round_rect(dev, 2, h / 2 + 24, w - 4, 20, 5, ST7735_YELLOW);
+    st7735_draw_line(dev, 0, h - 1, w - 1, h / 3, ST7735_WHITE);
+    st7735_draw_string(dev, "VPANEL", 6, h - 14, ST7735_CYAN, ST7735_BLACK, 1);
+    // 右下角单个像素：方向或偏移错一格都会暴露
+    st7735_set_pixel(dev, w - 1, h - 1, ST7735_MAGENTA);
+}
+
+static void test_rotations(st7735_vpanel_t *vp) {
+    for (int r = ST7735_ROTATION_0; r <= ST7735_ROTATION_270; r++) {
+        st7735_t dev;
+        st7735_transport_t transport;
+        char name[32];
+        
+        if (open_device(&dev, vp, &transport, (st7735_rotation_t)r, false) < 0) {
+            failures++;
+            return;
+        }
+        st7735_update(&dev);
+        snprintf(name, sizeof(name), "%s-init", rotation_name[r]);
+        check(name, &dev, vp);
+        
+        draw_scene(&dev, r);
+        st7735_update(&dev);
+        snprintf(name, sizeof(name), "%s-scene", rotation_name[r]);
+        check(name, &dev, vp);
+        
+        // 小区域修改只发送脏矩形
+        st7735_fill_rect(&dev, 10, 20, 16, 8, ST7735_WHITE);
+        st7735_set_pixel(&dev, dev.width - 3, 2, ST7735_RED);
+        st7735_update(&dev);
+        snprintf(name, sizeof(name), "%s-partial", rotation_name[r]);
+        check(name, &dev, vp);
+        
+        st7735_deinit(&dev);
+    }
+}
+
+static void test_formats(st7735_vpanel_t *vp) {
+    st7735_t dev;
+    st7735_transport_t transport;
+    
+    if (open_device(&dev, vp, &transport, ST7735_ROTATION_90, false) < 0) {
+        failures++;
+        return;
+    }
+    
+    st7735_set_pixel_format(&dev, ST7735_FORMAT_RGB444);
+    draw_scene(&dev, 5);
+    st7735_update_full(&dev);
+    check("rgb444", &dev, vp);
+    // 奇数宽度的窗口：最后一个像素只占1.5字节
+    st7735_fill_rect(&dev, 7, 9, 13, 5, ST7735_GREEN);
+    st7735_update(&dev);
+    check("rgb444-odd", &dev, vp);
+    st7735_set_pixel_format(&dev, ST7735_FORMAT_RGB565);
+    
+    if (st7735_set_color_mode(&dev, ST7735_COLOR_INDEXED8) == 0) {
+        st7735_clear(&dev, st7735_color_index(0, 0, 0));
+        st7735_fill_rect(&dev, 20, 20, 60, 40, st7735_color_index(255, 0, 0));
+        st7735_fill_circle(&dev, 110, 70, 25, st7735_color_index(0, 255, 255));
+        st7735_draw_string(&dev, "INDEXED", 8, 100, st7735_color_index(255, 255, 0),
+                           st7735_color_index(0, 0, 0), 1);
+        st7735_update(&dev);
+        check("indexed", &dev, vp);
+        
+        // 只改调色板：整屏重发
+        uint16_t blue = ST7735_BLUE;
+        st7735_set_palette(&dev, st7735_color_index(255, 0, 0), 1, &blue);
+        st7735_update(&dev);
+        check("indexed-palette", &dev, vp);
+        st7735_set_color_mode(&dev, ST7735_COLOR_RGB565);
+    }
+    st7735_deinit(&dev);
+}
+
+static void test_console(st7735_vpanel_t *vp) {
+    for (int r = ST7735_ROTATION_0; r <= ST7735_ROTATION_180; r += 2) {
+        st7735_t dev;
+        st7735_transport_t transport;
+        char name[32];
+        
+        if (open_device(&dev, vp, &transport, (st7735_rotation_t)r, false) < 0) {
+            failures++;
+            return;
+        }
+        st7735_console_begin(&dev, ST7735_GREEN, ST7735_BLACK, 1);
+        // 超过一屏的行数，VSCSAD起始行绕回
+        for (int i = 0; i < 45; i++) {
+            st7735_console_printf(&dev, "line %02d %s\n", i, rotation_name[r]);
+            st7735_update(&dev);
+            if (i == 10 || i == 44) {
+                snprintf(name, sizeof(name), "console-%s-%d", rotation_name[r], i);
+                check(name, &dev, vp);
+            }
+        }
+        
+        // 最后一行上连续换行：每个换行滚动一行，空行不能合并。
+        // 上一行末尾的换行还在等待，加上这里的3个共滚动4行
+        uint16_t scroll = dev.scroll;
+        st7735_console_write(&dev, "x\n\n\nb");
+        st7735_update(&dev);
+        uint16_t want = (scroll + 4 * 8) % dev.height;
+        snprintf(name, sizeof(name), "console-%s-blank", rotation_name[r]);
+        if (dev.scroll != want) {
+            printf("FAIL %-22s scroll %u, expected %u\n", name, dev.scroll, want);
+            failures++;
+        }
+        check(name, &dev, vp);
+        st7735_console_end(&dev);
+        st7735_deinit(&dev);
+    }
+}
+
+// 132x162显存、带偏移的面板：VSCRDEF三段之和必须等于162，滚动后画面仍对齐
+static void test_gram162(void) {
+    st7735_vpanel_config_t panel = {
+        .gram_width = 132, .gram_height = 162, .width = 128, .height = 160,
+        .col_offset = 2, .row_offset = 1, .panel_madctl = 0xC8,
+    };
+    st7735_vpanel_t *vp = st7735_vpanel_create(&panel);
+    st7735_config_t config;
+    st7735_transport_t transport;
+    st7735_t dev;
+    
+    if (!vp) {
+        failures++;
+        return;
+    }
+    transport = st7735_vpanel_transport(vp);
+    st7735_config_default(&config);
+    config.gpio_backend = ST7735_GPIO_FAKE;
+    config.rst_pin = -1;
+    config.rotation = ST7735_ROTATION_0;
+    config.col_offset = panel.col_offset;
+    config.row_offset = panel.row_offset;
+    config.transport = &transport;
+    if (st7735_init_config(&dev, &config) < 0) {
+        failures++;
+        st7735_vpanel_destroy(vp);
+        return;
+    }
+    st7735_console_begin(&dev, ST7735_GREEN, ST7735_BLACK, 1);
+    for (int i = 0; i < 30; i++) {
+        st7735_console_printf(&dev, "gram162 %02d\n", i);
+    }
+    st7735_console_printf(&dev, "end");
+    st7735_update(&dev);
+    view_x = panel.col_offset;
+    view_y = panel.row_offset;
+    check("console-gram162", &dev, vp);
+    view_x = view_y = 0;
+    st7735_console_end(&dev);
+    st7735_deinit(&dev);
+    st7735_vpanel_destroy(vp);
+}
+
+static void test_async(st7735_vpanel_t *vp) {
+    st7735_t dev;
+    st7735_transport_t transport;
+    
+    if (open_device(&dev, vp, &transport, ST7735_ROTATION_0, false) < 0 ||
+        st7735_enable_async(&dev) < 0) {
+        failures++;
+        return;
+    }
+    for (int frame = 0; frame < 8; frame++) {
+        st7735_fill_rect(&dev, 0, 0, dev.width, dev.height, ST7735_BLACK);
+        st7735_fill_circle(&dev, 20 + frame * 10, 40 + frame * 8, 12, ST7735_YELLOW);
+        st7735_update_async(&dev);
+    }
+    check("async", &dev, vp);
+    st7735_deinit(&dev);
+}
+
+// 降分辨率渲染：刷新时放大，显存中每个块与framebuffer的像素一致
+static void test_scaled(st7735_vpanel_t *vp) {
+    static const uint8_t scales[] = { 2, 4 };
+    char name[32];
+    
+    for (unsigned i = 0; i < sizeof(scales); i++) {
+        st7735_t dev;
+        st7735_transport_t transport;
+        unsigned s = scales[i];
+        
+        if (open_device(&dev, vp, &transport, ST7735_ROTATION_90, false) < 0) {
+            failures++;
+            return;
+        }
+        draw_scene(&dev, 9);
+        // 切换时按最近邻重采样并整屏重发
+        if (st7735_set_render_scale(&dev, s) < 0) {
+            printf("FAIL scale%u: set_render_scale failed\n", s);
+            failures++;
+            st7735_deinit(&dev);
+            continue;
+        }
+        st7735_update(&dev);
+        snprintf(name, sizeof(name), "scale%u-resample", s);
+        check(name, &dev, vp);
+        
+        draw_scene(&dev, 10);
+        st7735_update(&dev);
+        snprintf(name, sizeof(name), "scale%u-scene", s);
+        check(name, &dev, vp);
+        
+        st7735_fill_rect(&dev, 3, 5, 7, 3, ST7735_WHITE);
+        st7735_set_pixel(&dev, dev.width - 1, 0, ST7735_RED);
+        st7735_update(&dev);
+        snprintf(name, sizeof(name), "scale%u-partial", s);
+        check(name, &dev, vp);
+        
+        // 旋转后缓冲尺寸不变，宽高互换
+        st7735_set_rotation(&dev, ST7735_ROTATION_180);
+        draw_scene(&dev, 11);
+        st7735_update(&dev);
+        snprintf(name, sizeof(name), "scale%u-rot180", s);
+        check(name, &dev, vp);
+        
+        st7735_set_pixel_format(&dev, ST7735_FORMAT_RGB444);
+        draw_scene(&dev, 12);
+        st7735_update_full(&dev);
+        snprintf(name, sizeof(name), "scale%u-rgb444", s);
+        check(name, &dev, vp);
+        st7735_set_pixel_format(&dev, ST7735_FORMAT_RGB565);
+        
+        if (st7735_set_color_mode(&dev, ST7735_COLOR_INDEXED8) == 0) {
+            st7735_clear(&dev, st7735_color_index(0, 0, 0));
+            st7735_fill_rect(&dev, 2, 2, dev.width / 2, dev.height / 3, st7735_color_index(255, 0, 0));
+            st7735_fill_circle(&dev, dev.width / 2, dev.height / 2, 6, st7735_color_index(0, 255, 255));
+            st7735_update(&dev);
+            snprintf(name, sizeof(name), "scale%u-indexed", s);
+            check(name, &dev, vp);
+            st7735_set_color_mode(&dev, ST7735_COLOR_RGB565);
+        }
+        
+        if (st7735_enable_async(&dev) == 0) {
+            for (int frame = 0; frame < 4; frame++) {
+                st7735_clear(&dev, ST7735_BLACK);
+                st7735_fill_circle(&dev, 5 + frame * 3, 8 + frame * 2, 4, ST7735_YELLOW);
+                st7735_update_async(&dev);
+            }
+            snprintf(name, sizeof(name), "scale%u-async", s);
+            check(name, &dev, vp);
+            st7735_disable_async(&dev);
+        }
+        
+        // 恢复全分辨率：内容放大后整屏重发
+        st7735_set_render_scale(&dev, 1);
+        st7735_update(&dev);
+        snprintf(name, sizeof(name), "scale%u-restore", s);
+        check(name, &dev, vp);
+        st7735_deinit(&dev);
+    }
+}
+
+// 热启动：面板已唤醒时不复位，RDDST从模拟器读出状态。
+// 第一个设备不关闭，相当于服务异常退出后面板保持显示
+static void test_warm_start(st7735_vpanel_t *vp) {
+    st7735_t first, dev;
+    st7735_transport_t transport[2];
+    st7735_init_timing_t timing;
+    
+    if (open_device(&first, vp, &transport[0], ST7735_ROTATION_0, false) < 0) {
+        failures++;
+        return;
+    }
+    draw_scene(&first, 7);
+    st7735_update(&first);
+    check("warm-before", &first, vp);
+    
+    if (open_device(&dev, vp, &transport[1], ST7735_ROTATION_0, true) < 0) {
+        failures++;
+        st7735_deinit(&first);
+        return;
+    }
+    st7735_get_init_timing(&dev, &timing);
+    printf("%-4s %-22s %s\n", timing.warm ? "ok" : "FAIL", "warm-start",
+           timing.warm ? "panel awake, reset skipped" : "status not read");
+    if (!timing.warm) failures++;
+    draw_scene(&dev, 8);
+    st7735_update(&dev);
+    check("warm-after", &dev, vp);
+    st7735_deinit(&dev);
+    st7735_deinit(&first);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-o DIR] [-q]\n"
+                    "  -o  save a PPM snapshot of the glass for each check into DIR\n"
+                    "  -q  print only the result of each check, without frame statistics\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    int opt;
+    
+    while ((opt = getopt(argc, argv, "o:qh")) != -1) {
+        switch (opt) {
+            case 'o':
+                out_dir = optarg;
+                break;
+            case 'q':
+                quiet = true;
+                break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 2;
+        }
+    }
+    
+    st7735_vpanel_t *vp = st7735_vpanel_create(NULL);
+    if (!vp) return 1;
+    
+    test_rotations(vp);
+    test_formats(vp);
+    test_console(vp);
+    test_gram162();
+    test_async(vp);
+    test_scaled(vp);
+    test_warm_start(vp);
+    
+    // 关闭后面板处于睡眠，玻璃上全黑
+    uint16_t gw, gh;
+    st7735_vpanel_size(vp, &gw, &gh);
+    uint16_t *glass = (uint16_t *)calloc((size_t)gw * gh, sizeof(uint16_t));
+    if (glass) {
+        st7735_vpanel_snapshot(vp, glass);
+        for (size_t i = 0; i < (size_t)gw * gh; i++) {
+            if (glass[i]) {
+                printf("FAIL panel still showing after deinit\n");
+                failures++;
+                break;
+            }
+        }
+        free(glass);
+    }
+    
+    st7735_vpanel_frame(vp);
+    st7735_vpanel_stats_t stats;
+    st7735_vpanel_get_stats(vp, &stats);
+    if (stats.total.errors) {
+        printf("FAIL protocol errors: %llu, last: %s\n",
+               (unsigned long long)stats.total.errors, st7735_vpanel_last_error(vp));
+        failures++;
+    }
+    if (!quiet) {
+        printf("\n");
+        st7735_print_vpanel_stats(&stats, stdout);
+    }
+    st7735_vpanel_destroy(vp);
+    
+    printf("%s: %d failures\n", failures ? "FAILED" : "PASSED", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,437 @@
+#include "st7735_video.h"
+#include "st7735_pixel.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// 差分帧文件布局（多字节字段均为小端）：
+//   文件头24字节：magic[8] width height fps keyint (u16) frames reserved (u32)
+//   每帧：size (u32，本字段之后的字节数) rect_count flags (u16)，
+//         然后rect_count个 {x y w h (u16), w*h个大端RGB565像素}
+#define VIDEO_HEADER_SIZE   24
+#define FRAME_HEADER_SIZE   8
+#define RECT_HEADER_SIZE    8
+#define FRAME_KEY           0x0001
+// 原始帧文件没有帧率信息时的默认值
+#define VIDEO_DEFAULT_FPS   30
+// 编码时按这么多行一条带比较，每条带输出一个变化区域的外接矩形
+#define ENCODE_BAND_ROWS    16
+
+typedef struct {
+    const uint8_t *map;
+    size_t size;
+    uint16_t width;
+    uint16_t height;
+    uint16_t fps;
+    uint32_t frames;
+    size_t frame_bytes;         // 原始帧：每帧字节数
+    uint32_t *offsets;          // 差分帧：各帧帧头在文件中的偏移，NULL表示原始帧
+    uint8_t *key;               // 差分帧：是否关键帧
+} video_t;
+
+static uint16_t get16(const uint8_t *p) {
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t get32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void put16(uint8_t *p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+static void put32(uint8_t *p, uint32_t v) {
+    put16(p, v & 0xFFFF);
+    put16(p + 2, v >> 16);
+}
+
+static uint64_t video_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void sleep_until(uint64_t deadline) {
+    struct timespec ts = {
+        .tv_sec = deadline / 1000000000ull,
+        .tv_nsec = deadline % 1000000000ull,
+    };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+}
+
+// 映射整个文件，失败返回NULL
+static const uint8_t *map_file(const char *path, size_t *size) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        fprintf(stderr, "Error: Failed to open video %s\n", path);
+        return NULL;
+    }
+    
+    struct stat st;
+    void *map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "Error: Failed to map video %s\n", path);
+        return NULL;
+    }
+    
+    // 帧按顺序读取，让内核提前读入后面的页
+    madvise(map, st.st_size, MADV_SEQUENTIAL);
+    *size = st.st_size;
+    return (const uint8_t *)map;
+}
+
+// ===== 读取 =====
+
+// 扫描差分帧文件建立帧索引，同时检查每个区域都在屏幕内、数据不越过文件末尾
+static int index_delta(video_t *v) {
+    v->offsets = (uint32_t *)malloc(v->frames * sizeof(uint32_t));
+    v->key = (uint8_t *)malloc(v->frames);
+    if (!v->offsets || !v->key) return -1;
+    
+    size_t pos = VIDEO_HEADER_SIZE;
+    for (uint32_t i = 0; i < v->frames; i++) {
+        if (pos + FRAME_HEADER_SIZE > v->size) return -1;
+        size_t end = pos + 4 + get32(v->map + pos);
+        uint16_t count = get16(v->map + pos + 4);
+        if (end > v->size || end > UINT32_MAX) return -1;
+        
+        v->offsets[i] = pos;
+        v->key[i] = (get16(v->map + pos + 6) & FRAME_KEY) != 0;
+        
+        size_t p = pos + FRAME_HEADER_SIZE;
+        for (uint16_t r = 0; r < count; r++) {
+            if (p + RECT_HEADER_SIZE > end) return -1;
+            const uint8_t *h = v->map + p;
+            uint16_t x = get16(h), y = get16(h + 2), w = get16(h + 4), rh = get16(h + 6);
+            if (w == 0 || rh == 0 || x + w > v->width || y + rh > v->height) return -1;
+            p += RECT_HEADER_SIZE + (size_t)w * rh * sizeof(uint16_t);
+        }
+        if (p != end) return -1;
+        pos = end;
+    }
+    
+    // 第一帧必须是关键帧，否则丢帧和循环后画面无法恢复
+    return v->key[0] ? 0 : -1;
+}
+
+static void video_close(video_t *v) {
+    if (v->map) munmap((void *)v->map, v->size);
+    free(v->offsets);
+    free(v->key);
+}
+
+static int video_open(video_t *v, const char *path, uint16_t width, uint16_t height) {
+    memset(v, 0, sizeof(*v));
+    v->map = map_file(path, &v->size);
+    if (!v->map) return -1;
+    
+    if (v->size >= VIDEO_HEADER_SIZE &&
+        memcmp(v->map, ST7735_VIDEO_MAGIC, strlen(ST7735_VIDEO_MAGIC)) == 0) {
+        v->width = get16(v->map + 8);
+        v->height = get16(v->map + 10);
+        v->fps = get16(v->map + 12);
+        v->frames = get32(v->map + 16);
+        if (v->width != width || v->height != height) {
+            fprintf(stderr, "Error: Video is %ux%u, screen is %ux%u\n",
+                    v->width, v->height, width, height);
+            video_close(v);
+            return -1;
+        }
+        if (v->frames == 0 || index_delta(v) < 0) {
+            fprintf(stderr, "Error: Corrupt video %s\n", path);
+            video_close(v);
+            return -1;
+        }
+        return 0;
+    }
+    
+    // 原始帧：尺寸取屏幕尺寸，末尾不足一帧的数据忽略
+    v->width = width;
+    v->height = height;
+    v->fps = VIDEO_DEFAULT_FPS;
+    v->frame_bytes = (size_t)width * height * sizeof(uint16_t);
+    v->frames = v->size / v->frame_bytes;
+    if (v->frames == 0) {
+        fprintf(stderr, "Error: Video %s is smaller than one %ux%u frame\n", path, width, height);
+        video_close(v);
+        return -1;
+    }
+    return 0;
+}
+
+// 依次处理第i帧的每个区域：屏幕或framebuffer
+static void frame_rects(const video_t *v, uint32_t i, st7735_t *dev, bool to_screen) {
+    if (!v->offsets) {
+        const uint8_t *data = v->map + (size_t)i * v->frame_bytes;
+        if (to_screen) {
+            st7735_write_raw(dev, 0, 0, v->width, v->height, data);
+        } else {
+            st7735_swap16(dev->framebuffer, (const uint16_t *)data,
+                          (size_t)v->width * v->height);
+        }
+        return;
+    }
+    
+    const uint8_t *p = v->map + v->offsets[i];
+    uint16_t count = get16(p + 4);
+    p += FRAME_HEADER_SIZE;
+    for (uint16_t r = 0; r < count; r++) {
+        uint16_t x = get16(p), y = get16(p + 2), w = get16(p + 4), h = get16(p + 6);
+        // 像素紧跟在8字节的区域头之后，相对文件开头保持2字节对齐
+        const uint16_t *pixels = (const uint16_t *)(p + RECT_HEADER_SIZE);
+        if (to_screen) {
+            st7735_write_raw(dev, x, y, w, h, pixels);
+        } else {
+            for (uint16_t row = 0; row < h; row++) {
+                st7735_swap16(&dev->framebuffer[(y + row) * dev->width + x],
+                              pixels + (size_t)row * w, w);
+            }
+        }
+        p += RECT_HEADER_SIZE + (size_t)w * h * sizeof(uint16_t);
+    }
+}
+
+// 落后时从第i帧跳到第due帧：原始帧直接跳，差分帧只能跳到关键帧
+static uint32_t skip_target(const video_t *v, uint32_t i, uint32_t due) {
+    if (!v->offsets) return due;
+    for (uint32_t k = due; k > i; k--) {
+        if (v->key[k]) return k;
+    }
+    return i;
+}
+
+// 把屏幕上的最后一帧重建到framebuffer：差分帧从最近的关键帧开始叠加
+static void restore_framebuffer(st7735_t *dev, const video_t *v, uint32_t last) {
+    uint32_t first = last;
+    if (v->offsets) {
+        while (first > 0 && !v->key[first]) first--;
+    }
+    for (uint32_t i = first; i <= last; i++) {
+        frame_rects(v, i, dev, false);
+    }
+    
+    // 双缓冲时另一个缓冲还是旧内容，整屏标脏使下次提交时同步过去
+    if (dev->async) {
+        st7735_mark_dirty(dev, 0, 0, dev->width, dev->height);
+    }
+}
+
+// ===== 播放 =====
+
+int st7735_play_video(st7735_t *dev, const char *path, const st7735_video_opts_t *opts,
+                      st7735_video_stats_t *stats) {
+    st7735_video_opts_t defaults = { 0 };
+    video_t v;
+    
+    if (!dev || !dev->framebuffer || !path) return -1;
+    if (!opts) opts = &defaults;
+    if (dev->format != ST7735_FORMAT_RGB565) {
+        fprintf(stderr, "Error: Video playback needs the RGB565 wire format\n");
+        return -1;
+    }
+    if (dev->scale > 1) {
+        fprintf(stderr, "Error: Video playback needs full render resolution\n");
+        return -1;
+    }
+    if (video_open(&v, path, dev->width, dev->height) < 0) return -1;
+    
+    double fps = opts->fps > 0 ? opts->fps : v.fps;
+    uint64_t period = (uint64_t)(1e9 / fps);
+    int loops = opts->loops;
+    uint32_t i = 0;
+    uint32_t last = 0;
+    uint32_t shown = 0;
+    uint32_t dropped = 0;
+    double late_sum = 0;
+    double late_sq = 0;
+    uint64_t late_max = 0;
+    uint64_t send_ns = 0;
+    uint64_t t0 = video_now();
+    uint64_t start = t0;
+    
+    while (!(opts->stop && *opts->stop)) {
+        if (i >= v.frames) {
+            if (loops == 0) break;
+            if (loops > 0) loops--;
+            // 下一轮接着当前时间表，不重新对齐起点
+            t0 += (uint64_t)v.frames * period;
+            i = 0;
+        }
+        
+        uint64_t now = video_now();
+        uint64_t deadline = t0 + i * period;
+        if (now > deadline) {
+            uint64_t due = (now - t0) / period;
+            if (due >= v.frames) due = v.frames - 1;
+            uint32_t target = skip_target(&v, i, (uint32_t)due);
+            dropped += target - i;
+            i = target;
+            deadline = t0 + i * period;
+        } else {
+            sleep_until(deadline);
+            now = video_now();
+        }
+        
+        uint64_t late = now > deadline ? now - deadline : 0;
+        late_sum += late;
+        late_sq += (double)late * late;
+        if (late > late_max) late_max = late;
+        
+        frame_rects(&v, i, dev, true);
+        send_ns += video_now() - now;
+        shown++;
+        last = i++;
+    }
+    
+    uint64_t elapsed = video_now() - start;
+    if (shown > 0) restore_framebuffer(dev, &v, last);
+    
+    if (stats) {
+        double mean = shown ? late_sum / shown : 0;
+        double var = shown ? late_sq / shown - mean * mean : 0;
+        stats->frames = v.frames;
+        stats->shown = shown;
+        stats->dropped = dropped;
+        stats->fps = elapsed ? shown * 1e9 / elapsed : 0;
+        stats->jitter_ms = var > 0 ? sqrt(var) / 1e6 : 0;
+        stats->late_max_ms = late_max / 1e6;
+        stats->send_ms = shown ? send_ns / 1e6 / shown : 0;
+    }
+    
+    video_close(&v);
+    return 0;
+}
+
+void st7735_print_video_stats(const st7735_video_stats_t *stats, FILE *fp) {
+    if (!stats) return;
+    if (!fp) fp = stdout;
+    
+    fprintf(fp, "Video: %u/%u frames shown, %u dropped, %.1f fps\n",
+            stats->shown, stats->frames, stats->dropped, stats->fps);
+    fprintf(fp, "  jitter %.3f ms, max late %.3f ms, send %.3f ms/frame\n",
+            stats->jitter_ms, stats->late_max_ms, stats->send_ms);
+}
+
+// ===== 编码 =====
+
+// 比较一条带内两帧的差异，返回是否有变化及外接矩形
+static bool band_bounds(const uint16_t *prev, const uint16_t *cur, uint16_t width,
+                        uint16_t y0, uint16_t y1, uint16_t r[4]) {
+    int min_x = width, max_x = -1, min_y = -1, max_y = -1;
+    
+    for (int y = y0; y < y1; y++) {
+        const uint16_t *a = prev + (size_t)y * width;
+        const uint16_t *b = cur + (size_t)y * width;
+        if (memcmp(a, b, width * sizeof(uint16_t)) == 0) continue;
+        
+        int x0 = 0, x1 = width - 1;
+        while (a[x0] == b[x0]) x0++;
+        while (a[x1] == b[x1]) x1--;
+        if (x0 < min_x) min_x = x0;
+        if (x1 > max_x) max_x = x1;
+        if (min_y < 0) min_y = y;
+        max_y = y;
+    }
+    if (max_x < 0) return false;
+    
+    r[0] = min_x;
+    r[1] = min_y;
+    r[2] = max_x - min_x + 1;
+    r[3] = max_y - min_y + 1;
+    return true;
+}
+
+// 写出一帧：rects为count个{x, y, w, h}，像素从帧中逐行取出（已是大端）
+static int write_frame(FILE *fp, const uint16_t *frame, uint16_t width,
+                       const uint16_t (*rects)[4], uint16_t count, bool key) {
+    uint32_t size = FRAME_HEADER_SIZE - 4;
+    for (uint16_t i = 0; i < count; i++) {
+        size += RECT_HEADER_SIZE + (uint32_t)rects[i][2] * rects[i][3] * sizeof(uint16_t);
+    }
+    
+    uint8_t header[FRAME_HEADER_SIZE];
+    put32(header, size);
+    put16(header + 4, count);
+    put16(header + 6, key ? FRAME_KEY : 0);
+    if (fwrite(header, sizeof(header), 1, fp) != 1) return -1;
+    
+    for (uint16_t i = 0; i < count; i++) {
+        uint8_t rh[RECT_HEADER_SIZE];
+        for (int j = 0; j < 4; j++) put16(rh + j * 2, rects[i][j]);
+        if (fwrite(rh, sizeof(rh), 1, fp) != 1) return -1;
+        for (uint16_t row = 0; row < rects[i][3]; row++) {
+            const uint16_t *src = frame + (size_t)(rects[i][1] + row) * width + rects[i][0];
+            if (fwrite(src, sizeof(uint16_t), rects[i][2], fp) != rects[i][2]) return -1;
+        }
+    }
+    return 0;
+}
+
+int st7735_video_encode(const char *raw_path, const char *out_path,
+                        uint16_t width, uint16_t height, uint16_t fps, uint16_t keyint) {
+    if (!raw_path || !out_path || width == 0 || height == 0) return -1;
+    
+    size_t size;
+    const uint8_t *map = map_file(raw_path, &size);
+    if (!map) return -1;
+    
+    size_t frame_bytes = (size_t)width * height * sizeof(uint16_t);
+    uint32_t frames = size / frame_bytes;
+    uint16_t bands = (height + ENCODE_BAND_ROWS - 1) / ENCODE_BAND_ROWS;
+    uint16_t (*rects)[4] = (uint16_t (*)[4])malloc(bands * sizeof(*rects));
+    FILE *fp = frames && rects ? fopen(out_path, "wb") : NULL;
+    int ret = fp ? 0 : -1;
+    
+    if (fp) {
+        uint8_t header[VIDEO_HEADER_SIZE] = { 0 };
+        memcpy(header, ST7735_VIDEO_MAGIC, strlen(ST7735_VIDEO_MAGIC));
+        put16(header + 8, width);
+        put16(header + 10, height);
+        put16(header + 12, fps ? fps : VIDEO_DEFAULT_FPS);
+        put16(header + 14, keyint);
+        put32(header + 16, frames);
+        if (fwrite(header, sizeof(header), 1, fp) != 1) ret = -1;
+    }
+    
+    for (uint32_t i = 0; ret == 0 && i < frames; i++) {
+        const uint16_t *cur = (const uint16_t *)(map + (size_t)i * frame_bytes);
+        bool key = i == 0 || (keyint && i % keyint == 0);
+        uint16_t count = 0;
+        
+        if (key) {
+            rects[0][0] = 0;
+            rects[0][1] = 0;
+            rects[0][2] = width;
+            rects[0][3] = height;
+            count = 1;
+        } else {
+            const uint16_t *prev = cur - frame_bytes / sizeof(uint16_t);
+            for (uint16_t b = 0; b < bands; b++) {
+                uint16_t y0 = b * ENCODE_BAND_ROWS;
+                uint16_t y1 = y0 + ENCODE_BAND_ROWS < height ? y0 + ENCODE_BAND_ROWS : height;
+                if (band_bounds(prev, cur, width, y0, y1, rects[count])) count++;
+            }
+        }
+        if (write_frame(fp, cur, width, (const uint16_t (*)[4])rects, count, key) < 0) ret = -1;
+    }
+    
+    if (fp && fclose(fp) != 0) ret = -1;
+    if (ret < 0) fprintf(stderr, "Error: Failed to encode video %s\n", out_path);
+    free(rects);
+    munmap((void *)map, size);
+    return ret;
+}
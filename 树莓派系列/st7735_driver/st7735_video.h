@@ -0,0 +1,44 @@
+#ifndef ST7735_VIDEO_H
+#define ST7735_VIDEO_H
+
+#include <stdint.h>
+#include "st7735.h"
+
+// 视频播放：mmap预先转换好的帧文件，按单调时钟定时把帧直接从映射内存发送到SPI，
+// 不复制到framebuffer。支持两种文件：
+//   原始帧：无文件头，连续的整屏大端RGB565帧，可用ffmpeg生成：
+//     ffmpeg -i in.mp4 -vf scale=160:128 -f rawvideo -pix_fmt rgb565be out.raw
+//   差分帧：st7735_video_encode()由原始帧生成，每帧只保存变化的区域，
+//     每隔keyint帧一个整屏关键帧
+// 落后于时间表时丢帧：原始帧直接跳到当前应显示的帧，差分帧跳到已到期的最近关键帧
+
+#define ST7735_VIDEO_MAGIC  "ST7735V1"
+
+typedef struct {
+    double fps;             // 目标帧率，0时使用文件头中的值（原始帧默认30）
+    int loops;              // 额外循环次数，-1无限循环
+    volatile int *stop;     // 非NULL且变为非0时提前结束（例如信号处理函数设置）
+} st7735_video_opts_t;
+
+typedef struct {
+    uint32_t frames;        // 文件中的帧数
+    uint32_t shown;         // 实际发送的帧数
+    uint32_t dropped;       // 因落后而跳过的帧数
+    double fps;             // 实际帧率
+    double jitter_ms;       // 帧开始发送时刻相对计划时刻偏差的标准差
+    double late_max_ms;     // 最大偏差
+    double send_ms;         // 平均每帧发送时间
+} st7735_video_stats_t;
+
+// 播放文件，帧尺寸必须等于当前方向下的屏幕尺寸；opts/stats可为NULL。
+// 播放结束后最后一帧被复制进framebuffer，之后可以直接在其上绘制
+int st7735_play_video(st7735_t *dev, const char *path, const st7735_video_opts_t *opts,
+                      st7735_video_stats_t *stats);
+
+// 把原始帧文件转换为差分帧文件，keyint为关键帧间隔（0表示只有第一帧）
+int st7735_video_encode(const char *raw_path, const char *out_path,
+                        uint16_t width, uint16_t height, uint16_t fps, uint16_t keyint);
+
+void st7735_print_video_stats(const st7735_video_stats_t *stats, FILE *fp);
+
+#endif // ST7735_VIDEO_H
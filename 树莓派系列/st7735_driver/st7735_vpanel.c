@@ -0,0 +1,691 @@
+#include "st7735_vpanel.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+
+// ST7735命令
+#define CMD_NOP         0x00
+#define CMD_SWRESET     0x01
+#define CMD_RDDID       0x04
+#define CMD_RDDST       0x09
+#define CMD_SLPIN       0x10
+#define CMD_SLPOUT      0x11
+#define CMD_PTLON       0x12
+#define CMD_NORON       0x13
+#define CMD_INVOFF      0x20
+#define CMD_INVON       0x21
+#define CMD_DISPOFF     0x28
+#define CMD_DISPON      0x29
+#define CMD_CASET       0x2A
+#define CMD_RASET       0x2B
+#define CMD_RAMWR       0x2C
+#define CMD_VSCRDEF     0x33
+#define CMD_MADCTL      0x36
+#define CMD_VSCSAD      0x37
+#define CMD_IDMOFF      0x38
+#define CMD_IDMON       0x39
+#define CMD_COLMOD      0x3A
+
+#define MADCTL_MY       0x80
+#define MADCTL_MX       0x40
+#define MADCTL_MV       0x20
+#define MADCTL_BGR      0x08
+
+// RDDID应答（ID1制造商、ID2版本、ID3驱动）
+#define ID1             0x7C
+#define ID2             0x89
+#define ID3             0xF0
+
+// 数据手册要求的等待（微秒）
+#define WAIT_RESET_CMD      5000    // SWRESET之后发下一个命令
+#define WAIT_RESET_SLPOUT   120000  // SWRESET之后发SLPOUT
+#define WAIT_SLPOUT_SLPIN   120000  // SLPOUT之后发SLPIN
+
+#define PARAMS_ANY      -1          // 未模拟的命令，参数个数不检查
+
+struct st7735_vpanel {
+    st7735_vpanel_config_t config;
+    uint32_t *gram;             // 每像素18位：R6 << 12 | G6 << 6 | B6，按收到的顺序（不做BGR交换）
+    // 寄存器
+    uint8_t madctl;
+    uint8_t colmod;
+    bool sleep;
+    bool display_on;
+    bool inverted;
+    bool idle;
+    bool partial;
+    bool scrolling;             // VSCSAD进入滚动模式，NORON/PTLON退出
+    uint16_t tfa, vsa, bfa, ssa;
+    uint16_t xs, xe, ys, ye;    // 窗口（当前MADCTL的地址空间）
+    uint16_t x, y;              // 地址计数器
+    // 命令解码
+    int cmd;                    // 当前命令，-1表示复位后还没有收到命令
+    uint8_t params[16];
+    unsigned nparams;
+    uint32_t acc;               // RAMWR：未凑满一个像素的位
+    unsigned acc_bits;
+    // 读命令的应答：dummy位在最高位
+    uint64_t reply;
+    unsigned reply_bits;
+    unsigned reply_pos;
+    // 时序（微秒，虚拟时钟）
+    uint64_t skipped;
+    uint64_t reset_at;
+    uint64_t slpout_at;
+    bool after_reset;
+    bool after_slpout;
+    // 统计
+    int last_dc;
+    st7735_vpanel_counts_t cur;
+    st7735_vpanel_stats_t stats;
+    char error[128];
+};
+
+static uint64_t vpanel_now(const st7735_vpanel_t *vp) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ull + ts.tv_nsec / 1000 + vp->skipped;
+}
+
+static void vpanel_error(st7735_vpanel_t *vp, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+static void vpanel_error(st7735_vpanel_t *vp, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(vp->error, sizeof(vp->error), fmt, ap);
+    va_end(ap);
+    vp->cur.errors++;
+}
+
+// 当前MADCTL下地址空间的宽高（MV交换行列）
+static uint16_t addr_width(const st7735_vpanel_t *vp, uint8_t madctl) {
+    return (madctl & MADCTL_MV) ? vp->config.gram_height : vp->config.gram_width;
+}
+
+static uint16_t addr_height(const st7735_vpanel_t *vp, uint8_t madctl) {
+    return (madctl & MADCTL_MV) ? vp->config.gram_width : vp->config.gram_height;
+}
+
+// 地址(x, y)对应的显存列和行：MV交换，MX镜像列，MY镜像行
+static bool to_gram(const st7735_vpanel_t *vp, uint8_t madctl, unsigned x, unsigned y,
+                    unsigned *col, unsigned *row) {
+    unsigned gw = vp->config.gram_width, gh = vp->config.gram_height;
+    unsigned c = (madctl & MADCTL_MV) ? y : x;
+    unsigned r = (madctl & MADCTL_MV) ? x : y;
+    if (c >= gw || r >= gh) return false;
+    *col = (madctl & MADCTL_MX) ? gw - 1 - c : c;
+    *row = (madctl & MADCTL_MY) ? gh - 1 - r : r;
+    return true;
+}
+
+static uint16_t to_rgb565(uint32_t v) {
+    return (uint16_t)(((v >> 13) & 0x1F) << 11 | ((v >> 6) & 0x3F) << 5 | ((v >> 1) & 0x1F));
+}
+
+// 寄存器恢复复位值（上电、SWRESET和硬件复位），显存不变
+static void reset_registers(st7735_vpanel_t *vp) {
+    vp->madctl = 0;
+    vp->colmod = 0x06;
+    vp->sleep = true;
+    vp->display_on = false;
+    vp->inverted = false;
+    vp->idle = false;
+    vp->partial = false;
+    vp->scrolling = false;
+    vp->tfa = 0;
+    vp->vsa = vp->config.gram_height;
+    vp->bfa = 0;
+    vp->ssa = 0;
+    vp->xs = vp->ys = 0;
+    vp->xe = vp->config.gram_width - 1;
+    vp->ye = vp->config.gram_height - 1;
+    vp->x = vp->y = 0;
+    vp->cmd = -1;
+    vp->nparams = 0;
+    vp->acc_bits = 0;
+    vp->reply_bits = 0;
+    vp->after_slpout = false;
+}
+
+st7735_vpanel_t *st7735_vpanel_create(const st7735_vpanel_config_t *config) {
+    st7735_vpanel_config_t cfg = {
+        .gram_width = 128, .gram_height = 160,
+        .panel_madctl = MADCTL_MX | MADCTL_MY | MADCTL_BGR,
+    };
+    if (config) cfg = *config;
+    if (!cfg.gram_width) cfg.gram_width = 128;
+    if (!cfg.gram_height) cfg.gram_height = 160;
+    if (cfg.gram_width > ST7735_VPANEL_MAX_W || cfg.gram_height > ST7735_VPANEL_MAX_H) {
+        fprintf(stderr, "Error: Virtual panel GRAM %ux%u too large\n",
+                cfg.gram_width, cfg.gram_height);
+        return NULL;
+    }
+    
+    st7735_vpanel_t *vp = (st7735_vpanel_t *)calloc(1, sizeof(*vp));
+    if (!vp) return NULL;
+    vp->config = cfg;
+    
+    // 可见区域默认是整个地址空间（panel_madctl的MV决定横竖）
+    uint16_t aw = addr_width(vp, cfg.panel_madctl), ah = addr_height(vp, cfg.panel_madctl);
+    if (!vp->config.width) vp->config.width = aw - cfg.col_offset;
+    if (!vp->config.height) vp->config.height = ah - cfg.row_offset;
+    if (cfg.col_offset + vp->config.width > aw || cfg.row_offset + vp->config.height > ah) {
+        fprintf(stderr, "Error: Virtual panel area outside GRAM\n");
+        free(vp);
+        return NULL;
+    }
+    
+    vp->gram = (uint32_t *)malloc((size_t)cfg.gram_width * cfg.gram_height * sizeof(uint32_t));
+    if (!vp->gram) {
+        free(vp);
+        return NULL;
+    }
+    // 上电时显存内容不确定：填充固定种子的伪随机数，结果可重复
+    uint32_t seed = 0x2545F491;
+    for (size_t i = 0; i < (size_t)cfg.gram_width * cfg.gram_height; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        vp->gram[i] = seed & 0x3FFFF;
+    }
+    
+    vp->last_dc = -1;
+    reset_registers(vp);
+    return vp;
+}
+
+void st7735_vpanel_destroy(st7735_vpanel_t *vp) {
+    if (!vp) return;
+    free(vp->gram);
+    free(vp);
+}
+
+void st7735_vpanel_reset(st7735_vpanel_t *vp) {
+    if (!vp) return;
+    reset_registers(vp);
+    vp->reset_at = vpanel_now(vp);
+    vp->after_reset = true;
+}
+
+void st7735_vpanel_delay(st7735_vpanel_t *vp, unsigned ms) {
+    if (!vp) return;
+    vp->skipped += (uint64_t)ms * 1000;
+}
+
+// 命令的参数个数，PARAMS_ANY为不检查
+static int expected_params(int cmd) {
+    switch (cmd) {
+        case CMD_CASET:
+        case CMD_RASET:
+            return 4;
+        case CMD_MADCTL:
+        case CMD_COLMOD:
+            return 1;
+        case CMD_VSCRDEF:
+            return 6;
+        case CMD_VSCSAD:
+            return 2;
+        case CMD_NOP:
+        case CMD_SWRESET:
+        case CMD_RDDID:
+        case CMD_RDDST:
+        case CMD_SLPIN:
+        case CMD_SLPOUT:
+        case CMD_PTLON:
+        case CMD_NORON:
+        case CMD_INVOFF:
+        case CMD_INVON:
+        case CMD_DISPOFF:
+        case CMD_DISPON:
+        case CMD_IDMOFF:
+        case CMD_IDMON:
+            return 0;
+        default:
+            return PARAMS_ANY;
+    }
+}
+
+// RDDST的32位状态
+static uint32_t display_status(const st7735_vpanel_t *vp) {
+    uint32_t status = (uint32_t)(vp->madctl & 0xFC) << 23;
+    if (!vp->sleep) status |= 1u << 31;             // 升压电路
+    status |= (uint32_t)(vp->colmod & 0x07) << 20;
+    if (vp->idle) status |= 1u << 19;
+    if (vp->partial) status |= 1u << 18;
+    if (!vp->sleep) status |= 1u << 17;
+    if (!vp->partial && !vp->scrolling) status |= 1u << 16;
+    if (vp->scrolling) status |= 1u << 15;
+    if (vp->inverted) status |= 1u << 13;
+    if (vp->display_on) status |= 1u << 10;
+    return status;
+}
+
+// 参数收齐时执行命令
+static void apply_params(st7735_vpanel_t *vp) {
+    const uint8_t *p = vp->params;
+    
+    switch (vp->cmd) {
+        case CMD_CASET:
+        case CMD_RASET: {
+            bool col = vp->cmd == CMD_CASET;
+            uint16_t start = (uint16_t)(p[0] << 8 | p[1]);
+            uint16_t end = (uint16_t)(p[2] << 8 | p[3]);
+            uint16_t limit = col ? addr_width(vp, vp->madctl) : addr_height(vp, vp->madctl);
+            if (start > end) {
+                // 起点大于终点时面板保持原窗口
+                vpanel_error(vp, "%s: start %u > end %u", col ? "CASET" : "RASET", start, end);
+                return;
+            }
+            if (end >= limit) {
+                vpanel_error(vp, "%s: %u-%u outside GRAM (%u)", col ? "CASET" : "RASET",
+                             start, end, limit);
+            }
+            if (col) {
+                vp->xs = start;
+                vp->xe = end;
+            } else {
+                vp->ys = start;
+                vp->ye = end;
+            }
+            break;
+        }
+        case CMD_MADCTL:
+            vp->madctl = p[0];
+            break;
+        case CMD_COLMOD: {
+            uint8_t ifpf = p[0] & 0x07;
+            if (ifpf != 0x03 && ifpf != 0x05 && ifpf != 0x06) {
+                vpanel_error(vp, "COLMOD: unsupported format 0x%02X", p[0]);
+                return;
+            }
+            vp->colmod = ifpf;
+            break;
+        }
+        case CMD_VSCRDEF: {
+            uint16_t tfa = (uint16_t)(p[0] << 8 | p[1]);
+            uint16_t vsa = (uint16_t)(p[2] << 8 | p[3]);
+            uint16_t bfa = (uint16_t)(p[4] << 8 | p[5]);
+            // 数据手册要求三段之和正好等于显存行数
+            if (tfa + vsa + bfa != vp->config.gram_height) {
+                vpanel_error(vp, "VSCRDEF: %u + %u + %u != %u lines", tfa, vsa, bfa,
+                             vp->config.gram_height);
+                return;
+            }
+            vp->tfa = tfa;
+            vp->vsa = vsa;
+            vp->bfa = bfa;
+            break;
+        }
+        case CMD_VSCSAD:
+            vp->ssa = (uint16_t)(p[0] << 8 | p[1]);
+            vp->scrolling = true;
+            break;
+    }
+}
+
+// 新命令到来时结束上一个命令：检查参数个数
+static void end_command(st7735_vpanel_t *vp) {
+    int expected = expected_params(vp->cmd);
+    if (vp->cmd >= 0 && expected > 0 && vp->nparams < (unsigned)expected) {
+        vpanel_error(vp, "command 0x%02X: %u of %d parameters", vp->cmd, vp->nparams, expected);
+    }
+    vp->acc_bits = 0;
+    vp->reply_bits = 0;
+}
+
+static void begin_command(st7735_vpanel_t *vp, uint8_t cmd) {
+    uint64_t now = vpanel_now(vp);
+    
+    end_command(vp);
+    vp->cur.commands++;
+    if (vp->after_reset && now - vp->reset_at < WAIT_RESET_CMD) {
+        vpanel_error(vp, "command 0x%02X %u us after reset", cmd, (unsigned)(now - vp->reset_at));
+    } else if (cmd == CMD_SLPOUT && vp->after_reset && now - vp->reset_at < WAIT_RESET_SLPOUT) {
+        vpanel_error(vp, "SLPOUT %u us after reset", (unsigned)(now - vp->reset_at));
+    } else if (cmd == CMD_SLPIN && vp->after_slpout && now - vp->slpout_at < WAIT_SLPOUT_SLPIN) {
+        vpanel_error(vp, "SLPIN %u us after SLPOUT", (unsigned)(now - vp->slpout_at));
+    }
+    if (vp->after_reset && now - vp->reset_at >= WAIT_RESET_SLPOUT) vp->after_reset = false;
+    
+    vp->cmd = cmd;
+    vp->nparams = 0;
+    
+    switch (cmd) {
+        case CMD_SWRESET:
+            reset_registers(vp);
+            vp->cmd = CMD_SWRESET;
+            vp->reset_at = now;
+            vp->after_reset = true;
+            break;
+        case CMD_RDDID:
+            vp->reply = (uint64_t)ID1 << 16 | ID2 << 8 | ID3;
+            vp->reply_bits = 25;
+            vp->reply_pos = 0;
+            vp->cur.reads++;
+            break;
+        case CMD_RDDST:
+            vp->reply = display_status(vp);
+            vp->reply_bits = 33;
+            vp->reply_pos = 0;
+            vp->cur.reads++;
+            break;
+        case CMD_SLPIN:
+            vp->sleep = true;
+            vp->after_slpout = false;
+            break;
+        case CMD_SLPOUT:
+            vp->sleep = false;
+            vp->slpout_at = now;
+            vp->after_slpout = true;
+            break;
+        case CMD_PTLON:
+            vp->partial = true;
+            vp->scrolling = false;
+            break;
+        case CMD_NORON:
+            vp->partial = false;
+            vp->scrolling = false;
+            break;
+        case CMD_INVOFF:
+            vp->inverted = false;
+            break;
+        case CMD_INVON:
+            vp->inverted = true;
+            break;
+        case CMD_DISPOFF:
+            vp->display_on = false;
+            break;
+        case CMD_DISPON:
+            vp->display_on = true;
+            break;
+        case CMD_IDMOFF:
+            vp->idle = false;
+            break;
+        case CMD_IDMON:
+            vp->idle = true;
+            break;
+        case CMD_CASET:
+            vp->cur.caset++;
+            break;
+        case CMD_RASET:
+            vp->cur.raset++;
+            break;
+        case CMD_RAMWR:
+            // 写显存从窗口左上角开始
+            vp->x = vp->xs;
+            vp->y = vp->ys;
+            vp->cur.windows++;
+            break;
+    }
+}
+
+// 写一个像素并推进地址计数器，到窗口末尾回到起点
+static void put_pixel(st7735_vpanel_t *vp, uint32_t v) {
+    unsigned col, row;
+    if (to_gram(vp, vp->madctl, vp->x, vp->y, &col, &row)) {
+        vp->gram[row * vp->config.gram_width + col] = v;
+    }
+    vp->cur.pixels++;
+    
+    if (vp->x < vp->xe) {
+        vp->x++;
+        return;
+    }
+    vp->x = vp->xs;
+    vp->y = vp->y < vp->ye ? vp->y + 1 : vp->ys;
+}
+
+// RAMWR之后的数据：按COLMOD把字节流切成像素（12位模式两个像素3字节）
+static void write_pixels(st7735_vpanel_t *vp, const uint8_t *data, size_t len) {
+    unsigned bpp = vp->colmod == 0x03 ? 12 : vp->colmod == 0x05 ? 16 : 24;
+    
+    for (size_t i = 0; i < len; i++) {
+        vp->acc = (vp->acc << 8) | data[i];
+        vp->acc_bits += 8;
+        while (vp->acc_bits >= bpp) {
+            vp->acc_bits -= bpp;
+            uint32_t px = (vp->acc >> vp->acc_bits) & ((1u << bpp) - 1);
+            uint32_t r, g, b;
+            if (bpp == 12) {
+                r = px >> 8;
+                g = (px >> 4) & 0x0F;
+                b = px & 0x0F;
+                r = r << 2 | r >> 2;
+                g = g << 2 | g >> 2;
+                b = b << 2 | b >> 2;
+            } else if (bpp == 16) {
+                r = px >> 11;
+                g = (px >> 5) & 0x3F;
+                b = px & 0x1F;
+                r = r << 1 | r >> 4;
+                b = b << 1 | b >> 4;
+            } else {
+                r = (px >> 18) & 0x3F;
+                g = (px >> 10) & 0x3F;
+                b = (px >> 2) & 0x3F;
+            }
+            put_pixel(vp, r << 12 | g << 6 | b);
+        }
+        vp->acc &= (1u << vp->acc_bits) - 1;
+    }
+}
+
+void st7735_vpanel_write(st7735_vpanel_t *vp, int dc, const uint8_t *data, size_t len) {
+    if (!vp || !data || len == 0) return;
+    
+    vp->cur.writes++;
+    if (dc != vp->last_dc) {
+        if (vp->last_dc >= 0) vp->cur.dc_switches++;
+        vp->last_dc = dc;
+    }
+    
+    if (!dc) {
+        for (size_t i = 0; i < len; i++) begin_command(vp, data[i]);
+        return;
+    }
+    
+    if (vp->cmd == CMD_RAMWR) {
+        vp->cur.pixel_bytes += len;
+        write_pixels(vp, data, len);
+        return;
+    }
+    
+    vp->cur.param_bytes += len;
+    if (vp->cmd < 0) {
+        vpanel_error(vp, "%zu data bytes without a command", len);
+        return;
+    }
+    int expected = expected_params(vp->cmd);
+    if (expected == PARAMS_ANY) return;
+    for (size_t i = 0; i < len; i++) {
+        if (vp->nparams >= (unsigned)expected) {
+            vpanel_error(vp, "command 0x%02X: too many parameters", vp->cmd);
+            return;
+        }
+        vp->params[vp->nparams++] = data[i];
+        if (vp->nparams == (unsigned)expected) apply_params(vp);
+    }
+}
+
+void st7735_vpanel_read(st7735_vpanel_t *vp, uint8_t *rx, size_t len) {
+    if (!vp || !rx) return;
+    
+    for (size_t i = 0; i < len; i++) {
+        uint8_t byte = 0;
+        for (int bit = 0; bit < 8; bit++) {
+            unsigned pos = vp->reply_pos++;
+            // 应答之外读到低电平
+            if (pos < vp->reply_bits && ((vp->reply >> (vp->reply_bits - 1 - pos)) & 1)) {
+                byte |= 0x80 >> bit;
+            }
+        }
+        rx[i] = byte;
+    }
+}
+
+void st7735_vpanel_view(const st7735_vpanel_t *vp, uint16_t x, uint16_t y,
+                        uint16_t w, uint16_t h, uint16_t *out) {
+    if (!vp || !out) return;
+    
+    for (unsigned j = 0; j < h; j++) {
+        for (unsigned i = 0; i < w; i++) {
+            unsigned col, row;
+            *out++ = to_gram(vp, vp->madctl, x + i, y + j, &col, &row) ?
+                     to_rgb565(vp->gram[row * vp->config.gram_width + col]) : 0;
+        }
+    }
+}
+
+// 扫描到显存第row行时实际显示的行：滚动区内按起始行循环
+static unsigned scroll_row(const st7735_vpanel_t *vp, unsigned row) {
+    if (!vp->scrolling || vp->vsa == 0 || row < vp->tfa || row >= vp->tfa + vp->vsa) return row;
+    int offset = (int)vp->ssa - vp->tfa;
+    int r = ((int)(row - vp->tfa) + offset) % vp->vsa;
+    if (r < 0) r += vp->vsa;
+    return vp->tfa + (unsigned)r;
+}
+
+// 玻璃上(gx, gy)处的18位颜色
+static uint32_t glass_pixel(const st7735_vpanel_t *vp, unsigned gx, unsigned gy) {
+    // 睡眠或关闭显示时画面空白
+    if (vp->sleep || !vp->display_on) return 0;
+    
+    unsigned col, row;
+    if (!to_gram(vp, vp->config.panel_madctl, gx + vp->config.col_offset,
+                 gy + vp->config.row_offset, &col, &row)) {
+        return 0;
+    }
+    uint32_t v = vp->gram[scroll_row(vp, row) * vp->config.gram_width + col];
+    
+    // 当前BGR位与面板不符时红蓝互换
+    if ((vp->madctl ^ vp->config.panel_madctl) & MADCTL_BGR) {
+        v = (v & 0x3F) << 12 | (v & 0xFC0) | v >> 12;
+    }
+    if (vp->inverted) v ^= 0x3FFFF;
+    // 空闲模式只有8色：每个通道取最高位
+    if (vp->idle) {
+        v = ((v & 0x20820) >> 5) * 0x3F;
+    }
+    return v;
+}
+
+void st7735_vpanel_snapshot(const st7735_vpanel_t *vp, uint16_t *out) {
+    if (!vp || !out) return;
+    
+    for (unsigned gy = 0; gy < vp->config.height; gy++) {
+        for (unsigned gx = 0; gx < vp->config.width; gx++) {
+            *out++ = to_rgb565(glass_pixel(vp, gx, gy));
+        }
+    }
+}
+
+int st7735_vpanel_save_ppm(const st7735_vpanel_t *vp, const char *path) {
+    if (!vp || !path) return -1;
+    
+    FILE *fp = fopen(path, "wb");
+    if (!fp) {
+        fprintf(stderr, "Error: Failed to create %s\n", path);
+        return -1;
+    }
+    fprintf(fp, "P6\n%u %u\n255\n", vp->config.width, vp->config.height);
+    for (unsigned gy = 0; gy < vp->config.height; gy++) {
+        for (unsigned gx = 0; gx < vp->config.width; gx++) {
+            uint32_t v = glass_pixel(vp, gx, gy);
+            uint8_t rgb[3];
+            for (int k = 0; k < 3; k++) {
+                uint8_t c = (v >> (12 - 6 * k)) & 0x3F;
+                rgb[k] = (uint8_t)(c << 2 | c >> 4);
+            }
+            fwrite(rgb, 1, sizeof(rgb), fp);
+        }
+    }
+    if (fclose(fp) != 0) {
+        fprintf(stderr, "Error: Failed to write %s\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+void st7735_vpanel_size(const st7735_vpanel_t *vp, uint16_t *width, uint16_t *height) {
+    if (!vp) return;
+    if (width) *width = vp->config.width;
+    if (height) *height = vp->config.height;
+}
+
+// 计数逐项相加或取最大值（结构体全部是uint64_t）
+#define COUNT_FIELDS (sizeof(st7735_vpanel_counts_t) / sizeof(uint64_t))
+
+static void counts_add(st7735_vpanel_counts_t *dst, const st7735_vpanel_counts_t *src) {
+    uint64_t *d = (uint64_t *)dst;
+    const uint64_t *s = (const uint64_t *)src;
+    for (size_t i = 0; i < COUNT_FIELDS; i++) d[i] += s[i];
+}
+
+static void counts_max(st7735_vpanel_counts_t *dst, const st7735_vpanel_counts_t *src) {
+    uint64_t *d = (uint64_t *)dst;
+    const uint64_t *s = (const uint64_t *)src;
+    for (size_t i = 0; i < COUNT_FIELDS; i++) {
+        if (s[i] > d[i]) d[i] = s[i];
+    }
+}
+
+void st7735_vpanel_frame(st7735_vpanel_t *vp) {
+    if (!vp) return;
+    
+    vp->stats.frames++;
+    counts_add(&vp->stats.total, &vp->cur);
+    counts_max(&vp->stats.max, &vp->cur);
+    vp->stats.last = vp->cur;
+    memset(&vp->cur, 0, sizeof(vp->cur));
+}
+
+void st7735_vpanel_get_stats(const st7735_vpanel_t *vp, st7735_vpanel_stats_t *stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    if (!vp) return;
+    
+    // 总数包括还没有结束的一帧
+    *stats = vp->stats;
+    counts_add(&stats->total, &vp->cur);
+}
+
+void st7735_vpanel_reset_stats(st7735_vpanel_t *vp) {
+    if (!vp) return;
+    memset(&vp->stats, 0, sizeof(vp->stats));
+    memset(&vp->cur, 0, sizeof(vp->cur));
+    vp->error[0] = '\0';
+}
+
+const char *st7735_vpanel_last_error(const st7735_vpanel_t *vp) {
+    return vp ? vp->error : "";
+}
+
+double st7735_vpanel_bus_ns(const st7735_vpanel_counts_t *counts, double spi_hz) {
+    if (!counts || spi_hz <= 0) return 0;
+    uint64_t bytes = counts->commands + counts->param_bytes + counts->pixel_bytes;
+    return bytes * 8.0 * 1e9 / spi_hz;
+}
+
+static void print_counts(const char *label, const st7735_vpanel_counts_t *c, double div, FILE *fp) {
+    fprintf(fp, "  %-8s %8.1f cmds %8.1f windows %9.1f px %10.1f bytes (%.1f cmd+param) "
+            "%7.1f DC switches, %.3f ms @16MHz\n",
+            label, c->commands / div, c->windows / div, c->pixels / div,
+            (c->commands + c->param_bytes + c->pixel_bytes) / div,
+            (c->commands + c->param_bytes) / div, c->dc_switches / div,
+            st7735_vpanel_bus_ns(c, 16e6) / 1e6 / div);
+}
+
+void st7735_print_vpanel_stats(const st7735_vpanel_stats_t *stats, FILE *fp) {
+    if (!stats) return;
+    if (!fp) fp = stdout;
+    
+    fprintf(fp, "Virtual panel: %llu frames, %llu errors, %llu writes\n",
+            (unsigned long long)stats->frames, (unsigned long long)stats->total.errors,
+            (unsigned long long)stats->total.writes);
+    if (stats->frames == 0) return;
+    print_counts("last", &stats->last, 1, fp);
+    print_counts("average", &stats->total, (double)stats->frames, fp);
+    print_counts("max", &stats->max, 1, fp);
+}
@@ -0,0 +1,87 @@
+#ifndef ST7735_VPANEL_H
+#define ST7735_VPANEL_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// 虚拟面板：在主机上解释驱动发出的DC + 字节流，模拟ST7735的命令解码、地址计数器和显存，
+// 不需要硬件即可检查画面和统计线上流量。只依赖C库，st7735_driver（经st7735_mock.h的
+// st7735_vpanel_transport）和bcm2835版ST7735驱动（ST7735_SetTransport）都可以接入。
+//
+// 支持的命令：SWRESET SLPIN/SLPOUT PTLON/NORON INVOFF/INVON DISPOFF/DISPON IDMOFF/IDMON
+//   CASET RASET RAMWR MADCTL COLMOD(12/16/18位) VSCRDEF VSCSAD，读RDDID/RDDST；
+//   其余命令（帧率、电源、伽马等）只计数，参数被忽略。
+// 显存按18位保存，上电时填充伪随机内容，驱动漏画的区域在快照中一目了然
+
+#define ST7735_VPANEL_MAX_W     132     // 显存最大尺寸（GM=11）
+#define ST7735_VPANEL_MAX_H     162
+
+typedef struct {
+    uint16_t gram_width;        // 显存尺寸，0为128x160
+    uint16_t gram_height;
+    uint16_t width;             // 玻璃可见区域，0为整个显存
+    uint16_t height;
+    uint16_t col_offset;        // 可见区域在panel_madctl地址空间中的偏移
+    uint16_t row_offset;
+    uint8_t panel_madctl;       // 在这个MADCTL下写入的画面在玻璃上是正的（含BGR位）
+} st7735_vpanel_config_t;
+
+// 线上流量和命令计数；按st7735_vpanel_frame()划分帧
+typedef struct {
+    uint64_t writes;            // write调用次数（DC相同的一段字节）
+    uint64_t commands;          // 命令字节数
+    uint64_t param_bytes;       // 非RAMWR命令的参数字节数
+    uint64_t pixel_bytes;       // RAMWR之后的像素字节数
+    uint64_t pixels;            // 写入显存的像素数
+    uint64_t windows;           // RAMWR次数（每次对应一个窗口）
+    uint64_t caset;
+    uint64_t raset;
+    uint64_t dc_switches;
+    uint64_t reads;             // 读命令次数
+    uint64_t errors;            // 协议错误（参数个数不对、窗口越界、复位后等待不够等）
+} st7735_vpanel_counts_t;
+
+typedef struct {
+    uint64_t frames;
+    st7735_vpanel_counts_t total;
+    st7735_vpanel_counts_t last;    // 最近一帧
+    st7735_vpanel_counts_t max;     // 单帧最大值（逐项）
+} st7735_vpanel_stats_t;
+
+typedef struct st7735_vpanel st7735_vpanel_t;
+
+// config为NULL时使用默认值（128x160，无偏移，panel_madctl为MX|MY|BGR）
+st7735_vpanel_t *st7735_vpanel_create(const st7735_vpanel_config_t *config);
+void st7735_vpanel_destroy(st7735_vpanel_t *vp);
+// 硬件复位（RST引脚）：寄存器恢复默认值，显存内容保留
+void st7735_vpanel_reset(st7735_vpanel_t *vp);
+
+// 发送一段字节：dc为0时每个字节是一个命令，为1时是参数或像素
+void st7735_vpanel_write(st7735_vpanel_t *vp, int dc, const uint8_t *data, size_t len);
+// 读命令（RDDID/RDDST）之后的读周期：按位输出应答，包括开头的dummy位
+void st7735_vpanel_read(st7735_vpanel_t *vp, uint8_t *rx, size_t len);
+// 驱动的等待：不睡眠，只推进虚拟时钟。时序检查（SWRESET后5ms内发命令、
+// 120ms内SLPOUT，SLPOUT后120ms内SLPIN）按单调时钟加上这里跳过的时间判断
+void st7735_vpanel_delay(st7735_vpanel_t *vp, unsigned ms);
+
+// 按当前MADCTL的地址空间读出窗口，转换为主机字节序RGB565（与驱动的framebuffer对应）
+void st7735_vpanel_view(const st7735_vpanel_t *vp, uint16_t x, uint16_t y,
+                        uint16_t w, uint16_t h, uint16_t *out);
+// 玻璃上看到的画面：可见区域按panel_madctl摆正，计入滚动、反色、空闲模式和显示关闭
+void st7735_vpanel_snapshot(const st7735_vpanel_t *vp, uint16_t *out);
+int st7735_vpanel_save_ppm(const st7735_vpanel_t *vp, const char *path);
+void st7735_vpanel_size(const st7735_vpanel_t *vp, uint16_t *width, uint16_t *height);
+
+// 结束一帧：把本帧计数计入统计并清零
+void st7735_vpanel_frame(st7735_vpanel_t *vp);
+void st7735_vpanel_get_stats(const st7735_vpanel_t *vp, st7735_vpanel_stats_t *stats);
+void st7735_vpanel_reset_stats(st7735_vpanel_t *vp);
+// 最近一次协议错误的描述，没有时为空串
+const char *st7735_vpanel_last_error(const st7735_vpanel_t *vp);
+// 按给定SPI时钟估算这些字节的发送时间（不含传输之间的间隙）
+double st7735_vpanel_bus_ns(const st7735_vpanel_counts_t *counts, double spi_hz);
+void st7735_print_vpanel_stats(const st7735_vpanel_stats_t *stats, FILE *fp);
+
+#endif // ST7735_VPANEL_H